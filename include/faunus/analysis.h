@@ -13,6 +13,10 @@
 #include <Eigen/Core>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 
 namespace Faunus
@@ -46,7 +50,9 @@ namespace Faunus
 	 *
 	 * The `sample()` wrapper function takes care of timing the analysis
 	 * as well as sample the number of sample points at a given interval
-	 * specified with the JSON keyword `nstep`.
+	 * specified with the JSON keyword `nstep`. For analyses run by
+	 * `AnalysisPipeline`, the time from snapshot to sampling is
+	 * reported as queue latency.
 	 *
 	 * @todo Make `_sample()` pure virtual
 	 */
@@ -58,6 +64,7 @@ namespace Faunus
 		virtual void _test( UnitTest & );
 
 		int stepcnt;          //!< counter between sampling points
+		Average<double> latency; //!< time from snapshot to sampling (ms)
 
 	    protected:
 		TimeRelativeOfTotal <std::chrono::microseconds> timer;
@@ -74,6 +81,8 @@ namespace Faunus
 		string info();       //!< Print info and results
 		void test( UnitTest & );//!< Perform unit test
 		void sample();       //!< Sample event.
+		bool due();          //!< Count step; true if sampling is due
+		void sample( std::chrono::steady_clock::time_point ); //!< Sample due event queued at given time
 		Tmjson json();       //!< Get info and results as json object
 	};
 
@@ -90,6 +99,11 @@ namespace Faunus
 	 * and the excess pressure scalar is the trace of @f$\mathcal{P}@f$.
 	 * The trivial kinetic contribution is currently not included.
 	 *
+	 * Pair forces and virials are taken from `Energy::Energybase::f_g2g()` and
+	 * `f_g_internal()` so that, for `Energy::Nonbonded`, the distance is evaluated
+	 * once per pair, pairs beyond `cutoff_cell` are skipped via the cell list as
+	 * for the energy, and group pairs are summed in parallel (`Energy::GroupPairSum`).
+	 *
 	 * Upon construction the JSON entry is searched
 	 * for the following keywords:
 	 *
@@ -115,6 +129,7 @@ namespace Faunus
 	    private:
 		Tspace *spc;
 		Energy::Energybase <Tspace> *pot;
+		Energy::GroupPairSum pairSum; // parallel sum over group pairs
 		int dim;             // dimensions (default: 3)
 
 		typedef Eigen::Matrix3d Ttensor;
@@ -158,37 +173,6 @@ namespace Faunus
 		    test("virial_pressure_mM", (Texcess / cnt).trace() / 1.0_mM, 0.2);
 		}
 
-		template<class Tpvec, class Tgeo, class Tpot>
-		    Ttensor g_internal( const Tpvec &p, Tgeo &geo, Tpot &pot, Group &g )
-		    {
-			Ttensor t;
-			t.setZero();
-			for ( auto i = g.front(); i < g.back(); i++ )
-			    for ( auto j = i + 1; j <= g.back(); j++ )
-			    {
-				auto rij = geo.vdist(p[i], p[j]);
-				auto fij = pot.f_p2p(p[i], p[j]);
-				t += rij * fij.transpose();
-			    }
-			return t;
-		    }
-
-		template<class Tpvec, class Tgeo, class Tpot>
-		    Ttensor g2g( const Tpvec &p, Tgeo &geo, Tpot &pot, Group &g1, Group &g2 )
-		    {
-			assert(&g1 != &g2);
-			Ttensor t;
-			t.setZero();
-			for ( auto i : g1 )
-			    for ( auto j : g2 )
-			    {
-				auto rij = geo.vdist(p[i], p[j]);
-				auto fij = pot.f_p2p(p[i], p[j]);
-				t += rij * fij.transpose();
-			    }
-			return t;
-		    }
-
 		inline void _sample() override
 		{
 		    Ttensor t;
@@ -206,15 +190,14 @@ namespace Faunus
 				N = N - g->size() + 1;
 				continue;
 			    }
-			t += g_internal(spc->p, spc->geo, *pot, *g);
+			t += pot->f_g_internal(spc->p, *g).virial;
 		    }
 
 		    // loop group-to-group
-		    auto beg = spc->groupList().begin();
-		    auto end = spc->groupList().end();
-		    for ( auto gi = beg; gi != end; ++gi )
-			for ( auto gj = gi; ++gj != end; )
-			    t += g2g(spc->p, spc->geo, *pot, *(*gi), *(*gj));
+		    auto &g = spc->groupList();
+		    pot->prepare(spc->p);
+		    t += pairSum.reduce(g, [&]( int i, int j ) {
+			    return pot->f_g2g(spc->p, *g[j], *g[i]); }, Energy::PairForceSum(), pot->threadSafe()).virial;
 
 		    // add to grand avarage
 		    Texcess += t / (dim * V);
@@ -742,6 +725,58 @@ namespace Faunus
 
 	};
 
+	/**
+	 * @brief Batched, multithreaded evaluation of ghost insertions
+	 *
+	 * Ghosts for a whole batch are first generated by `generate` on the
+	 * calling thread and then evaluated by `evaluate` against the same,
+	 * frozen configuration using OpenMP threads. Generation is cheap compared
+	 * to evaluation and, being serial, draws the same random numbers for any
+	 * number of threads. Set `serialEvaluate` if `evaluate` writes to shared
+	 * data, e.g. for energy terms that are not `Energybase::threadSafe()`.
+	 * Finally, `accumulate` is called for each ghost in the order of generation
+	 * so that results are independent of the number of threads. The first
+	 * ghost of each batch is evaluated before the parallel region so that
+	 * lazily built data such as cell lists or packed particle vectors are
+	 * up-to-date when threads start reading them.
+	 *
+	 * @tparam Tghost Ghost to insert, i.e. a particle or a particle vector
+	 * @tparam Tresult Result of a single insertion, typically an energy
+	 */
+	template<class Tghost, class Tresult=double>
+	    class GhostInserter
+	{
+	    private:
+		vector<Tghost> ghost;
+		vector<Tresult> result;
+	    public:
+		int batch;           //!< Maximum number of ghosts per batch
+		bool serialEvaluate; //!< Evaluate ghosts on the master thread only
+
+		GhostInserter( int batch = 1000 ) : batch(std::max(1, batch)), serialEvaluate(false) {}
+
+		/** @brief Generate, evaluate and accumulate `n` ghosts */
+		template<class Tgenerate, class Tevaluate, class Taccumulate>
+		    void operator()( int n, Tgenerate generate, Tevaluate evaluate, Taccumulate accumulate )
+		    {
+			while ( n > 0 )
+			{
+			    int m = std::min(n, batch);
+			    ghost.resize(m);
+			    result.resize(m);
+			    for ( int i = 0; i < m; i++ )
+				generate(ghost[i]);
+			    evaluate(ghost[0], result[0]);
+#pragma omp parallel for schedule (dynamic) if (!serialEvaluate)
+			    for ( int i = 1; i < m; i++ )
+				evaluate(ghost[i], result[i]);
+			    for ( int i = 0; i < m; i++ )
+				accumulate(ghost[i], result[i]);
+			    n -= m;
+			}
+		    }
+	};
+
 	/**
 	 * @brief Widom method for excess chemical potentials
 	 *
@@ -755,6 +790,7 @@ namespace Faunus
 	 *  `ninsert`  | Number of insertions per sampling event (int)
 	 *  `nstep`    | Sample every n'th step (int)
 	 *  `particles`| Atom names to simultaneously insert (array)
+	 *  `batch`    | Insertions evaluated in parallel, see `GhostInserter` (int, default: 1000)
 	 */
 	template<class Tspace>
 	    class Widom : public AnalysisBase
@@ -767,6 +803,7 @@ namespace Faunus
 
 		Average<double> expsum; //!< Average of the excess chemical potential
 		int ghostin;            //!< Number of insertions per sample event
+		GhostInserter<std::vector<Tparticle>> inserter;
 
 		string _info() override
 		{
@@ -804,20 +841,25 @@ namespace Faunus
 
 		void _sample() override
 		{
-		    int n = g.size(), cnt=ghostin;
-		    if ( n > 0 )
-			while ( cnt-- > 0 )
-			{
-			    double du = 0;
-			    for ( auto &i : g )
-				spc.geo.randompos(i);     // random ghost positions
-			    for ( auto &i : g )
-				du += pot.all2p(spc.p, i);  // energy with all particles in space
-			    for ( int i = 0; i < n - 1; i++ )
-				for ( int j = i + 1; j < n; j++ )
-				    du += pot.p2p(g[i], g[j]);// energy between ghost particles
-			    expsum += exp(-du);
-			}
+		    int n = g.size();
+		    if ( n == 0 )
+			return;
+		    auto generate = [&]( std::vector<Tparticle> &v ) {
+			v = g;
+			for ( auto &i : v )
+			    spc.geo.randompos(i);       // random ghost positions
+		    };
+		    auto evaluate = [&]( const std::vector<Tparticle> &v, double &du ) {
+			du = 0;
+			for ( auto &i : v )
+			    du += pot.all2p(spc.p, i);  // energy with all particles in space
+			for ( int i = 0; i < n - 1; i++ )
+			    for ( int j = i + 1; j < n; j++ )
+				du += pot.p2p(v[i], v[j]); // energy between ghost particles
+		    };
+		    inserter.serialEvaluate = !pot.threadSafe();
+		    inserter(ghostin, generate, evaluate,
+			    [&]( const std::vector<Tparticle> &, double du ) { expsum += exp(-du); });
 		}
 
 	    protected:
@@ -829,6 +871,7 @@ namespace Faunus
 		cite = "doi:10/dkv4s6";
 
 		ghostin = j.value("ninsert", 10);
+		inserter.batch = std::max(1, j.value("batch", 1000));
 
 		if (j.count("particles")>0)
 		    if (j["particles"].is_array()) {
@@ -889,6 +932,7 @@ namespace Faunus
 	 *  `lB`       | Bjerrum length (angstrom)
 	 *  `ninsert`  | Number of intertions per sampling event
 	 *  `nstep`    | Sample every n'th step
+	 *  `batch`    | Insertions evaluated in parallel, see `GhostInserter` (default: 1000)
 	 *
 	 * @warning Works only for the primitive model
 	 * @note This is a conversion of the Widom routine found in the `bulk.f`
@@ -1018,66 +1062,73 @@ namespace Faunus
 		}
 
 
+		/** @brief Outcome of a single ghost insertion */
+		struct Insertion
+		{
+		    vector<char> rej; //!< hard sphere overlap for each test particle
+		    double u, cu;     //!< electric potential and sum of inverse distances
+		};
+
+		GhostInserter<Tparticle, Insertion> inserter;
+
 		void _sample() override
 		{
 		    auto &geo = spc.geo;
 		    auto &p = spc.p;
-		    if ( !g.empty())
-			if ( !p.empty())
+		    if ( g.empty() || p.empty())
+			return;
+
+		    auto evaluate = [&]( const Tparticle &a, Insertion &r ) {
+			Tparticle ghost = a;
+			int goverlap = 0;
+			r.rej.resize(g.size());
+			for ( size_t k = 0; k < g.size(); k++ )
+			{
+			    ghost.radius = g[k].radius;
+			    size_t j = 0;
+			    while ( j < p.size() && !overlap(ghost, p[j], geo))
+				j++;
+			    r.rej[k] = (j != p.size());
+			    goverlap += r.rej[k];
+			}
+			r.u = r.cu = 0;
+			if ( goverlap != (int) g.size())
 			{
-			    Tparticle ghost;
-			    double u, cu;
-			    for ( int i = 0; i < ghostin; i++ )
+			    for ( auto &i : p )      //elelectric potential (Coulomb only!)
 			    {
-				geo.randompos(ghost);
-				int goverlap = 0;
-				for ( size_t k = 0; k < g.size(); k++ )
-				{
-				    ghost.radius = g[k].radius;
-				    irej[k] = 0;
-				    int j = 0;
-				    while ( !overlap(ghost, p[j], geo) && j < (int) p.size())
-					j++;
-				    if ( j != (int) p.size())
-				    {
-					ihc[k]++;
-					irej[k] = 1;
-					goverlap++;
-				    }
-				}
+				double invdi = 1 / geo.dist(ghost, i);
+				r.cu += invdi;
+				r.u += invdi * i.charge;
+			    }
+			    r.cu = r.cu * lB;
+			    r.u = r.u * lB;
+			}
+		    };
 
-				if ( goverlap != (int) g.size())
+		    auto accumulate = [&]( const Tparticle &, const Insertion &r ) {
+			double ew, ewla, ewd;
+			for ( size_t k = 0; k < g.size(); k++ )
+			{
+			    irej[k] = r.rej[k];
+			    if ( irej[k] == 1 )
+				ihc[k]++;
+			    else
+			    {
+				expuw[k] += exp(-r.u * g[k].charge);
+				for ( int cint = 0; cint < 11; cint++ )
 				{
-				    cu = 0;
-				    u = 0;  //elelectric potential (Coulomb only!)
-				    for ( auto &i : p )
-				    {
-					double invdi = 1 / geo.dist(ghost, i);
-					cu += invdi;
-					u += invdi * i.charge;
-				    }
-				    cu = cu * lB;
-				    u = u * lB;
-				    double ew, ewla, ewd;
-				    for ( size_t k = 0; k < g.size(); k++ )
-				    {
-					if ( irej[k] == 0 )
-					{
-					    expuw[k] += exp(-u * g[k].charge);
-					    for ( int cint = 0; cint < 11; cint++ )
-					    {
-						ew = g[k].charge *
-						    (u - double(cint) * 0.1 * g[k].charge * cu / double(p.size()));
-						ewla = ew * double(cint) * 0.1;
-						ewd = exp(-ewla);
-						ewden[k][cint] += ewd;
-						ewnom[k][cint] += ew * ewd;
-					    }
-					}
-				    }
+				    ew = g[k].charge *
+					(r.u - double(cint) * 0.1 * g[k].charge * r.cu / double(p.size()));
+				    ewla = ew * double(cint) * 0.1;
+				    ewd = exp(-ewla);
+				    ewden[k][cint] += ewd;
+				    ewnom[k][cint] += ew * ewd;
 				}
 			    }
 			}
+		    };
+
+		    inserter(ghostin, [&]( Tparticle &a ) { geo.randompos(a); }, evaluate, accumulate);
 		}
 
 	    public:
@@ -1086,6 +1137,7 @@ namespace Faunus
 	    {
 		lB = j.value("lB", 7.0);
 		ghostin = j.value("ninsert", 10);
+		inserter.batch = std::max(1, j.value("batch", 1000));
 		name = "Single particle Widom insertion w. charge scaling";
 		cite = "doi:10/ft9bv9 + doi:10/dkv4s6";
 
@@ -1485,6 +1537,20 @@ namespace Faunus
 		    }
 	    };
 
+	/**
+	 * @brief Density of an atom type along the axis of a cylinder
+	 *
+	 * Keyword    | Description
+	 * :--------- | :-------------------------------------------
+	 * `atomtype` | Atom type to sample
+	 * `zmin`     | Lower end of sampled interval (angstrom)
+	 * `zmax`     | Upper end of sampled interval (angstrom)
+	 * `dz`       | Width of slices (angstrom)
+	 *
+	 * Densities are stored in a `FlatTable2D` with a resolution of 0.2 angstrom
+	 * that is allocated from `zmin` to `zmax` on construction, which throws if
+	 * the interval exceeds `FlatTable2D::maxbins` bins.
+	 */
 	template<typename Tspace>
 	    class CylindricalDensity : public AnalysisBase
 	{
@@ -1493,7 +1559,7 @@ namespace Faunus
 		int id;
 		double zmin, zmax, dz, area;
 		Tspace *spc;
-		Table2D<double, Average<double> > data;
+		FlatTable2D<double, Average<double> > data;
 
 		inline string _info() override
 		{
@@ -1526,6 +1592,7 @@ namespace Faunus
 		zmin = j.at("zmin");
 		zmax = j.at("zmax");
 		dz = j.at("dz");
+		data.setRange(zmin, zmax);
 
 		string atomtype = j.at("atomtype");
 		cout << "atomtype = " << atomtype << endl;
@@ -1644,7 +1711,10 @@ namespace Faunus
 	 * calculating all group-to-group interactions (`Energy::g2g`)
 	 * and, for atomic groups, the internal energy
 	 * (`Energy::g_internal`). For using the full Hamiltonian,
-	 * use the keyword `fullenergy` as shown below.
+	 * use the keyword `fullenergy` as shown below. Group pairs are
+	 * summed in parallel and for atomic groups with homogeneous pair
+	 * potentials the energy change is obtained directly from the
+	 * untouched configuration, see `Energy::Energybase::scaledPairChange()`.
 	 *
 	 * JSON input:
 	 *
@@ -1672,6 +1742,7 @@ namespace Faunus
 		    double dV;
 		    bool fullenergy;
 		    Average<double> duexp; // < exp(-du/kT) >
+		    Energy::GroupPairSum pairSum;
 
 		    void scale( double Vold, double Vnew )
 		    {
@@ -1693,13 +1764,26 @@ namespace Faunus
 			    return Energy::systemEnergy(*spc, *pot, p);
 
 			double u = 0;
-			for ( auto g : spc->groupList())
-			    if ( g->isAtomic())
-				u += pot->g_internal(p, *g);
-			for ( size_t i = 0; i < spc->groupList().size() - 1; i++ )
-			    for ( size_t j = i + 1; j < spc->groupList().size(); j++ )
-				u += pot->g2g(p, *spc->groupList().at(i), *spc->groupList().at(j));
-			return u;
+			auto &g = spc->groupList();
+			pot->prepare(p);
+			for ( auto gi : g )
+			    if ( gi->isAtomic())
+				u += pot->g_internal(p, *gi);
+			return u + pairSum(g, [&]( int i, int j ) { return pot->g2g(p, *g[j], *g[i]); }, pot->threadSafe());
+		    }
+
+		    /** @brief Energy change from summed pair terms, or NaN if unavailable */
+		    double scaledChange( double Vold, double Vnew )
+		    {
+			double s = std::numeric_limits<double>::quiet_NaN();
+			if ( !fullenergy )
+			{
+			    s = Geometry::isotropicScaling(spc->geo, dir, cbrt(Vnew / Vold), sqrt(Vnew / Vold));
+			    for ( auto g : spc->groupList())
+				if ( !g->isAtomic())
+				    s = std::numeric_limits<double>::quiet_NaN();
+			}
+			return std::isnan(s) ? s : pot->scaledPairChange(s);
 		    }
 
 		    void _sample() override
@@ -1707,6 +1791,13 @@ namespace Faunus
 			double Vold = spc->geo.getVolume();
 			double Vnew = Vold + dV;
 
+			double du = scaledChange(Vold, Vnew);
+			if ( !std::isnan(du))
+			{
+			    duexp += exp(du);
+			    return;
+			}
+
 			double uold = energy(spc->p);
 			scale(Vold, Vnew);
 			double unew = energy(spc->trial);
@@ -1775,14 +1866,17 @@ namespace Faunus
 	 * `molecule`    | Name of molecule to insert
 	 * `ninsert`     | Number of insertions per sample event
 	 * `absz`        | Apply `std::fabs` on all z-coordinates of inserted molecule (default: `false`)
+	 * `batch`       | Insertions evaluated in parallel, see `GhostInserter` (default: 1000)
 	 */
 	template<typename Tspace>
 	    class WidomMolecule : public AnalysisBase
 	{
 	    private:
 		typedef Energy::Energybase <Tspace> Tenergy;
+		typedef typename Tspace::ParticleVector Tpvec;
 		Tspace *spc;
 		Energy::Energybase <Tspace> *pot;
+		GhostInserter<Tpvec> inserter;
 		int ninsert;
 		string molecule;
 		Point dir;
@@ -1800,20 +1894,25 @@ namespace Faunus
 		    rho += spc->numMolecules(molid) / spc->geo.getVolume();
 		    rins.dir = dir;
 		    rins.checkOverlap = false;
-		    for ( int i = 0; i < ninsert; ++i )
-		    {
-			auto pin = rins(spc->geo, spc->p, spc->molecule[molid]); // ('spc->molecule' is a vector of molecules
+
+		    auto generate = [&]( Tpvec &pin ) {
+			pin = rins(spc->geo, spc->p, spc->molecule[molid]); // ('spc->molecule' is a vector of molecules
 			assert( !pin.empty() );
 
 			if (absolute_z)
 			    for (auto &p : pin)
 				p.z() = std::fabs(p.z());
+		    };
 
-			double u = pot->v2v(pin, spc->p); // energy between "ghost molecule" and system in kT
+		    auto evaluate = [&]( const Tpvec &pin, double &u ) {
+			u = pot->v2v(pin, spc->p); // energy between "ghost molecule" and system in kT
 			Group g = Group(0, pin.size()-1 );
 			u += pot->g_external(pin, g);
-			expu += exp(-u); // widom average
-		    }
+		    };
+
+		    inserter.serialEvaluate = !pot->threadSafe();
+		    inserter(ninsert, generate, evaluate,
+			    [&]( const Tpvec &, double u ) { expu += exp(-u); }); // widom average
 		}
 
 		inline string _info() override
@@ -1864,6 +1963,7 @@ namespace Faunus
 	    {
 		name = "Widom Molecule";
 		ninsert = j.at("ninsert");
+		inserter.batch = std::max(1, j.value("batch", 1000));
 		dir << j.value("dir", vector<double>({1,1,1}) );
 		molecule = j.at("molecule");
 		absolute_z = j.value("absz", false);
@@ -1925,20 +2025,14 @@ namespace Faunus
 		    // force all others, k <-> g1 and g2
 		    for (int k=0; k!=(int)g.size(); k++)
 			if (k!=g1)
-			    if (k!=g2)
-				for (auto i : *g[k]) {
-				    for (auto j : *g[g1])
-					f1 += pot.f_p2p( p[i], p[j] );
-				    for (auto j : *g[g2])
-					f2 += pot.f_p2p( p[i], p[j] );
-				}
+			    if (k!=g2) {
+				f1 += pot.f_g2g( p, *g[k], *g[g1] ).f;
+				f2 += pot.f_g2g( p, *g[k], *g[g2] ).f;
+			    }
 		    // force g1<->g2
-		    for (auto i : *g[g2])
-			for (auto j : *g[g1]) {
-			    Point f = pot.f_p2p( p[i], p[j] );
-			    f1 += f;
-			    f2 -= f;
-			}
+		    Point f = pot.f_g2g( p, *g[g2], *g[g1] ).f;
+		    f1 += f;
+		    f2 -= f;
 
 		    // COM-COM unit vector and mean force
 		    Point r = spc.geo.vdist( g[g1]->cm, g[g2]->cm );
@@ -2065,25 +2159,262 @@ namespace Faunus
 		struct data {
 		    int dim;
 		    double dr;
-		    Table2D<double,double> hist;
-		    Table2D<double,Average<double>> hist2;
-		    Table2D<double,double> hist3;
+		    FlatTable2D<double,double> hist;
+		    FlatTable2D<double,Average<double>> hist2;
+		    FlatTable2D<double,double> hist3;
 		    string name1, name2, file, file2;
 		    double Rhypersphere; // Radius of 2D hypersphere
+		    double rmax;         // pairs further apart are ignored by `PairSweep`; only for `AtomRDF` (default: infinity)
+		    double npairs;       // sampled pairs incl. those beyond `rmax`; normalizes if `rmax` is finite
 		};
 		std::vector<data> datavec;        // vector of data sets
 		Average<double> V;                // average volume (angstrom^3)
 		virtual void normalize(data &);
+		void _sample() override;          // calls `update()` for each data set
+		void checkRange(double);          // throws if distances up to `rmax` need too many bins
 	    private:
 		virtual void update(data &d)=0;   // called on each defined data set
-		void _sample() override;
 		Tmjson _json() override;
 
 	    public:
-		PairFunctionBase(Tmjson, string);
+		PairFunctionBase(Tmjson, string, bool=false); // last argument: accept `rmax`
 		virtual ~PairFunctionBase();
 	};
 
+	/**
+	 * @brief Histograms of several atom pair functions from a single sweep over pairs
+	 *
+	 * Each channel, added with `add()`, samples pairs of two atom types
+	 * (-1 for any type) closer than `rmax` into a histogram with bins
+	 * centred at multiples of `dr`, as `Table2D`, optionally weighted by a
+	 * function of the two particles. Instead of the distance, pairs may
+	 * be binned by another function of the two particles, e.g. the angle
+	 * between their dipoles. `sweep()` visits each pair of particles
+	 * of registered types once and evaluates the distance once for all
+	 * channels. All of `Space::p` is scanned, including particles outside
+	 * groups, and if all channels have a finite `rmax` and the geometry
+	 * is cuboidal, a `Geometry::CellList` skips distant pairs.
+	 *
+	 * Rows of pairs are split into a fixed number of interleaved blocks
+	 * that are processed in parallel, each with private histograms
+	 * that are merged in block order, so that results do not
+	 * depend on the number of threads.
+	 */
+	template<class Tspace>
+	    class PairSweep
+	    {
+		public:
+		    typedef typename Tspace::ParticleType Tparticle;
+		    typedef std::function<double( const Tparticle &, const Tparticle & )> Tweight;
+
+		private:
+		    struct Channel
+		    {
+			int id1, id2;
+			double dr, rmax;
+			Tweight weight;     // empty = 1
+			Tweight coordinate; // empty = distance
+			int kmin;           // bin index of first bin
+		    };
+
+		    struct Bins
+		    {
+			vector<double> sum, sqsum;
+			vector<unsigned long> cnt;
+
+			void clear()
+			{
+			    std::fill(sum.begin(), sum.end(), 0);
+			    std::fill(sqsum.begin(), sqsum.end(), 0);
+			    std::fill(cnt.begin(), cnt.end(), 0);
+			}
+		    };
+
+		    vector<Channel> channels;
+		    vector<vector<int>> table;       // channels of each pair of atom types
+		    vector<char> used;               // atom type is sampled by any channel
+		    int ntypes;
+		    vector<int> index, type;         // sampled particles (ascending) and their atom types
+		    vector<Point> pos;               // ...and positions
+		    Geometry::CellList<typename Tspace::GeometryType> cells;
+		    vector<vector<Bins>> blocks;     // histograms of each block and channel
+		    vector<Bins> result;             // merged histograms of each channel
+		    vector<double> npairs;           // number of pairs of each channel, regardless of distance
+
+		    /** @brief Bin index of `x`, rounded as the keys of `Table2D` */
+		    static int bin( double x, double dr ) { return (x >= 0) ? int(x / dr + 0.5) : int(x / dr - 0.5); }
+
+		    static bool match( const Channel &c, int t1, int t2 )
+		    {
+			return (c.id1 < 0 || c.id1 == t1) && (c.id2 < 0 || c.id2 == t2);
+		    }
+
+		    void setup()
+		    {
+			ntypes = atom.size();
+			table.assign(ntypes * ntypes, vector<int>());
+			used.assign(ntypes, 0);
+			for ( int t1 = 0; t1 < ntypes; t1++ )
+			    for ( int t2 = 0; t2 < ntypes; t2++ )
+				for ( size_t k = 0; k < channels.size(); k++ )
+				    if ( match(channels[k], t1, t2) || match(channels[k], t2, t1))
+				    {
+					table[t1 * ntypes + t2].push_back(k);
+					used[t1] = used[t2] = 1;
+				    }
+		    }
+
+		    void pair( vector<Bins> &h, const Tspace &spc, int a, int b ) const
+		    {
+			auto &ch = table[type[a] * ntypes + type[b]];
+			if ( ch.empty())
+			    return;
+			auto &pa = spc.p[index[a]];
+			auto &pb = spc.p[index[b]];
+			double r = spc.geo.dist(pa, pb);
+			for ( auto k : ch )
+			{
+			    auto &c = channels[k];
+			    if ( r < c.rmax )
+			    {
+				int i = (c.coordinate ? bin(c.coordinate(pa, pb), c.dr) : bin(r, c.dr)) - c.kmin;
+				if ( i < 0 )
+				    continue;
+				auto &bins = h[k];
+				if ( size_t(i) >= bins.cnt.size())
+				{
+				    bins.cnt.resize(i + 1, 0);
+				    bins.sum.resize(i + 1, 0);
+				    bins.sqsum.resize(i + 1, 0);
+				}
+				double w = c.weight ? c.weight(pa, pb) : 1;
+				bins.cnt[i]++;
+				bins.sum[i] += w;
+				bins.sqsum[i] += w * w;
+			    }
+			}
+		    }
+
+		public:
+		    int nblocks; //!< Number of blocks of rows (default: 64)
+
+		    PairSweep() : ntypes(0), nblocks(64) {}
+
+		    /**
+		     * @brief Add channel and return its index
+		     * @param id1 First atom type (-1 for any)
+		     * @param id2 Second atom type (-1 for any)
+		     * @param dr Bin width
+		     * @param rmax Pairs at this or larger distances are ignored
+		     * @param weight Weight of pair (default: 1)
+		     * @param coordinate Value to bin pairs by (default: distance)
+		     * @param xmin Smallest binned value; pairs below are ignored (default: 0)
+		     */
+		    int add( int id1, int id2, double dr, double rmax = pc::infty, Tweight weight = nullptr,
+			    Tweight coordinate = nullptr, double xmin = 0 )
+		    {
+			channels.push_back({id1, id2, dr, rmax, weight, coordinate, bin(xmin, dr)});
+			table.clear();
+			return channels.size() - 1;
+		    }
+
+		    /** @brief Sample all channels for the current configuration */
+		    void sweep( Tspace &spc )
+		    {
+			if ( table.empty() || ntypes != int(atom.size()))
+			    setup();
+
+			index.clear();
+			for ( int i = 0; i < int(spc.p.size()); i++ )
+			{
+			    int t = spc.p[i].id;
+			    if ( t < ntypes && used[t] )
+				index.push_back(i);
+			}
+			int n = index.size();
+			type.resize(n);
+			pos.resize(n);
+			for ( int a = 0; a < n; a++ )
+			{
+			    type[a] = spc.p[index[a]].id;
+			    pos[a] = spc.p[index[a]];
+			}
+
+			double rc = 0;
+			for ( auto &c : channels )
+			    rc = std::max(rc, c.rmax);
+			bool useCells = cells.build(spc.geo, pos, rc);
+
+			blocks.resize(std::max(1, nblocks));
+			for ( auto &h : blocks )
+			{
+			    h.resize(channels.size());
+			    for ( auto &bins : h )
+				bins.clear();
+			}
+#pragma omp parallel for schedule (dynamic)
+			for ( int k = 0; k < int(blocks.size()); k++ )
+			    for ( int a = k; a < n; a += blocks.size())
+				if ( useCells )
+				    cells.forEach(pos[a], [&]( int b ) { if ( b > a ) pair(blocks[k], spc, a, b); });
+				else
+				    for ( int b = a + 1; b < n; b++ )
+					pair(blocks[k], spc, a, b);
+
+			vector<double> count(ntypes, 0);
+			for ( int a = 0; a < n; a++ )
+			    count[type[a]]++;
+			npairs.assign(channels.size(), 0);
+			for ( int t1 = 0; t1 < ntypes; t1++ )
+			    for ( int t2 = t1; t2 < ntypes; t2++ )
+				for ( auto c : table[t1 * ntypes + t2] )
+				    npairs[c] += (t1 == t2) ? 0.5 * count[t1] * (count[t1] - 1) : count[t1] * count[t2];
+
+			result.resize(channels.size());
+			for ( size_t c = 0; c < channels.size(); c++ )
+			{
+			    auto &bins = result[c];
+			    size_t m = 0;
+			    for ( auto &h : blocks )
+				m = std::max(m, h[c].cnt.size());
+			    bins.sum.assign(m, 0);
+			    bins.sqsum.assign(m, 0);
+			    bins.cnt.assign(m, 0);
+			    for ( auto &h : blocks )
+				for ( size_t i = 0; i < h[c].cnt.size(); i++ )
+				{
+				    bins.sum[i] += h[c].sum[i];
+				    bins.sqsum[i] += h[c].sqsum[i];
+				    bins.cnt[i] += h[c].cnt[i];
+				}
+			}
+		    }
+
+		    /** @brief Number of pairs of channel `c` in the last sweep, including those beyond `rmax` */
+		    double pairs( int c ) const { return npairs.at(c); }
+
+		    /** @brief Call `f(r, weight, count)` for each visited bin of channel `c` in the last sweep */
+		    template<class Tfunc>
+			void forEach( int c, Tfunc f ) const
+			{
+			    auto &bins = result.at(c);
+			    for ( size_t i = 0; i < bins.cnt.size(); i++ )
+				if ( bins.cnt[i] > 0 )
+				    f((int(i) + channels[c].kmin) * channels[c].dr, bins.sum[i], bins.cnt[i]);
+			}
+
+		    /** @brief Call `f(r, weights)` with the weights of each visited bin of channel `c` as `Average` */
+		    template<class Tfunc>
+			void forEachAverage( int c, Tfunc f ) const
+			{
+			    auto &bins = result.at(c);
+			    for ( size_t i = 0; i < bins.cnt.size(); i++ )
+				if ( bins.cnt[i] > 0 )
+				    f((int(i) + channels[c].kmin) * channels[c].dr,
+					    Average<double>(bins.sum[i] / bins.cnt[i], bins.sqsum[i], bins.cnt[i]));
+			}
+	    };
+
 	/**
 	 * @brief Atomic radial distribution function, g(r)
 	 *
@@ -2112,31 +2443,45 @@ namespace Faunus
 	 *          { "name1":"Na", "name2":"Na", "dim":3, "dr":0.1, "file":"rdf-nana.dat"}
 	 *        ]
 	 *     }
+	 *
+	 * All pairs are sampled in a single sweep, see `PairSweep`. With
+	 * `rmax` (angstrom) given for each pair, distant pairs are skipped
+	 * using a cell list in cuboidal geometries; the sum in the normalization
+	 * then runs over all pairs, including those not histogrammed. Other pair
+	 * functions do not accept `rmax`.
+	 *
+	 * Histograms store all bins up to the largest distance and are limited to
+	 * `FlatTable2D::maxbins` bins. If `dr` is too fine for the largest distance
+	 * in the initial geometry (or `rmax`), construction throws; this applies to
+	 * all pair functions with this input.
 	 */
 	template<class Tspace>
 	    class AtomRDF : public PairFunctionBase {
 		Tspace &spc;
+		PairSweep<Tspace> sweep;
+
+		void _sample() override
+		{
+		    sweep.sweep(spc);
+		    PairFunctionBase::_sample();
+		}
+
 		void update(data &d) override
 		{
+		    int c = &d - datavec.data();
 		    V += spc.geo.getVolume( d.dim );
-		    int N = spc.p.size();
-		    int id1 = atom[ d.name1 ].id;
-		    int id2 = atom[ d.name2 ].id;
-		    for (int i=0; i<N-1; i++)
-			for (int j=i+1; j<N; j++)
-			    if (
-				    ( spc.p[i].id==id1 && spc.p[j].id==id2 ) ||
-				    ( spc.p[i].id==id2 && spc.p[j].id==id1 )
-			       )
-			    {
-				double r = spc.geo.dist( spc.p[i], spc.p[j] );
-				d.hist(r)++;
-			    }
+		    d.npairs += sweep.pairs(c);
+		    sweep.forEach(c, [&d]( double r, double, unsigned long n ) { d.hist(r) += n; });
 		}
 
 		public:
 		AtomRDF( Tmjson j, Tspace &spc ) : PairFunctionBase(j,
-			"Atomic Pair Distribution Function"), spc(spc) {}
+			"Atomic Pair Distribution Function", true), spc(spc)
+		{
+		    checkRange( Geometry::maxDistance(spc.geo) );
+		    for (auto &d : datavec)
+			sweep.add( atom[ d.name1 ].id, atom[ d.name2 ].id, d.dr, d.rmax );
+		}
 
 		~AtomRDF()
 		{
@@ -2147,7 +2492,7 @@ namespace Faunus
 		}
 	    };
 
-	/** @brief Same as `AtomRDF` but for molecules. Identical input. */
+	/** @brief Same as `AtomRDF` but for molecules. Identical input, except `rmax`. */
 	template<class Tspace>
 	    class MoleculeRDF : public PairFunctionBase {
 		Tspace &spc;
@@ -2174,7 +2519,10 @@ namespace Faunus
 
 		public:
 		MoleculeRDF( Tmjson j, Tspace &spc ) : PairFunctionBase(j,
-			"Molecular Pair Distribution Function"), spc(spc) {}
+			"Molecular Pair Distribution Function"), spc(spc)
+		{
+		    checkRange( Geometry::maxDistance(spc.geo) );
+		}
 
 		~MoleculeRDF()
 		{
@@ -2188,21 +2536,29 @@ namespace Faunus
 	template<class Tspace>
 	    class ChargeRDF : public PairFunctionBase {
 		Tspace &spc;
+		PairSweep<Tspace> sweep;
+
+		void _sample() override
+		{
+		    sweep.sweep(spc);
+		    PairFunctionBase::_sample();
+		}
+
 		void update(data &d) override
 		{
 		    V += spc.geo.getVolume( d.dim );
-		    int N = spc.p.size();
-		    for (int i=0; i<N-1; i++) {
-			for (int j=i+1; j<N; j++) {
-			  double r = spc.geo.dist( spc.p[i], spc.p[j] );
-			  d.hist(r) += (spc.p[i].charge + spc.p[i].charge);
-			}
-		    }
+		    sweep.forEach(&d - datavec.data(), [&d]( double r, double q, unsigned long ) { d.hist(r) += q; });
 		}
 
 		public:
 		ChargeRDF( Tmjson j, Tspace &spc ) : PairFunctionBase(j,
-			"Charge Distribution Function"), spc(spc) {}
+			"Charge Distribution Function"), spc(spc)
+		{
+		    checkRange( Geometry::maxDistance(spc.geo) );
+		    typedef typename Tspace::ParticleType T;
+		    for (auto &d : datavec)
+			sweep.add( -1, -1, d.dr, pc::infty, []( const T &a, const T & ) { return a.charge + a.charge; } );
+		}
 
 		~ChargeRDF()
 		{
@@ -2251,7 +2607,10 @@ namespace Faunus
 
 		public:
 		MoleculeMumu( Tmjson j, Tspace &spc ) : PairFunctionBase(j,
-			"Molecular Pair Distribution Functions (g(r),mumu(r))"), spc(spc) {}
+			"Molecular Pair Distribution Functions (g(r),mumu(r))"), spc(spc)
+		{
+		    checkRange( Geometry::maxDistance(spc.geo) );
+		}
 
 		~MoleculeMumu()
 		{
@@ -2309,50 +2668,62 @@ namespace Faunus
 	template<class Tspace>
 	    class KirkwoodFactor : public PairFunctionBase {
 		Tspace &spc;
+		PairSweep<Tspace> sweep;
 
 		Table2D<double, double> mucorr_angle;
 		Table2D<double, Average<double> > mucorr_dist;
 		std::vector<data> datavec2;        // vector of data sets, for later use (mucorr_angle,mucorr_dist)
 
+		void _sample() override
+		{
+		    sweep.sweep(spc);
+		    PairFunctionBase::_sample();
+		}
+
 		public:
 		void update( data &d ) override
 		{
-		    int N = spc.p.size() - 1;
+		    int c = 4 * (&d - datavec.data()); // channels of `d`, see constructor
 		    int id1 = atom[ d.name1 ].id;
 		    int id2 = atom[ d.name2 ].id;
-		    for ( int i = 0; i < N; i++ )
-		    {
-			if ( spc.p[i].id==id1 || spc.p[i].id==id2 )
-			    d.hist(0) += spc.p[i].mu().dot(spc.p[i].mu()) * spc.p[i].muscalar() * spc.p[i].muscalar();
-			for ( int j = i + 1.; j < N + 1; j++ )
-			{
-			    if ( ( spc.p[i].id==id1 && spc.p[j].id==id2 ) || ( spc.p[i].id==id2 && spc.p[j].id==id1 ) )
-			    {
-				double r = spc.geo.dist(spc.p[i], spc.p[j]);
-				double sca = spc.p[i].mu().dot(spc.p[j].mu());
-				mucorr_angle(sca) += 1.;
-				d.hist2(r) += sca;
-				mucorr_dist(r) += 0.5 * (3 * sca * sca - 1.);
-				d.hist(r) += 2 * sca * spc.p[i].muscalar() * spc.p[j].muscalar();
-			    }
-			}
-		    }
-		    if ( spc.p[N].id==id1 || spc.p[N].id==id2 )
-			d.hist(0) += spc.p[N].mu().dot(spc.p[N].mu()) * spc.p[N].muscalar() * spc.p[N].muscalar();
+		    for ( auto &a : spc.p )
+			if ( a.id==id1 || a.id==id2 )
+			    d.hist(0) += a.mu().dot(a.mu()) * a.muscalar() * a.muscalar();
+		    sweep.forEach(c, [&d]( double r, double w, unsigned long ) { d.hist(r) += w; });
+		    sweep.forEachAverage(c + 1, [&d]( double r, const Average<double> &w ) {
+			d.hist2(r) = d.hist2(r) + w; });
+		    sweep.forEachAverage(c + 2, [&]( double r, const Average<double> &w ) {
+			mucorr_dist(r) = mucorr_dist(r) + w; });
+		    sweep.forEach(c + 3, [&]( double sca, double, unsigned long n ) { mucorr_angle(sca) += n; });
 		}
 
 		void normalize(data &d) override
 		{
 		    double sum = 0;  
-		    for (auto &i : d.hist.getMap()) {
-			sum += i.second;
-			i.second = sum;
-		    }
+		    d.hist.forEach( [&sum](double, double &y) {
+			sum += y;
+			y = sum;
+		    } );
 		}
 
 		KirkwoodFactor( Tmjson j, Tspace &spc ) : PairFunctionBase(j,"KirkwoodFactor"), spc(spc) {
 		    mucorr_angle.setResolution(datavec.back().dr*0.1); // Interval goes only from -1 to 1, thus we generally must increase the resolution, hence the factor of 0.1
 		    mucorr_dist.setResolution(datavec.back().dr);
+		    checkRange( Geometry::maxDistance(spc.geo) );
+
+		    // four channels per data set, all sampled in a single sweep over pairs
+		    typedef typename Tspace::ParticleType T;
+		    auto sca = []( const T &a, const T &b ) { return a.mu().dot(b.mu()); };
+		    for (auto &d : datavec) {
+			int id1 = atom[ d.name1 ].id;
+			int id2 = atom[ d.name2 ].id;
+			sweep.add( id1, id2, d.dr, pc::infty,
+				[sca]( const T &a, const T &b ) { return 2 * sca(a, b) * a.muscalar() * b.muscalar(); } );
+			sweep.add( id1, id2, d.dr, pc::infty, sca );
+			sweep.add( id1, id2, datavec.back().dr, pc::infty,
+				[sca]( const T &a, const T &b ) { double x = sca(a, b); return 0.5 * (3 * x * x - 1.); } );
+			sweep.add( id1, id2, datavec.back().dr*0.1, pc::infty, nullptr, sca, -1 );
+		    }
 		}
 
 		~KirkwoodFactor()
@@ -3047,6 +3418,10 @@ namespace Faunus
 	 * `qmin`    | Minimum q value (1/angstrom)
 	 * `qmax`    | Maximum q value (1/angstrom)
 	 * `dq`      | q spacing (1/angstrom)
+	 * `histogram` | Bin pair distances before the transform (bool, default: false)
+	 * `dr`      | Histogram resolution (angstrom, default: 0.01)
+	 *
+	 * See `Scatter::DebyeFormula` for details.
 	 */
 	template<class Tspace, class Tformfactor=Scatter::FormFactorUnity<double>>
 	    class ScatteringFunction : public AnalysisBase {
@@ -3104,6 +3479,221 @@ namespace Faunus
 		    }
 	    };
 
+	/** @brief Interface of `AnalysisPipeline` independent of `Space` type */
+	class AnalysisPipelineBase
+	{
+	    public:
+		virtual ~AnalysisPipelineBase() {}
+		virtual void sample()=0;                          //!< Snapshot and queue due analyses
+		virtual void flush()=0;                           //!< Wait until all queued samples are done
+		virtual void finish()=0;                          //!< Wait for queued samples and stop workers
+		virtual bool contains( const AnalysisBase* )=0;   //!< True if analysis is run by the pipeline
+	};
+
+	/**
+	 * @brief Runs analyses on snapshots of `Space` in worker threads
+	 *
+	 * Each analysis is constructed on a private copy of `Space`, obtained
+	 * from `space()`, and is then added with `add()`. When sampling is due,
+	 * `sample()` copies particles, groups and geometry to a snapshot on the
+	 * calling (Markov chain) thread and the analysis runs on its copy,
+	 * updated from the snapshot, in a worker thread.
+	 *
+	 * Snapshots are kept in a pool of at most `buffer` slots which
+	 * bounds memory; if all are in use, `sample()` waits for a slot to
+	 * be released. Analysis `i` always runs on worker `i % threads` which
+	 * processes snapshots in the order taken and results are thus
+	 * identical to those of inline sampling.
+	 *
+	 * Only analyses that use nothing but their `Space` may be added, i.e.
+	 * not those evaluating energies. Each worker draws random numbers via
+	 * `slumpStreams()` from a stream of its own, see `randomWorker()`, so
+	 * analyses that draw random numbers give results that differ from, but
+	 * are as reproducible as, inline sampling. Drawing directly from `slump`
+	 * in a worker throws. The private
+	 * spaces are kept until the pipeline is destroyed and outlive the
+	 * analyses held by it, which may thus use their space in `json()` and
+	 * in their destructors after `finish()`.
+	 */
+	template<class Tspace>
+	    class AnalysisPipeline : public AnalysisPipelineBase
+	    {
+		private:
+		    typedef std::chrono::steady_clock Tclock;
+		    typedef std::shared_ptr<AnalysisBase> Tptr;
+
+		    struct Slot
+		    {
+			typename Tspace::State state;
+			Tclock::time_point t;     // time of snapshot
+			int pending;              // analyses yet to sample
+			Slot( const Tspace &s ) : state{s.p, std::vector<Group>(), s.geo}, pending(0) {}
+		    };
+
+		    struct Job
+		    {
+			Slot *slot;
+			int analysis;
+		    };
+
+		    Tspace &spc;
+		    vector<std::shared_ptr<Tspace>> spaces;  // private space of each analysis; must precede `analyses`
+		    vector<Tptr> analyses;
+		    vector<std::unique_ptr<Slot>> slots;
+		    vector<Slot *> idle;                     // released slots
+		    vector<std::deque<Job>> queue;           // jobs of each worker
+		    vector<std::thread> workers;
+		    vector<int> randomIds;                   // `randomWorker()` number of each worker
+		    vector<int> due;
+		    std::mutex mutex;
+		    std::condition_variable jobAdded, slotReleased;
+		    std::exception_ptr error;                // first exception thrown by a worker
+		    size_t buffer;
+		    bool stop;
+
+		    void work( size_t w )
+		    {
+			randomWorker() = randomIds[w];
+			std::unique_lock<std::mutex> lock(mutex);
+			while ( true )
+			{
+			    jobAdded.wait(lock, [&] { return stop || !queue[w].empty(); });
+			    if ( queue[w].empty())
+				return;
+			    Job job = queue[w].front();
+			    queue[w].pop_front();
+			    lock.unlock();
+			    try
+			    {
+				spaces[job.analysis]->setState(job.slot->state);
+				analyses[job.analysis]->sample(job.slot->t);
+			    }
+			    catch ( ... )
+			    {
+				std::lock_guard<std::mutex> l(mutex);
+				if ( !error )
+				    error = std::current_exception();
+			    }
+			    lock.lock();
+			    if ( --job.slot->pending == 0 )
+			    {
+				idle.push_back(job.slot);
+				slotReleased.notify_all();
+			    }
+			}
+		    }
+
+		    void rethrow()
+		    {
+			if ( error )
+			{
+			    auto e = error;
+			    error = nullptr;
+			    std::rethrow_exception(e);
+			}
+		    }
+
+		public:
+		    /**
+		     * @param spc Space sampled by the Markov chain
+		     * @param threads Number of worker threads
+		     * @param buffer Maximum number of snapshots
+		     */
+		    AnalysisPipeline( Tspace &spc, int threads, int buffer ) : spc(spc), buffer(std::max(1, buffer)), stop(false)
+		    {
+			queue.resize(std::max(1, threads));
+			slumpStreams(); // restricts `slump` to the master thread
+			for ( size_t w = 0; w < queue.size(); w++ )
+			    randomIds.push_back(RandomWorkers::acquire());
+			for ( size_t w = 0; w < queue.size(); w++ )
+			    workers.emplace_back(&AnalysisPipeline::work, this, w);
+		    }
+
+		    ~AnalysisPipeline()
+		    {
+			finish();
+			for ( auto i : randomIds )
+			    RandomWorkers::release(i);
+		    }
+
+		    /** @brief Private copy of `Space` for the next analysis to add */
+		    Tspace &space()
+		    {
+			spaces.push_back(std::make_shared<Tspace>(spc));
+			return *spaces.back();
+		    }
+
+		    /** @brief Add analysis constructed on the latest `space()` */
+		    void add( Tptr a )
+		    {
+			assert(analyses.size() + 1 == spaces.size());
+			analyses.push_back(a);
+		    }
+
+		    bool contains( const AnalysisBase *a ) override
+		    {
+			for ( auto &i : analyses )
+			    if ( i.get() == a )
+				return true;
+			return false;
+		    }
+
+		    void sample() override
+		    {
+			due.clear();
+			for ( size_t i = 0; i < analyses.size(); i++ )
+			    if ( analyses[i]->due())
+				due.push_back(i);
+			if ( due.empty())
+			    return;
+
+			std::unique_lock<std::mutex> lock(mutex);
+			rethrow();
+			if ( idle.empty() && slots.size() < buffer )
+			{
+			    slots.emplace_back(new Slot(spc));
+			    idle.push_back(slots.back().get());
+			}
+			slotReleased.wait(lock, [&] { return !idle.empty(); });
+			Slot *s = idle.back();
+			idle.pop_back();
+			lock.unlock();
+
+			spc.getState(s->state);
+			s->t = Tclock::now();
+			s->pending = due.size();
+
+			lock.lock();
+			for ( auto i : due )
+			    queue[i % queue.size()].push_back({s, i});
+			jobAdded.notify_all();
+		    }
+
+		    void flush() override
+		    {
+			std::unique_lock<std::mutex> lock(mutex);
+			slotReleased.wait(lock, [&] { return idle.size() == slots.size(); });
+			rethrow();
+		    }
+
+		    /** @brief Finish queued samples and join workers; spaces and analyses are kept */
+		    void finish() override
+		    {
+			if ( workers.empty())
+			    return;
+			try { flush(); }
+			catch ( std::exception &e ) { std::cerr << "Analysis error: " << e.what() << endl; }
+			{
+			    std::lock_guard<std::mutex> lock(mutex);
+			    stop = true;
+			}
+			jobAdded.notify_all();
+			for ( auto &t : workers )
+			    t.join();
+			workers.clear();
+		    }
+	    };
+
 	/**
 	 * @brief Class for accumulating analysis classes
 	 *
@@ -3113,23 +3703,34 @@ namespace Faunus
 	 * specifying how many microloops to count between
 	 * each analysis call.
 	 * Aggregated results of all analysis function are saved
-	 * to a JSON file upon descruction. Use `_jsonfile` to
-	 * control the output file name.
+	 * to a JSON file upon descruction, together with parameters
+	 * of the Hamiltonian (`Energybase::json()`) under `energy`.
+	 * Use `_jsonfile` to control the output file name.
+	 *
+	 * With `"_async": {"threads":2, "buffer":4}`, analyses that only
+	 * read particles and groups (marked below with *) run on snapshots
+	 * in worker threads, off the Markov chain, see `AnalysisPipeline`.
+	 * `buffer` is the maximum number of snapshots held (default: 4)
+	 * and `threads` the number of workers (default: 1).
 	 *
 	 * Keyword                 |  Description
 	 * :---------------------  |  :----------------------------
-	 * `atomrdf`               |  `Analysis::AtomRDF`
-	 * `chargemultipole`       |  `Analysis::ChargeMultipole`
+	 * `angleanalyzis`         |  `Analysis::AngleAnalyzis` *
+	 * `atomrdf`               |  `Analysis::AtomRDF` *
+	 * `chargemultipole`       |  `Analysis::ChargeMultipole` *
+	 * `chargerdf`             |  `Analysis::ChargeRDF` *
+	 * `cyldensity`            |  `Analysis::CylindricalDensity` *
 	 * `energyfile`            |  `Analysis::SystemEnergy`
-	 * `kirkwoodfactor`        |  `Analysis::KirkwoodFactor`
+	 * `kirkwoodfactor`        |  `Analysis::KirkwoodFactor` *
 	 * `capanalysis`           |  `Analysis::Capanalysis`
 	 * `meanforce`             |  `Analysis::MeanForce`
-	 * `molrdf`                |  `Analysis::MoleculeRDF`
-	 * `multipoleanalysis`     |  `Analysis::MultipoleAnalysis`
-	 * `multipoledistribution` |  `Analysis::MultipoleDistribution`
-	 * `polymershape`          |  `Analysis::PolymerShape`
+	 * `molrdf`                |  `Analysis::MoleculeRDF` *
+	 * `molrdfmumu`            |  `Analysis::MoleculeMumu` *
+	 * `multipoleanalysis`     |  `Analysis::MultipoleAnalysis` *
+	 * `multipoledistribution` |  `Analysis::MultipoleDistribution` *
+	 * `polymershape`          |  `Analysis::PolymerShape` *
 	 * `propertytraj`          |  `Analysis::PropertyTraj`
-	 * `scatter`               |  `Analysis::ScatteringFunction`
+	 * `scatter`               |  `Analysis::ScatteringFunction` *
 	 * `virial`                |  `Analysis::VirialPressure`
 	 * `virtualvolume`         |  `Analysis::VirtualVolumeMove`
 	 * `widom`                 |  `Analysis::Widom`  
@@ -3138,14 +3739,17 @@ namespace Faunus
 	 * `xtctraj`               |  `Analysis::XTCtraj`
 	 * `pqrfile`               |  Save PQR file at end of simulation, i.e. `"pqrfile" : {"file":"conf.pqr"}`
 	 * `aamfile`               |  Save AAM file at end of simulation, i.e. `"aamfile" : {"file":"conf.aam"}`
-	 * `statefile`             |  Save state file at end of simulation, i.e. `"statefile" : {"file":"state"}`
+	 * `statefile`             |  Save state file at end of simulation, i.e. `"statefile" : {"file":"state"}`; add `"format":"binary"` for a binary restart file, see `Space::save()`
 	 * `_jsonfile`             |  Ouput json file w. collected results (default: analysis_out.json)
+	 * `_async`                |  Run analyses marked * in worker threads, see above
 	 */
 	class CombinedAnalysis : public AnalysisBase
 	{
 	    private:
 		typedef std::shared_ptr<AnalysisBase> Tptr;
+		std::shared_ptr<AnalysisPipelineBase> pipeline; // asynchronous analyses, if any; destroyed after `v`
 		vector <Tptr> v;
+		std::function<Tmjson()> energyjson; // `json()` of the Hamiltonian
 		string _info() override;
 		void _sample() override;
 		string jsonfile;
@@ -3160,6 +3764,26 @@ namespace Faunus
 			auto &m = j.at("analysis");
 
 			jsonfile = m.value("_jsonfile", "analysis_out.json");
+			energyjson = [&pot]() { return pot.json(); };
+
+			std::shared_ptr<AnalysisPipeline<Tspace>> pipe;
+			if ( m.count("_async"))
+			{
+			    auto &a = m["_async"];
+			    pipe = std::make_shared<AnalysisPipeline<Tspace>>(spc, a.value("threads", 1), a.value("buffer", 4));
+			    pipeline = pipe;
+			}
+
+			// add analysis `f(space)`, asynchronously if enabled
+			auto async = [&]( std::function<AnalysisBase *( Tspace & )> f ) {
+			    if ( pipe )
+			    {
+				v.push_back(Tptr(f(pipe->space())));
+				pipe->add(v.back());
+			    }
+			    else
+				v.push_back(Tptr(f(spc)));
+			};
 
 			for ( auto i = m.begin(); i != m.end(); ++i )
 			{
@@ -3187,8 +3811,9 @@ namespace Faunus
 
 				if ( i.key() == "statefile" )
 				{
+				    auto format = (val.value("format", string("text")) == "binary") ? Tspace::BINARY : Tspace::TEXT;
 				    auto writer = std::bind(
-					    []( string file, Tspace &s ) { s.save(file); }, _1, ref(spc));
+					    [format]( string file, Tspace &s ) { s.save(file, format); }, _1, ref(spc));
 				    v.push_back(Tptr(new WriteOnceFileAnalysis(val, writer)));
 				}
 
@@ -3205,13 +3830,13 @@ namespace Faunus
 				    v.push_back(Tptr(new VirtualVolumeMove<Tspace>(val, pot, spc)));
 
 				if ( i.key() == "polymershape" )
-				    v.push_back(Tptr(new PolymerShape<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new PolymerShape<Tspace>(val, s); });
 
 				if ( i.key() == "propertytraj" )
 				    v.push_back(Tptr(new PropertyTraj(val, pot, spc)));
 
 				if ( i.key() == "cyldensity" )
-				    v.push_back(Tptr(new CylindricalDensity<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new CylindricalDensity<Tspace>(val, s); });
 
 				if ( i.key() == "widom" )
 				    v.push_back(Tptr(new Widom<Tspace>(val, pot, spc)));
@@ -3223,13 +3848,13 @@ namespace Faunus
 				    v.push_back(Tptr(new WidomMolecule<Tspace>(val, pot, spc)));
 
 				if ( i.key() == "chargemultipole" )
-				    v.push_back(Tptr(new ChargeMultipole<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new ChargeMultipole<Tspace>(val, s); });
 
 				if ( i.key() == "multipoledistribution" )
-				    v.push_back(Tptr(new MultipoleDistribution<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new MultipoleDistribution<Tspace>(val, s); });
 
 				if ( i.key() == "kirkwoodfactor" )
-				    v.push_back(Tptr(new KirkwoodFactor<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new KirkwoodFactor<Tspace>(val, s); });
 
 				if ( i.key() == "capanalysisLK" )
 				    v.push_back(Tptr(new CapanalysisLK<Tspace>(val, spc)));
@@ -3247,28 +3872,28 @@ namespace Faunus
 				    v.push_back(Tptr(new Capanalysis<Tspace>(val, spc)));
 
 				if ( i.key() == "multipoleanalysis" )
-				    v.push_back(Tptr(new MultipoleAnalysis<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new MultipoleAnalysis<Tspace>(val, s); });
 
 				if ( i.key() == "meanforce" )
 				    v.push_back(Tptr(new MeanForce(val, pot, spc)));
 
 				if ( i.key() == "atomrdf" )
-				    v.push_back(Tptr(new AtomRDF<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new AtomRDF<Tspace>(val, s); });
 				
 				if ( i.key() == "chargerdf" )
-				    v.push_back(Tptr(new ChargeRDF<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new ChargeRDF<Tspace>(val, s); });
 
 				if ( i.key() == "molrdf" )
-				    v.push_back(Tptr(new MoleculeRDF<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new MoleculeRDF<Tspace>(val, s); });
 
 				if ( i.key() == "molrdfmumu" )
-				    v.push_back(Tptr(new MoleculeMumu<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new MoleculeMumu<Tspace>(val, s); });
 				
 				if ( i.key() == "angleanalyzis" )
-				    v.push_back(Tptr(new AngleAnalyzis<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new AngleAnalyzis<Tspace>(val, s); });
 
 				if ( i.key() == "scatter" )
-				    v.push_back(Tptr(new ScatteringFunction<Tspace>(val, spc)));
+				    async([&]( Tspace &s ) { return new ScatteringFunction<Tspace>(val, s); });
 			    }
 			    catch(std::exception &e)
 			    {
@@ -1185,13 +1185,10 @@ namespace Faunus
           if ( f )
           {
               map.clear();
-              while ( !f.eof())
-              {
-                  Tx x;
-                  double y;
-                  f >> x >> y;
+              Tx x;
+              double y;
+              while ( f >> x >> y )
                   operator()(x) = y;
-              }
               if ( tabletype == HISTOGRAM )
               {
                   if ( !map.empty())
@@ -1778,6 +1775,318 @@ namespace Faunus
       }
   };
 
+  /**
+   * @brief 2D table with contiguous bins - a fast alternative to `Table2D`
+   *
+   * Bins are centred at integer multiples of the resolution, exactly as
+   * the keys of `Table2D`, but stored in a vector so that binning is of
+   * constant complexity and does not allocate, except when the table
+   * grows beyond its current range. A range can be given in advance
+   * with `setRange()`. As all bins between the smallest and largest x
+   * are stored, growing beyond `maxbins` bins throws `std::range_error`.
+   * As for `Table2D`, only bins that have been accessed are saved and
+   * used in sums.
+   *
+   * For parallel sampling, fill one table per thread and merge
+   * them with `operator+=`. The access `operator()` marks and may grow
+   * storage also when only reading and is therefore not safe for
+   * concurrent readers; use the const `find()` for lookups.
+   *
+   * Example:
+   *
+   * ~~~~
+   * FlatTable2D<double,double> hist(0.1);
+   * hist.setRange(0, 50);
+   * hist(2.04) += 1;                      // bin at x=2.0
+   * hist.forEach( [](double x, double &y) { y /= x*x; } );
+   * hist.save("hist.dat");
+   * ~~~~
+   */
+  template<typename Tx, typename Ty>
+  class FlatTable2D
+  {
+  private:
+      Tx dx;
+      int kmin;              // bin index of first element
+      size_t nused;          // number of accessed bins
+      vector<Ty> y;
+      vector<char> used;
+
+      /** @brief Bin index of `x`; throws if not representable */
+      int bin( Tx x ) const
+      {
+          Tx k = (x >= 0) ? x / dx + 0.5 : x / dx - 0.5;
+          if ( !(std::fabs(k) < std::numeric_limits<int>::max()))
+              throw std::range_error("FlatTable2D: x out of range");
+          return int(k);
+      }
+
+      /**
+       * @brief Grow storage to hold bins `k1` to `k2`, with some slack if already in use
+       *
+       * All bins between the extremes are allocated, so a range spanning
+       * more than `maxbins` bins throws and leaves the table unchanged.
+       */
+      void grow( int k1, int k2 )
+      {
+          int64_t lo = y.empty() ? k1 : std::min(k1, kmin);
+          int64_t hi = y.empty() ? k2 : std::max(k2, kmin + int(y.size()) - 1);
+          if ( hi - lo + 1 > int64_t(maxbins))
+              throw std::range_error("FlatTable2D: range exceeds " + std::to_string(maxbins) + " bins");
+          if ( y.empty())
+          {
+              kmin = k1;
+              y.resize(k2 - k1 + 1);
+              used.resize(k2 - k1 + 1, 0);
+              return;
+          }
+          int kmax = kmin + int(y.size()) - 1;
+          int slack = std::min(y.size(), size_t(maxbins) - size_t(hi - lo + 1)) / 2;
+          if ( k1 < kmin )
+          {
+              int n = kmin - k1 + slack;
+              y.insert(y.begin(), n, Ty());
+              used.insert(used.begin(), n, 0);
+              kmin -= n;
+          }
+          if ( k2 > kmax )
+          {
+              y.resize(y.size() + k2 - kmax + slack);
+              used.resize(y.size(), 0);
+          }
+      }
+
+      /** @brief Indices of first and last accessed bin */
+      std::pair<size_t, size_t> limits() const
+      {
+          size_t first = 0, last = used.size();
+          while ( first < used.size() && !used[first] )
+              first++;
+          while ( last > first && !used[last - 1] )
+              last--;
+          return {first, last - 1};
+      }
+
+      /** @brief Value of bin `i` for output, compensated for half bin width at the ends of a histogram */
+      Ty output( size_t i, const std::pair<size_t, size_t> &ends ) const
+      {
+          Ty v = y[i];
+          if ( tabletype == HISTOGRAM )
+              if ( i == ends.first || (i == ends.second && nused > 1))
+                  v *= 2;
+          return v;
+      }
+
+  public:
+      enum type { HISTOGRAM, XYDATA };
+      type tabletype;
+
+      static const size_t maxbins = 10000000; //!< Upper bound for the number of allocated bins
+
+      /**
+       * @brief Constructor
+       * @param resolution Resolution of the x axis
+       * @param key Table type: HISTOGRAM or XYDATA
+       */
+      FlatTable2D( Tx resolution = 1, type key = XYDATA ) : kmin(0), nused(0), tabletype(key)
+      {
+          setResolution(resolution);
+      }
+
+      /** @brief Remove all bins */
+      void clear()
+      {
+          y.clear();
+          used.clear();
+          nused = 0;
+      }
+
+      /** @brief Set resolution and remove all bins */
+      void setResolution( Tx resolution )
+      {
+          assert(resolution > 0);
+          dx = resolution;
+          clear();
+      }
+
+      Tx getResolution() const { return dx; }
+
+      /** @brief Allocate bins in the interval [xmin,xmax] - does not mark them as accessed */
+      void setRange( Tx xmin, Tx xmax )
+      {
+          assert(xmin <= xmax);
+          grow(bin(xmin), bin(xmax));
+      }
+
+      /** @brief True if no bin has been accessed */
+      bool empty() const { return nused == 0; }
+
+      /** @brief Number of accessed bins */
+      size_t size() const { return nused; }
+
+      /** @brief Access operator - returns reference to y(x); marks the bin and may grow storage */
+      Ty &operator()( Tx x )
+      {
+          int k = bin(x);
+          if ( y.empty() || k < kmin || k >= kmin + int(y.size()))
+              grow(k, k);
+          size_t i = k - kmin;
+          if ( !used[i] )
+          {
+              used[i] = 1;
+              nused++;
+          }
+          return y[i];
+      }
+
+      /** @brief Find bin and return corresponding value, otherwise zero */
+      Ty find( Tx x ) const
+      {
+          int k = bin(x) - kmin;
+          if ( k >= 0 && k < int(y.size()) && used[k] )
+              return y[k];
+          return Ty();
+      }
+
+      /** @brief Call `f(x,y)` for all accessed bins in order of increasing x */
+      template<class Tfunc>
+      void forEach( Tfunc f )
+      {
+          for ( size_t i = 0; i < y.size(); i++ )
+              if ( used[i] )
+                  f(Tx(int(i) + kmin) * dx, y[i]);
+      }
+
+      template<class Tfunc>
+      void forEach( Tfunc f ) const
+      {
+          for ( size_t i = 0; i < y.size(); i++ )
+              if ( used[i] )
+                  f(Tx(int(i) + kmin) * dx, y[i]);
+      }
+
+      /** @brief Merge bins of another table with same resolution, i.e. from another thread */
+      FlatTable2D &operator+=( const FlatTable2D &other )
+      {
+          assert(dx == other.dx);
+          other.forEach([&]( Tx x, const Ty &v )
+                        {
+                            Ty &t = operator()(x);
+                            t = t + v;
+                        });
+          return *this;
+      }
+
+      /** @brief Sum of all y values */
+      Ty sumy() const
+      {
+          Ty sum = 0;
+          forEach([&]( Tx, const Ty &v ) { sum += v; });
+          return sum;
+      }
+
+      /** @brief Same as `sumy()` */
+      Ty count() const { return sumy(); }
+
+      /** @brief Average of x weighted by y */
+      Tx mean() const
+      {
+          assert(!empty());
+          Tx avg = 0;
+          forEach([&]( Tx x, const Ty &v ) { avg += x * v; });
+          return avg / count();
+      }
+
+      /** @brief Standard deviation of x weighted by y */
+      Tx std() const
+      {
+          assert(!empty());
+          Tx std2 = 0, avg = mean();
+          forEach([&]( Tx x, const Ty &v ) { std2 += v * (x - avg) * (x - avg); });
+          return sqrt(std2 / count());
+      }
+
+      /** @brief Convert to map */
+      std::map<string, vector<double>> to_map() const
+      {
+          std::map<string, vector<double>> m;
+          m["x"].reserve(size());
+          m["y"].reserve(size());
+          forEach([&]( Tx x, const Ty &v )
+                  {
+                      m["x"].push_back(x);
+                      m["y"].push_back(v);
+                  });
+          return m;
+      }
+
+      /** @brief Save table to disk */
+      template<class T=double>
+      void save( const string &filename, T scale = 1, T translate = 0 ) const
+      {
+          if ( !empty())
+          {
+              std::ofstream f(filename.c_str());
+              f.precision(10);
+              if ( f )
+              {
+                  auto ends = limits();
+                  for ( size_t i = ends.first; i <= ends.second; i++ )
+                      if ( used[i] )
+                          f << Tx(int(i) + kmin) * dx << " " << (output(i, ends) + translate) * scale << "\n";
+              }
+          }
+      }
+
+      /** @brief Save table normalized by its integral to disk */
+      void normSave( const string &filename ) const
+      {
+          if ( !empty())
+          {
+              std::ofstream f(filename.c_str());
+              f.precision(10);
+              auto ends = limits();
+              Ty cnt = 0;
+              for ( size_t i = ends.first; i <= ends.second; i++ )
+                  if ( used[i] )
+                      cnt += output(i, ends);
+              cnt *= dx;
+              if ( f )
+              {
+                  for ( size_t i = ends.first; i <= ends.second; i++ )
+                      if ( used[i] )
+                          f << Tx(int(i) + kmin) * dx << " " << output(i, ends) / cnt << "\n";
+              }
+          }
+      }
+
+      /**
+       * @brief Load table from disk
+       * @returns False if the file could not be opened
+       */
+      bool load( const string &filename )
+      {
+          std::ifstream f(filename.c_str());
+          if ( f )
+          {
+              clear();
+              Tx x;
+              double v;
+              while ( f >> x >> v )
+                  operator()(x) = v;
+              if ( tabletype == HISTOGRAM && !empty())
+              {
+                  auto ends = limits();
+                  y[ends.first] /= 2;   // restore half bin width
+                  if ( nused > 1 )
+                      y[ends.second] /= 2;
+              }
+              return true;
+          }
+          return false;
+      }
+  };
+
   /**
    * @brief Finds pointer to element in tuple with specified type. `nullptr` if not found.
    *
@@ -39,6 +39,445 @@ namespace Faunus
   namespace Energy
   {
 
+    /**
+     * @brief Energies of the current configuration reused by `energyChange()`
+     *
+     * `energyChange()` evaluates the moved part of the system in both the
+     * trial and the current configuration. Terms of the current configuration
+     * that are known from earlier steps are kept here:
+     *
+     * - `external()` of the current configuration is the trial value of the
+     *   last accepted move.
+     * - `g_external()` and `g_internal()` are stored per group. They depend
+     *   only on the particles of the group and stay valid while other
+     *   groups move.
+     *
+     * The pair energy of the moved groups with the rest of the system
+     * (`g2All()`) depends on all particles and is not kept here. It is taken
+     * from the rows of an `EnergyMatrix` instead, so that no pair sums are
+     * evaluated for the current configuration when the pair term is wrapped
+     * in one (`Energybase::storesPairs()`). Otherwise it is recalculated, as
+     * is the `i2g()` loop over moved atoms of atomic groups; `info()` tells
+     * which. Wrap the pair term in `EnergyMatrix` when enabling the cache.
+     *
+     * Moves report the outcome with `accept()` and `reject()`, see
+     * `Move::Movebase`. An accepted change that did not pass through
+     * `energyChange()` invalidates the entries of the moved groups, and
+     * insertions, deletions, geometry changes and accepted moves without a
+     * `Space::Change` invalidate everything.
+     *
+     * The cache assumes that energies depend only on the configuration.
+     * `energyChange()` refuses to use it with energy terms for which
+     * `Energybase::cacheable()` is false, i.e. external potentials that are
+     * updated during simulation or `cmconstrain`. Penalty functions and code
+     * that modifies `Space::p` directly must call `clear()`. The cache is
+     * therefore off by default. With `check>0` every `check`'th cached energy
+     * is compared with a full recalculation and an exception is thrown if
+     * they differ. Options are read from `energy/cache`:
+     *
+     *  Keyword    | Description
+     *  :--------- | :------------------------------------------------------
+     *  `enable`   | Reuse current energies in `energyChange()` [default: false]
+     *  `check`    | Compare with full recalculation every n'th step [default: 0=off]
+     */
+    class EnergyCache
+    {
+    public:
+        typedef ChangeMap<vector<int>> Tkey;    //!< Moved groups and particles, cf. `Space::Change::mvGroup`
+
+        /** @brief Energy terms of the moved part of one configuration */
+        struct Terms
+        {
+            double pair;                            //!< `g2All()` and moved atoms
+            double external;                        //!< `external()`
+            vector<double> gExternal;               //!< `g_external()` per group (NaN if unknown)
+            vector<double> gInternal;               //!< `g_internal()` per group (NaN if unknown)
+
+            Terms() : pair(unknown()), external(unknown()) {}
+
+            /** @brief Mark all terms of the moved groups `k` unknown; only these are used */
+            void reset( const Tkey &k, size_t ngroups )
+            {
+                pair = external = unknown();
+                if ( gExternal.size() != ngroups )
+                {
+                    gExternal.assign(ngroups, unknown());
+                    gInternal.assign(ngroups, unknown());
+                }
+                else
+                    for ( auto &m : k )
+                        gExternal[m.first] = gInternal[m.first] = unknown();
+            }
+
+            /** @brief Sum of the terms of the moved groups `k` */
+            double sum( const Tkey &k ) const
+            {
+                double u = pair + external;
+                for ( auto &m : k )
+                {
+                    if ( !std::isnan(gExternal[m.first]))
+                        u += gExternal[m.first];
+                    if ( !std::isnan(gInternal[m.first]))
+                        u += gInternal[m.first];
+                }
+                return u;
+            }
+        };
+
+    private:
+        vector<double> gext, gint;  // current g_external and g_internal per group (NaN if unknown)
+        double ext;                 // current external energy (NaN if unknown)
+        Tkey trialKey;              // change evaluated by the last energyChange()
+        Terms trialTerms;           // ...and its trial energies
+        Terms newTerms, oldTerms;   // terms of trial and current configuration of the ongoing energyChange()
+        bool pending;               // trialTerms await accept() or reject()
+        unsigned long int cnt, cntChecks, cntTerms, cntReused, cntPairStored;
+
+        static double unknown() { return std::numeric_limits<double>::quiet_NaN(); }
+
+        void invalidate( const Tkey &k )
+        {
+            for ( auto &m : k )
+                if ( size_t(m.first) < gext.size())
+                    gext[m.first] = gint[m.first] = unknown();
+            ext = unknown();
+        }
+
+    public:
+        bool enabled;  //!< Use cache in `energyChange()`
+        int check;     //!< Compare with full recalculation every n'th step (0=never)
+
+        EnergyCache() : pending(false), cnt(0), cntChecks(0), cntTerms(0), cntReused(0), cntPairStored(0),
+                        enabled(false), check(0)
+        {
+            clear();
+        }
+
+        /** @brief Setup from json section `energy/cache` */
+        void setup( Tmjson &j )
+        {
+            auto &_j = j["energy"]["cache"];
+            enabled = _j["enable"] | false;
+            check = _j["check"] | 0;
+            clear();
+        }
+
+        /** @brief Forget all stored energies */
+        void clear()
+        {
+            gext.clear();
+            gint.clear();
+            ext = unknown();
+            pending = false;
+        }
+
+        /**
+         * @brief Empty terms of the trial configuration, to be filled by `energyChangeTerms()`
+         * @param k Moved groups and particles
+         * @param ngroups Number of groups in `Space`
+         */
+        Terms &trialConfiguration( const Tkey &k, size_t ngroups )
+        {
+            newTerms.reset(k, ngroups);
+            return newTerms;
+        }
+
+        /**
+         * @brief Terms of the current configuration with known energies filled in
+         * @param k Moved groups and particles
+         * @param ngroups Number of groups in `Space`
+         * @param pairsStored True if `g2All()` of the current configuration is a lookup, see `EnergyMatrix`
+         *
+         * Unknown terms are left as NaN. `g_internal()` is only filled in for
+         * groups with given moved particles, as in `energyChangeTerms()`.
+         */
+        Terms &currentConfiguration( const Tkey &k, size_t ngroups, bool pairsStored )
+        {
+            if ( gext.size() != ngroups )
+            {
+                clear();
+                gext.resize(ngroups, unknown());
+                gint.resize(ngroups, unknown());
+            }
+            Terms &t = oldTerms;
+            t.reset(k, ngroups);
+            cntTerms += 1 + 2 * k.size();
+            if ( pairsStored )
+                cntPairStored++;
+            if ( !std::isnan(ext))
+            {
+                t.external = ext;
+                cntReused++;
+            }
+            for ( auto &m : k )
+            {
+                if ( !std::isnan(gext[m.first]))
+                {
+                    t.gExternal[m.first] = gext[m.first];
+                    cntReused++;
+                }
+                if ( !m.second.empty() && !std::isnan(gint[m.first]))
+                {
+                    t.gInternal[m.first] = gint[m.first];
+                    cntReused++;
+                }
+            }
+            return t;
+        }
+
+        /** @brief Store energies of the moved groups `k` of the current configuration */
+        void store( const Tkey &k, const Terms &t )
+        {
+            ext = t.external;
+            for ( auto &m : k )
+                if ( size_t(m.first) < gext.size() && size_t(m.first) < t.gExternal.size())
+                {
+                    if ( !std::isnan(t.gExternal[m.first]))
+                        gext[m.first] = t.gExternal[m.first];
+                    if ( !std::isnan(t.gInternal[m.first]))
+                        gint[m.first] = t.gInternal[m.first];
+                }
+        }
+
+        /** @brief Store current terms from `currentConfiguration()` and keep those from `trialConfiguration()` until `accept()` */
+        void trial( const Tkey &k )
+        {
+            store(k, oldTerms);
+            trialKey = k;
+            std::swap(trialTerms, newTerms);
+            pending = true;
+        }
+
+        /** @brief Trial configuration has been accepted */
+        template<class Tchange>
+        void accept( const Tchange &c )
+        {
+            if ( !enabled )
+                pending = false;
+            else if ( c.empty() || c.geometryChange || !c.rmGroup.empty() || !c.inGroup.empty())
+                clear(); // unknown or global change
+            else if ( pending && trialKey == c.mvGroup )
+            {
+                invalidate(c.mvGroup);
+                store(trialKey, trialTerms);
+            }
+            else
+                invalidate(c.mvGroup);
+            pending = false;
+        }
+
+        /** @brief Trial configuration has been rejected */
+        void reject() { pending = false; }
+
+        /** @brief Returns true if the current step should be checked against a full recalculation */
+        bool checkNow()
+        {
+            cnt++;
+            return (check > 0 && cnt % check == 0);
+        }
+
+        /**
+         * @brief Compare cached and recalculated energy of the current configuration
+         * @throw std::runtime_error if they differ
+         */
+        void verify( double cached, double exact )
+        {
+            cntChecks++;
+            if ( std::fabs(cached - exact) > 1e-6 * std::max(1.0, std::fabs(exact)))
+            {
+                std::ostringstream o;
+                o << "energy cache out of sync after " << cnt << " steps: cached "
+                  << cached << " kT, recalculated " << exact << " kT";
+                throw std::runtime_error(o.str());
+            }
+        }
+
+        string info( char w = 25 ) const
+        {
+            using namespace textio;
+            std::ostringstream o;
+            if ( enabled )
+            {
+                o << header("Energy cache");
+                if ( cntTerms > 0 )
+                    o << pad(SUB, w, "Reused terms") << 100.0 * cntReused / cntTerms << percent << "\n";
+                if ( cnt > 0 )
+                    o << pad(SUB, w, "Stored pair energies") << 100.0 * cntPairStored / cnt << percent
+                      << (cntPairStored < cnt ? " (wrap pair terms in EnergyMatrix)" : "") << "\n";
+                o << pad(SUB, w, "Checked steps") << cntChecks;
+                if ( check > 0 )
+                    o << " (every " << check << ")";
+                o << "\n";
+            }
+            return o.str();
+        }
+    };
+
+/**
+     * @brief Sum over all pairs of groups using OpenMP threads
+     *
+     * The triangle of group pairs `(i,j)` with `j<i` is split into tiles of
+     * consecutive pairs (row by row) with roughly equal work, estimated as
+     * the product of group sizes. Tiles are evaluated in parallel and their
+     * partial sums are added in tile order. The tiling depends only on the
+     * group sizes and `ntiles` so that the result is the same for any number
+     * of threads. Lazily built data, such as cell lists, must be in place
+     * before the sum, i.e. callers must call `Energybase::prepare()` first.
+     * The tiling is reused as long as the group sizes are unchanged.
+     * With `parallel=false` the tiles are summed by the calling thread only,
+     * which must be used if `f` is not thread safe, see `Energybase::threadSafe()`.
+     *
+     * Example:
+     *
+     * ~~~~
+     * GroupPairSum sum;
+     * pot.prepare(spc.p);
+     * double u = sum(spc.groupList(), [&](int i, int j) { return pot.g2g(spc.p, *g[j], *g[i]); }, pot.threadSafe());
+     * ~~~~
+     *
+     * Other types, such as `PairForceSum`, are summed with `reduce()`.
+     */
+    class GroupPairSum
+    {
+    private:
+        struct Tile
+        {
+            int ifirst, jfirst; // first pair
+            int ilast, jlast;   // end pair (exclusive) in the same or a later row
+        };
+        vector<Tile> tiles;
+        vector<int> sizes;        // group sizes of current tiling
+        vector<double> prefix;    // prefix sums of group weights
+
+        template<class Tgroups>
+        void tile( const Tgroups &g )
+        {
+            size_t n = g.size();
+            bool same = (sizes.size() == n);
+            for ( size_t i = 0; same && i < n; i++ )
+                same = (sizes[i] == g[i]->size());
+            if ( same && !tiles.empty())
+                return;
+
+            sizes.resize(n);
+            prefix.assign(n + 1, 0);
+            for ( size_t i = 0; i < n; i++ )
+            {
+                sizes[i] = g[i]->size();
+                prefix[i + 1] = prefix[i] + sizes[i] + 1; // +1 for per-pair overhead
+            }
+            double total = 0;
+            for ( size_t i = 1; i < n; i++ )
+                total += (sizes[i] + 1) * prefix[i];
+            double target = std::max(1.0, total / std::max(1, ntiles));
+
+            tiles.clear();
+            Tile t = {1, 0, 1, 0};
+            double w = 0;
+            for ( int i = 1; i < int(n); i++ )
+            {
+                int j = (i == t.ifirst) ? t.jfirst : 0;
+                double wi = sizes[i] + 1;
+                while ( j < i )
+                {
+                    double rest = wi * (prefix[i] - prefix[j]);
+                    if ( w + rest < target )
+                    {
+                        w += rest;
+                        break;
+                    }
+                    double need = prefix[j] + (target - w) / wi;
+                    int k = std::lower_bound(prefix.begin() + j + 1, prefix.begin() + i + 1, need) - prefix.begin();
+                    k = std::min(k, i);
+                    t.ilast = i;
+                    t.jlast = k;
+                    tiles.push_back(t);
+                    t = {i, k, i, k};
+                    w = 0;
+                    j = k;
+                }
+            }
+            if ( w > 0 )
+            {
+                t.ilast = int(n) - 1;
+                t.jlast = int(n) - 1;
+                tiles.push_back(t);
+            }
+        }
+
+        template<class T, class Tfunc>
+        static T sum( const Tile &t, Tfunc &f, const T &zero )
+        {
+            T u = zero;
+            for ( int i = t.ifirst; i <= t.ilast; i++ )
+            {
+                int jend = (i == t.ilast) ? t.jlast : i;
+                for ( int j = (i == t.ifirst) ? t.jfirst : 0; j < jend; j++ )
+                    u += f(i, j);
+            }
+            return u;
+        }
+
+    public:
+        int ntiles; //!< Approximate number of tiles
+
+        GroupPairSum( int ntiles = 256 ) : ntiles(ntiles) {}
+
+        /** @brief Sum of `f(i,j)` of type `T`, starting from `zero`, for all group indices `j<i` of `g` */
+        template<class T, class Tgroups, class Tfunc>
+        T reduce( const Tgroups &g, Tfunc f, const T &zero, bool parallel = true )
+        {
+            tile(g);
+            T u = zero;
+            if ( tiles.empty())
+                return u;
+            vector<T> partial(tiles.size(), zero); // sum of each tile
+#pragma omp parallel for schedule (dynamic) if (parallel)
+            for ( int k = 0; k < int(tiles.size()); k++ )
+                partial[k] = sum(tiles[k], f, zero);
+            for ( auto &x : partial )
+                u += x;
+            return u;
+        }
+
+        /** @brief Sum of `f(i,j)` for all group indices `j<i` of `g` (vector of group pointers) */
+        template<class Tgroups, class Tfunc>
+        double operator()( const Tgroups &g, Tfunc f, bool parallel = true ) { return reduce(g, f, 0.0, parallel); }
+    };
+
+/**
+     * @brief Energy, force and virial summed over pairs of particles
+     *
+     * For a pair `a`,`b` with distance vector @f$ \mathbf{r} @f$ = `Geometry::vdist(a,b)`
+     * and force @f$ \mathbf{f} @f$ on `a`, `u` is the pair energy and `virial` the tensor
+     * @f$ \mathbf{r}\otimes\mathbf{f} @f$. Summed over pairs between two groups,
+     * `f` is the total force on the first group. See `Energybase::f_g2g()`.
+     */
+    struct PairForceSum
+    {
+        double u;                //!< Energy (kT)
+        Point f;                 //!< Force (kT/angstrom)
+        Eigen::Matrix3d virial;  //!< Virial tensor (kT)
+
+        PairForceSum() : u(0), f(0, 0, 0) { virial.setZero(); }
+
+        /** @brief Add pair with energy `du`, force `df` on first particle and distance vector `r` */
+        void add( double du, const Point &df, const Point &r )
+        {
+            u += du;
+            f += df;
+            virial += r * df.transpose();
+        }
+
+        PairForceSum &operator+=( const PairForceSum &o )
+        {
+            u += o.u;
+            f += o.f;
+            virial += o.virial;
+            return *this;
+        }
+    };
+
 /**
      *  @brief Base class for energy evaluation
      *
@@ -49,6 +488,14 @@ namespace Faunus
      *  properties. I.e. a derived class for non-bonded interactions are
      *  not expected to implement `i_internal()`, for example.
      *
+     *  Group pairs are summed in parallel by `systemEnergy()` and other
+     *  loops using `GroupPairSum`. Terms that modify themselves while
+     *  evaluating energies, e.g. by filling tables on first use or by
+     *  drawing random numbers, must return false from `threadSafe()`
+     *  and are then summed serially. Data that is built on demand but
+     *  then only read, such as cell lists, is built by `prepare()`
+     *  which is called before such loops.
+     *
      *  @note All energy functions must return energies in units of kT.
      */
     template<class Tspace>
@@ -74,8 +521,11 @@ namespace Faunus
         
         bool isGeometryTrial(typename Tspace::GeometryType &g) const { return (&g==&spc->geo_trial); }
 
+        GroupPairSum pairSum; //!< Parallel sum over group pairs used by `systemEnergy()`
+
     public:
         string name;  //!< Short informative name
+        EnergyCache cache; //!< Current energies reused by `energyChange()`
 
         virtual ~Energybase() {}
 
@@ -154,6 +604,14 @@ namespace Faunus
         virtual double v2v( const Tpvec &, const Tpvec & )       // Particle vector-Particle vector energy
         { return 0; }
 
+        /** @brief Energy, force and virial of all particle pairs between `g1` and `g2`, see `PairForceSum` */
+        virtual PairForceSum f_g2g( const Tpvec &, Group &, Group & )
+        { return PairForceSum(); }
+
+        /** @brief Energy, force and virial of all particle pairs within `g`, see `PairForceSum` */
+        virtual PairForceSum f_g_internal( const Tpvec &, Group & )
+        { return PairForceSum(); }
+
         virtual double external( const Tpvec & )                // External energy - pressure, for example.
         { return 0; }
 
@@ -166,20 +624,61 @@ namespace Faunus
         virtual void field( const Tpvec &, Eigen::MatrixXd & ) //!< Calculate electric field on all particles
         {}
 
+        /**
+         * @brief Build data used when evaluating energies of `p`, e.g. cell lists
+         *
+         * Called before energy functions are called concurrently so that
+         * threads only read such data, see `GroupPairSum`.
+         */
+        virtual void prepare( const Tpvec & ) {}
+
+        /** @brief Total energy; group pairs are summed in parallel if `threadSafe()`, see `GroupPairSum` */
         virtual double systemEnergy( const Tpvec &p )
         {
-            double u_pair = 0.0;
+            auto &g = spc->groupList();
+            prepare(p);
             double u = external(p);
-            for ( auto g : spc->groupList())
-                if (!g->empty())
-                    u += g_external(p, *g) + g_internal(p, *g);
-            for ( auto i = spc->groupList().begin(); i != spc->groupList().end(); ++i )
-                for ( auto j = i; ++j != spc->groupList().end(); )
-                    u_pair += g2g(p, **i, **j);
-            return u + u_pair;
+            for ( auto i : g )
+                if (!i->empty())
+                    u += g_external(p, *i) + g_internal(p, *i);
+            return u + pairSum(g, [&]( int i, int j ) { return g2g(p, *g[j], *g[i]); }, threadSafe());
         }
 
-        virtual double g2All(const Tpvec & p, const std::map<int, vector<int>>& mg)
+        /**
+         * @brief Change of pair energies if all distances in `Space::p` are scaled by `s`
+         *
+         * This covers `g2g()` between all groups and `g_internal()` of atomic
+         * groups, i.e. all but `external()` and `g_external()`, and is used
+         * for volume scaling of atomic groups by `Move::Isobaric` and
+         * `Analysis::VirtualVolumeMove`. NaN means that the change is unknown
+         * and must be calculated from scaled coordinates.
+         */
+        virtual double scaledPairChange( double ) { return std::numeric_limits<double>::quiet_NaN(); }
+
+        /**
+         * @brief True if energies depend on the configuration only and may be kept by `EnergyCache`
+         *
+         * False for terms that change during simulation, or whose group energies
+         * depend on other groups.
+         */
+        virtual bool cacheable() { return true; }
+
+        /**
+         * @brief True if energy functions may be called concurrently from several threads
+         *
+         * False for terms that modify themselves when evaluating energies,
+         * e.g. tables filled on first use or random numbers drawn.
+         */
+        virtual bool threadSafe() { return true; }
+
+        /**
+         * @brief True if pair energies of `Space::p` are stored so that `g2All()` on it is a lookup
+         *
+         * Used by `EnergyCache` to report whether current pair energies are recalculated.
+         */
+        virtual bool storesPairs() { return false; }
+
+        virtual double g2All(const Tpvec & p, const ChangeMap<vector<int>>& mg)
         {
             double du = 0;
             auto &g = spc->groupList();
@@ -214,33 +713,53 @@ namespace Faunus
             return du;
         }
 
+        /** @brief Parameters and results as json object; empty if none. Written by `Analysis::CombinedAnalysis` */
+        virtual Tmjson json() { return Tmjson(); }
+
         inline virtual std::string info()
         {
             assert(!name.empty() && "Energy name cannot be empty");
             if ( _info().empty())
-                return string();
-            return textio::header("Energy: " + name) + _info();
+                return cache.info(w);
+            return textio::header("Energy: " + name) + _info() + cache.info(w);
         }
     };
 
     /**
-     *  \brief Energy matrix - allows acceleration of Metropolis algorithm up to 2x by storing pair-wise enegies
-     *  \param EType - set type for energy storage in energy matrix - e.g. double, float, half_float
+     * @brief Energy matrix - stores group-group energies of the current configuration
+     * @tparam EType Type for energy storage, e.g. `double` or `float`
+     * @tparam Base Energy class to wrap, typically a nonbonded energy
      *
-     *  Usage:
+     * The energies `g2g()` between all pairs of groups in the current
+     * configuration (`Space::p`) are kept in a packed lower triangular
+     * matrix so that `g2g()` and `g2All()` on `Space::p` are lookups. Only
+     * the rows of moved groups are calculated, in the trial configuration.
      *
-     * Energy::EnergyMatrix<double, Tspace, Energy::NonbondedCutg2g<Tspace,Tpairpot> > nonEM(mcp);
+     * Trial energies are written to a second matrix of the same layout and
+     * marked with the current step. When the move is accepted (`update(true)`)
+     * the rows of the groups in the `Space::Change` given to `updateChange()`
+     * are copied to the current matrix; pairs that were not evaluated during
+     * the move are calculated from `Space::p`. If all groups moved, e.g. for
+     * volume moves, the two matrices are swapped. Insertions and deletions
+     * (`Change::inGroup`, `Change::rmGroup`) refresh the affected rows,
+     * while changes in the number of groups and accepted moves without a
+     * `Change` rebuild the matrix. The matrix is built on first use.
+     * Full rebuilds and the completion of swapped matrices loop over all
+     * pairs of groups in parallel, see `GroupPairSum`.
      *
-     * NOTE: Currently only works for rigid many-particle species, i.e. All groups of GroupList needs to be molecular.
+     * Atomic as well as molecular groups are supported. As all stored energies
+     * refer to `Space::p`, particles must only be modified by moves that
+     * describe what they do in `Space::Change`.
      *
+     * Usage:
+     *
+     * ~~~{.cpp}
+     * Energy::EnergyMatrix<double, Tspace, Energy::NonbondedCutg2g<Tspace,Tpairpot> > nonEM(mcp);
+     * ~~~
      */
     template<typename EType, class Tspace, class Base>
       class EnergyMatrix : public Base {
     private:
-        std::vector< std::vector<EType> > eMatrix;                 /// \brief Energy matrix, elements only valid for i > j indexes
-        std::vector< std::vector<EType> > eMatrix2;                /// \brief Energy matrix duplicate, useful for certain move(isobaric for example)
-        std::unordered_map<Group* , unsigned int> groupMap;   /// \brief Mapping unique_Group_ID==KEY to index in Energy matrix, groupMap[group.id] = index in eMatrix
-
         typedef Energy::Energybase<Tspace> SuperBase;
         typedef typename Tspace::ParticleType Tparticle;
         typedef typename Tspace::GeometryType Tgeometry;
@@ -249,395 +768,231 @@ namespace Faunus
         using SuperBase::spc;
         using SuperBase::isTrial;
 
-    public:
-        std::vector<double> changes;    /// \brief Temporarily stored changes to the Energy matrix generated in each trial configuration energy calculation
-
-        bool all = false;       /// \brief true signifies that we need to swap EMs
-        std::map<int, vector<int>> multi; /// \brief !empty() - signifies that we modified a series of particles and its interactions
-        int single = -1;        /// \brief true signifies that we modified a single particle and its interactions
-
-        std::vector< std::vector<EType> >* energyMatrix;       /// \brief We are using eMatrix via a pointer for easy swapping
-        std::vector< std::vector<EType> >* energyMatrixTrial;
+        std::vector<EType> eMatrix[2];     // current and trial energies, element (i,j) with i>j at i(i-1)/2+j
+        int cur;                           // index of current energies in `eMatrix`; swapped for volume moves
+        std::vector<unsigned int> stamp;   // step at which trial element was calculated
+        unsigned int step;                 // current step (incremented by `updateChange()`)
+        size_t ngroups;                    // number of groups in matrix
+        bool valid;                        // matrix in sync with `Space::p`
+        bool recorded;                     // change recorded since last `update()`
+        bool all;                          // all groups changed
+        vector<int> moved;                 // groups changed by current move
+        vector<char> isMoved;              // ...as a mask
+        unsigned long int cntInit;         // number of full matrix calculations
 
-        ///  The simulation starts by systemEnergy() call to set up for drift calculation, this used for EM initiation
-        ///
-        ///
-        ///  @Warning Mikael - This is potentialy problematic since the proper initiation of EM is depended on systemEnergy call outside of this class
-        ///                  - Maybe modify ufunction and add another Init function call to it
-        ///
-        ///
-        bool firstGlobal=true;  /// \brief Used to distinguish first systemEnergy method call for EM initiation
-
-        /**
-         * @brief EnergyMatrix - Constructor, allocates eMatrix and eMatrix2
-         */
-        EnergyMatrix(Tmjson &j) : Base(j)
+        static size_t index( size_t i, size_t j )
         {
-            unsigned int size = 0;
-            energyMatrix = &eMatrix;
-            energyMatrixTrial = &eMatrix2;
-
-            try{
-                changes.reserve(1024 + size);
-
-                energyMatrix->resize( size ); // resize EMs so it has minimal space to properly store all i > j elements
-                for(unsigned int i=0; i < size; i++) {
-                    energyMatrix->operator [](i).resize( i );
-                }
-
-                energyMatrixTrial->resize( size );
-                for(unsigned int i=0; i < size; i++) {
-                    energyMatrixTrial->operator [](i).resize( i );
-                }
-            } catch(std::bad_alloc& bad) {
-                fprintf(stderr, "\nTOPOLOGY ERROR: Could not allocate memory for Energy matrix");
-                exit(1);
-            }
+            if ( i < j )
+                std::swap(i, j);
+            return i * (i - 1) / 2 + j;
         }
 
-        double g2g( const Tpvec &p, Group &g1, Group &g2 )
+        /** @brief Calculate all elements from `Space::p` */
+        void init()
         {
-            if(isTrial(p)) {
-                return Base::g2g(p, g1, g2);
-            } else {
-                if( groupMap[&g1] > groupMap[&g2] )
-                    return (*energyMatrix)[groupMap[&g1]][groupMap[&g2]];
-                else
-                    return (*energyMatrix)[groupMap[&g2]][groupMap[&g1]];
+            auto &g = spc->groupList();
+            ngroups = g.size();
+            size_t n = ngroups * (ngroups - 1) / 2;
+            if ( ngroups == 0 )
+                n = 0;
+            try {
+                eMatrix[0].resize(n);
+                eMatrix[1].resize(n);
+                stamp.assign(n, 0);
+                isMoved.assign(ngroups, 0);
+            } catch(std::bad_alloc&) {
+                throw std::runtime_error("could not allocate memory for energy matrix");
             }
+            auto &m = eMatrix[cur];
+            Base::prepare(spc->p);
+            SuperBase::pairSum(g, [&]( int i, int j ) {
+                return m[index(i, j)] = Base::g2g(spc->p, *g[i], *g[j]);
+            }, Base::threadSafe());
+            step = 1;
+            valid = true;
+            cntInit++;
         }
 
-        double g1g2( const Tpvec &p1, Group &g1, const Tpvec &p2, Group &g2 )
+        /** @brief Make sure that the matrix matches `Space::p`; false if not possible */
+        bool sync()
         {
-            if(isTrial(p1) || isTrial(p2)) {
-                return Base::g1g2(p1, g1, p2, g2);
-            } else {
-                if( groupMap[&g1] > groupMap[&g2] )
-                    return (*energyMatrix)[groupMap[&g1]][groupMap[&g2]];
-                else
-                    return (*energyMatrix)[groupMap[&g2]][groupMap[&g1]];
-            }
-        }
-
-        double init( const Tpvec &p )
-        {
-            cout << "\n...Initiating Energy Matrix...\n" << endl;
-            double u = 0.0;
-
-            resizeEMatrix(spc->molTrack.size());
-            firstGlobal = false;
-
-            // initialize energy matrix
-            if(!energyMatrix->empty()) {
-                auto map = spc->molTrack.getMap();
-
-                initGroupMap();
-
-                //
-                // Equivalent of doing 2 for cycles:
-                //
-                //  for( i=1; i < size; ++i )
-                //      for( j=0; j < i; ++j )
-                //
-                //  4 particles -> 0, 1, 2, 3
-                //  Looping(i,j) : (1,0), (2,0), (2,1), (3,0), (3,1), (3,2)
-                //
-                unsigned int i=1, j=0;
-                for(auto tid_i = map.begin(); tid_i != map.end(); ++tid_i) { // loop over molecule types -> elements of map <KEY = TID, vector<GROUP*>>
-                    for(auto group_i = tid_i->second.begin(); group_i != tid_i->second.end(); ++group_i) { // loop over molecules of tid_i type -> elements of vector<GROUP*>
-                        if(tid_i == map.begin() && group_i == tid_i->second.begin()) // discart first particle due to i > j ordering
-                            ++group_i;
-
-                        for(auto tid_j = map.begin(); tid_j != map.end(); ++tid_j) { // loop over molecule types -> elements of map <KEY = TID, vector<GROUP*>>
-                            // loop over molecules of tid_j type -> elements of vector<GROUP*>, end when END of container or reached group_i
-                            for(auto group_j = tid_j->second.begin(); ( (group_j != tid_j->second.end()) && (group_j != group_i) ); ++group_j) {
-                                assert( i == groupMap[&(**group_i)] );
-                                assert( j == groupMap[&(**group_j)] );
-                                assert(i > j);
-                                (*energyMatrix)[i][j] = Base::g2g(p, **group_i, **group_j );
-                                u += (*energyMatrix)[i][j];
-                                ++j;
-                            }
-                        }
-                        j=0;
-                        ++i;
-                    }
-                }
-            }
-            return u;
+            if ( spc == nullptr )
+                return false;
+            if ( !valid || ngroups != spc->groupList().size())
+                init();
+            return true;
         }
 
-        /**
-         * @brief systemEnergy - Calculate system energy on the basis on Groups
-         *
-         * This implementation assumes the order of groups in EnergyMatrix is identical to the one in GroupList
-         *
-         * @param p
-         * @return
-         */
-        double systemEnergy( const Tpvec &p ) override
+        /** @brief Group index or -1 if not in matrix */
+        int groupIndex( Group &g ) const
         {
-            double u_pair = 0.0;
-            double u = Base::external(p);
-            for ( auto g : spc->groupList())
-                u += Base::g_external(p, *g) + Base::g_internal(p, *g);
-
-            if(firstGlobal) {
-                return u + init(p);
-            }
-
-            if(isTrial(p)) {
-                all = true;
-                if(!energyMatrix->empty()) {
-                    auto map = spc->molTrack.getMap();
-
-                    unsigned int i=1, j=0;
-                    for(auto tid_i = map.begin(); tid_i != map.end(); ++tid_i) { // loop over molecule types -> elements of map <KEY = TID, vector<GROUP*>>
-                        for(auto group_i = tid_i->second.begin(); group_i != tid_i->second.end(); ++group_i) { // loop over molecules of tid_i type -> elements of vector<GROUP*>
-                            if(tid_i == map.begin() && group_i == tid_i->second.begin()) // discart first particle due to i > j ordering
-                                ++group_i;
-
-                            for(auto tid_j = map.begin(); tid_j != map.end(); ++tid_j) { // loop over molecule types -> elements of map <KEY = TID, vector<GROUP*>>
-                                // loop over molecules of tid_j type -> elements of vector<GROUP*>, end when END of container or reached group_i
-                                for(auto group_j = tid_j->second.begin(); ( (group_j != tid_j->second.end()) && (group_j != group_i) ); ++group_j) {
-                                    assert( i == groupMap[&(**group_i)] );
-                                    assert( j == groupMap[&(**group_j)] );
-                                    assert(i > j);
-                                    (*energyMatrix)[i][j] = Base::g2g(p, **group_i, **group_j );
-                                    u_pair += (*energyMatrix)[i][j];
-                                    ++j;
-                                }
-                            }
-                            j=0;
-                            ++i;
-                        }
-                    }
-                }
-            } else {
-                // No need to translate through groupMap, sum all elements
-                assert(energyMatrix->size() == spc->molTrack.size());
-                if(!energyMatrix->empty()) {
-                    for ( unsigned int i = 1; i < energyMatrix->size(); ++i ) {
-                        for ( unsigned int j = 0; j < i; ++j ) {
-                            u_pair += (*energyMatrix)[i][j];
-                            assert( (*energyMatrix)[i][j] == g2g(p, *spc->groupList()[i], *spc->groupList()[j]) );
-                        }
-                    }
-                }
-            }
-
-            assert(fabs( (u_pair+u) - Base::systemEnergy(p) ) < Base::systemEnergy(p)*1e-9 && "EM system energy significantly different from base");
-            return u + u_pair;
+            int i = spc->findIndex(&g);
+            return (i < int(ngroups)) ? i : -1;
         }
 
-        inline double update(bool acc) override {
-            if(acc) {
-                modify();
-            } else {
-                all = false;
-                single = -1;
-                multi.clear();
+        /** @brief Copy trial rows of changed groups to the current matrix */
+        void commit()
+        {
+            auto &g = spc->groupList();
+            if ( !valid || !recorded || ngroups != g.size())
+            {
+                valid = false; // rebuild at next lookup
+                return;
             }
-            return 0.0;
+            if ( all )
+            {
+                auto &m = eMatrix[1 - cur];
+                Base::prepare(spc->p);
+                SuperBase::pairSum(g, [&]( int i, int j ) {
+                    size_t k = index(i, j);
+                    if ( stamp[k] != step )
+                        m[k] = Base::g2g(spc->p, *g[i], *g[j]);
+                    return 0.0;
+                }, Base::threadSafe());
+                cur = 1 - cur;
+                return;
+            }
+            for ( auto i : moved )
+                for ( size_t j = 0; j < ngroups; j++ )
+                    if ( int(j) != i && !(isMoved[j] && int(j) < i)) // each pair only once
+                    {
+                        size_t k = index(i, j);
+                        if ( stamp[k] == step )
+                            eMatrix[cur][k] = eMatrix[1 - cur][k];
+                        else
+                            eMatrix[cur][k] = Base::g2g(spc->p, *g[i], *g[j]);
+                    }
         }
 
+    public:
         /**
-         * @brief g2All Calculate group to group energies between groups of mg (moved groups) and rest of groups
-         *
-         * This implementation assumes the order of groups in EnergyMatrix is identical to the one in GroupList
-         *
-         * @param p
-         * @param mg
-         * @return
+         * @brief EnergyMatrix - Constructor. The matrix is allocated on first use.
          */
-        double g2All(const Tpvec & p, const std::map<int, vector<int>>& mg) override
-        {
-            double du = 0;
-            auto &g = spc->groupList();
-            int count = 0;
-
-            if(isTrial(p)) {
-                changes.resize(g.size() * mg.size());
-                multi = std::map<int, vector<int>>(mg);
-
-                for ( auto &m : mg ) // loop over all moved groups
-                {
-                    size_t i = size_t(m.first);                       // index of moved group
-                    assert(g[i]->isMolecular());
-
-                    // Calculate energy moved <-> static groups
-                    for ( size_t j = 0; j < g.size(); j++ ) {           // loop over through all groups
-                        if ( mg.count(j) == 0 ) {                // If group j is not in mvGroup
-                            changes[count] = g2g(p, *g[i], *g[j]);
-                            du += changes[count];           // moved group<->static groups
-                            ++count;
-                            if ( du == pc::infty )
-                                return pc::infty;   // early rejection
-                        }
-                    }
-                }
+        EnergyMatrix(Tmjson &j) : Base(j), cur(0), step(1), ngroups(0), valid(false), recorded(false),
+                                  all(false), cntInit(0) {}
 
-                // Calculate energy moved <-> moved
-                for ( auto i = mg.begin(); i != mg.end(); i++ )
+        double g2g( const Tpvec &p, Group &g1, Group &g2 ) override
+        {
+            if ( isTrial(p))
+            {
+                double u = Base::g2g(p, g1, g2);
+                if ( valid && ngroups == spc->groupList().size())
                 {
-                    for ( auto j = (++mg.begin()); j != mg.end(); j++ )
-                    {
-                        auto _i = i->first;
-                        auto _j = j->first;
-                        changes[count] = g2g(p, *g[_i], *g[_j]);
-                        du += changes[count];
-                        ++count;
-                        if ( du == pc::infty )
-                            return pc::infty;   // early rejection
-                    }
-                }
-            } else {
-                for ( auto &m : mg ) {
-                    for ( auto &m : mg ) {
-                        size_t i = size_t(m.first);
-                        assert(g[i]->isMolecular());
-
-                        for ( size_t j = 0; j < g.size(); j++ ) {
-                            if ( mg.count(j) == 0 ) {
-                                if(i > j) {
-                                    du += (*energyMatrix)[i][j];
-                                } else {
-                                    du += (*energyMatrix)[j][i];
-                                }
-                            }
-                        }
-                    }
-                    for ( auto i = mg.begin(); i != mg.end(); i++ )
+                    int i = groupIndex(g1), j = groupIndex(g2);
+                    if ( i >= 0 && j >= 0 && i != j )
                     {
-                        for ( auto j = (++mg.begin()); j != mg.end(); j++ ) // Can't use energy matrix for calculation of internal energy (j = i as in the rest of energy implementation)
-                        {
-                            auto _i = i->first;
-                            auto _j = j->first;
-                            if(_i > _j) {
-                                du += (*energyMatrix)[_i][_j];
-                            }
-                            else {
-                                du += (*energyMatrix)[_j][_i];
-                            }
-                        }
+                        size_t k = index(i, j);
+                        eMatrix[1 - cur][k] = u;
+                        stamp[k] = step;
                     }
                 }
+                return u;
             }
-            return du;
-        }
-
-        void resizeEMatrix(unsigned int size) {
-            assert(size >= 0);
-
-            energyMatrix->resize(size);
-            for(unsigned int i=0; i < size; i++) {
-                energyMatrix->at(i).resize( i );
-            }
-
-            energyMatrixTrial->resize(size);
-            for(unsigned int i=0; i < size; i++) {
-                energyMatrixTrial->at(i).resize( i );
+            if ( &p == &spc->p && sync())
+            {
+                int i = groupIndex(g1), j = groupIndex(g2);
+                if ( i >= 0 && j >= 0 && i != j )
+                    return eMatrix[cur][index(i, j)];
             }
+            return Base::g2g(p, g1, g2);
         }
 
-        inline void modify() {
-            if(!multi.empty()) {
-                fixEMatrixMulti(multi);
-                multi.clear();
-                return;
-            }
-            if(single != -1) {
-                fixEMatrixSingle(single);
-                single = -1;
-                return;
-            }
-            if(all) {
-                std::swap(energyMatrix, energyMatrixTrial);
-                all = false;
-                return;
-            }
-            std::cout << "EnergyMatrix::Modify() Error, move not recorded" << std::endl;
+        double g1g2( const Tpvec &p1, Group &g1, const Tpvec &p2, Group &g2 ) override
+        {
+            if ( &p1 == &p2 && !isTrial(p1))
+                return g2g(p1, g1, g2);
+            return Base::g1g2(p1, g1, p2, g2);
         }
 
-    private:
+        bool storesPairs() override { return true; }
+
         /**
-         * @brief initGroupMap - Initialize groupMap
+         * @brief Energy of moved groups with all other groups and with each other
          *
-         * Take the adress of a Group (&Group) and map its position in GroupList
-         *
-         * SystemEnergy and g2All functions depends on the right ordering of Group in groupMap
-         *
-         * e.g. First group mapped to 0, second to 1, ...
+         * On `Space::p` this is a lookup of the moved rows; on the trial
+         * configuration the rows are calculated and stored for `update()`.
          */
-        void initGroupMap()
-        {
-            auto map = spc->molTrack.getMap();
-            int i=0;
-            for(auto g = map.begin(); g != map.end(); ++g) { // initiate mapping
-                for(auto gg = g->second.begin(); gg != g->second.end(); ++gg) {
-                    groupMap.insert( std::make_pair(&(**gg), i) );
-                    ++i;
-                }
-            }
-        }
+        double g2All( const Tpvec &p, const ChangeMap<vector<int>> &mg ) override
+        {
+            if ( isTrial(p) || &p != &spc->p || !sync())
+                return Base::g2All(p, mg);
 
-        void show() {
-            std::cout << "Energy matrix: " << std::endl;
-            for(unsigned int i=1; i<energyMatrix->size(); ++i) {
-                for(unsigned int j=0; j<i; ++j)
-                    std::cout << std::setw(7) << std::setprecision(4) << (*energyMatrix)[i][j] << " ";
-                std::cout << std::endl;
+            double du = 0;
+            auto &g = spc->groupList();
+            auto &m = eMatrix[cur];
+            for ( auto &i : mg )
+            {
+                for ( size_t j = 0; j < ngroups; j++ )    // moved <-> static groups
+                    if ( mg.count(j) == 0 )
+                        du += m[index(i.first, j)];
+                for ( auto j = mg.find(i.first); j != mg.end(); ++j ) // moved <-> moved
+                    if ( j->first != i.first )
+                        du += m[index(i.first, j->first)];
+                    else
+                        du += Base::g2g(p, *g[i.first], *g[i.first]);
             }
+            return du;
         }
 
         /**
-         * @brief fixEMatrixSingle - fix interaction energies when moving a single particle/molecule in Energy matrix
-         * @param target - id of element whose inteactions changed
+         * @brief systemEnergy - Calculate system energy on the basis on Groups
          */
-        void fixEMatrixSingle(unsigned int target) {
-            assert(changes.size() == energyMatrix->size());
-            for(unsigned int i=0; i < target; i++) {
-                energyMatrix->operator [](target)[i] = changes[i];
-            }
-            for(unsigned int i=target+1; i < energyMatrix->size(); i++) {
-                energyMatrix->operator [](i)[target] = changes[i];
-            }
+        double systemEnergy( const Tpvec &p ) override
+        {
+            if ( isTrial(p) || &p != &spc->p || !sync())
+                return Base::systemEnergy(p);
+
+            double u = Base::external(p);
+            for ( auto g : spc->groupList())
+                if (!g->empty())
+                    u += Base::g_external(p, *g) + Base::g_internal(p, *g);
+            double u_pair = 0;
+            for ( auto e : eMatrix[cur] )
+                u_pair += e;
+            return u + u_pair;
         }
 
-        /**
-         * @brief fixEMatrixMultin - fix interaction energies when moving a multiple particles/groups in Energy matrix
-         */
-        void fixEMatrixMulti(std::map<int, vector<int>>& multi) {
-            auto &g = spc->groupList();
-            int count = 0;
-            for ( auto &m : multi )
-            {
-                size_t i = size_t(m.first);
-                for ( size_t j = 0; j < g.size(); j++ ) {
-                    if ( multi.count(j) == 0 ) {
-                        if(i > j)
-                            (*energyMatrix)[i][j] = changes[count];
-                        else
-                            (*energyMatrix)[j][i] = changes[count];
-                        ++count;
-                    }
-                }
+        /** @brief Register groups changed by the current move */
+        double updateChange( const typename Tspace::Change &c ) override
+        {
+            if ( ++step == 0 )
+            {   // wrap-around: forget all stamps
+                std::fill(stamp.begin(), stamp.end(), 0);
+                step = 1;
             }
+            for ( auto i : moved )
+                if ( size_t(i) < isMoved.size())
+                    isMoved[i] = 0;
+            moved.clear();
+            for ( auto &m : c.mvGroup )
+                moved.push_back(m.first);
+            for ( auto &m : c.rmGroup )
+                moved.push_back(m.first);
+            for ( auto &m : c.inGroup )
+                moved.push_back(m.first);
+            std::sort(moved.begin(), moved.end());
+            moved.erase(std::unique(moved.begin(), moved.end()), moved.end());
+            for ( auto i : moved )
+                if ( size_t(i) < isMoved.size())
+                    isMoved[i] = 1;
+                else
+                    valid = false; // new group
+            all = c.geometryChange || moved.size() >= ngroups;
+            recorded = !c.empty();
+            return Base::updateChange(c);
+        }
 
-            for ( auto i = multi.begin(); i != multi.end(); i++ )
-            {
-                for ( auto j = (++multi.begin()); j != multi.end(); j++ )
-                {
-                    auto _i = i->first;
-                    auto _j = j->first;
-                    if(_i > _j)
-                        (*energyMatrix)[_i][_j] = changes[count];
-                    else
-                        (*energyMatrix)[_j][_i] = changes[count];
-                    ++count;
-                }
-            }
+        double update( bool acc ) override
+        {
+            double u = Base::update(acc);
+            if ( acc )
+                commit();
+            recorded = false;
+            return u;
         }
+
+        /** @brief Number of times the full matrix has been calculated */
+        unsigned long int numInit() const { return cntInit; }
     };
 
 /**
@@ -666,7 +1021,9 @@ namespace Faunus
 
         CombinedEnergy( const T1 &a, const T2 &b ) : first(a), second(b) {}
 
-        string info() override { return _info(); }
+        string info() override { return _info() + Tbase::cache.info(); }
+
+        Tmjson json() override { return merge(first.json(), second.json()); }
 
         void setSpace( typename T1::SpaceType &s ) override
         {
@@ -674,6 +1031,12 @@ namespace Faunus
             second.setSpace(s);
             Tbase::setSpace(s);
         }
+
+        void prepare( const Tpvec &p ) override
+        {
+            first.prepare(p);
+            second.prepare(p);
+        }
         
         void setGeometry(typename T1::SpaceType::GeometryType &g) override {
           first.setGeometry(g);
@@ -688,6 +1051,20 @@ namespace Faunus
             return first.f_p2p(a, b) + second.f_p2p(a, b);
         }
 
+        PairForceSum f_g2g( const Tpvec &p, Group &g1, Group &g2 ) override
+        {
+            auto s = first.f_g2g(p, g1, g2);
+            s += second.f_g2g(p, g1, g2);
+            return s;
+        }
+
+        PairForceSum f_g_internal( const Tpvec &p, Group &g ) override
+        {
+            auto s = first.f_g_internal(p, g);
+            s += second.f_g_internal(p, g);
+            return s;
+        }
+
         double all2p( const Tpvec &p, const Tparticle &a ) override { return first.all2p(p, a) + second.all2p(p, a); }
 
         double i2i( const Tpvec &p, int i, int j ) override { return first.i2i(p, i, j) + second.i2i(p, i, j); }
@@ -722,6 +1099,14 @@ namespace Faunus
 
         double external( const Tpvec &p ) override { return first.external(p) + second.external(p); }
 
+        double scaledPairChange( double s ) override { return first.scaledPairChange(s) + second.scaledPairChange(s); }
+
+        bool cacheable() override { return first.cacheable() && second.cacheable(); }
+
+        bool threadSafe() override { return first.threadSafe() && second.threadSafe(); }
+
+        bool storesPairs() override { return first.storesPairs() || second.storesPairs(); }
+
         double update( bool b ) override { return first.update(b) + second.update(b); }
 
         double updateChange( const typename Tspace::Change &c ) override
@@ -777,6 +1162,41 @@ namespace Faunus
      *
      * For a list of implemented potentials, see the `Faunus::Potential`
      * namespace.
+     *
+     * Upon construction the `Tmjson` is searched for the following in
+     * section `energy/nonbonded/`:
+     *
+     * Keyword       |  Description
+     * :------------ |  :------------------------------------
+     * `cutoff_cell` |  Spherical pair cutoff (angstrom) [default: infinity]
+     * `packed`      |  Use vectorised loops over packed particles [default: false]
+     *
+     * If `cutoff_cell` is finite, all pair energies and forces beyond it
+     * are ignored so that forces and virials (`f_p2p`, `f_g2g`,
+     * `f_g_internal`) belong to the same truncated Hamiltonian as the
+     * energies. For geometries derived from `Geometry::Cuboid`,
+     * `i2all`, `i2g`, `all2p`, `g2g`, `g_internal`, `f_g2g` and
+     * `f_g_internal` use a cell list (`Geometry::CellList`) instead of
+     * looping over all particles.
+     * The cell list follows the accepted configuration through
+     * `updateChange()` and `update()` and is rebuilt whenever the
+     * number of particles or the box changes, or after accepted moves
+     * that do not list their particles in `Space::Change`. If too many
+     * particles move in a single step, the loops fall back to O(N^2).
+     *
+     * If `packed` is true and no cutoff is given, the O(N^2) loops run over
+     * the packed copies of `Space::p` and `Space::trial` (`ParticleSoA`)
+     * using the vectorisable `sum()` of the pair potential. This is
+     * available for `Coulomb`, `DebyeHuckel`, `LennardJones`,
+     * `LennardJonesMixed` and combinations thereof in cuboid geometries,
+     * see `Potential::hasPackedSum`. The packed copies are
+     * synchronised by `Move::Movebase` and `Space` and positions must
+     * therefore not be modified directly by the user.
+     *
+     * For `Coulomb`, `LennardJones`, `LennardJonesMixed` and combinations
+     * thereof without cutoff, `scaledPairChange()` gives the energy change
+     * of a volume scaling from the pair energies summed per power of r,
+     * see `Potential::isHomogeneous`. This is used by `Move::Isobaric`.
      */
     template<class Tspace, class Tpairpot>
     class Nonbonded : public Energybase<Tspace>
@@ -789,13 +1209,226 @@ namespace Faunus
         typedef typename Tbase::Tparticle Tparticle;
         typedef typename Tbase::Tpvec Tpvec;
 
+        Geometry::CellList<typename Tspace::GeometryType> cells;
+        double rc2;                // squared pair cutoff
+        bool cellsStale;           // cell list must be rebuilt before use
+        bool cellsTrial;           // moved particles are known so trial vector can be used
+        IndexSet moved;            // particles moved in current trial
+        bool usePacked;            // loop over packed particle vectors
+        vector<double> termSum;    // pair energy of each homogeneous term in `Space::p` (empty if unknown)
+        vector<double> termTrial;  // ...after the scaling given to `scaledPairChange()`
+        Tpvec movedOld;            // particles of `moved` before the trial, kept while `termSum` is known
+        double termVolume;         // volume of `termSum`
+        bool geometryTrial;        // current trial changes the geometry
+
+        typedef std::integral_constant<bool, Potential::hasPackedSum<Tpairpot>::value
+            && std::is_base_of<Geometry::Cuboid, typename Tspace::GeometryType>::value> Tpackable;
+
+        inline double pair( const Tparticle &a, const Tparticle &b )
+        {
+            double r2 = geo.sqdist(a, b);
+            return (r2 < rc2) ? pairpot(a, b, r2) : 0;
+        }
+
+        /**
+         * @brief Determines if neighbour search via cell list can be used
+         * @param p Particle vector to search in
+         * @param n Number of particles that would otherwise be looped over
+         */
+        bool useCells( const Tpvec &p, size_t n )
+        {
+            if ( rc2 == pc::infty || Tbase::spc == nullptr )
+                return false;
+            if ( &p != &Tbase::spc->p )
+                if ( !cellsTrial || &p != &Tbase::spc->trial )
+                    return false;
+            if ( cellsStale || !cells.isValid(geo, p.size()))
+            {
+                if ( !cells.build(geo, Tbase::spc->p, std::sqrt(rc2)))
+                    return false;
+                cellsStale = false;
+            }
+            return n > cells.neighbourEstimate();
+        }
+
+        /** @brief Packed copy of `p` for vectorised loops or `nullptr` if unavailable */
+        const ParticleSoA *packed( const Tpvec &p )
+        {
+            if ( !usePacked || !Tpackable::value || rc2 < pc::infty || Tbase::spc == nullptr )
+                return nullptr;
+            return Tbase::spc->packed(p);
+        }
+
+        /** @brief Energy between `a` and packed particles `[first,last)` */
+        double packedSum( const Tparticle &a, const ParticleSoA &s, int first, int last )
+        {
+            return (first < last) ? packedSum(a, s, first, last, Tpackable()) : 0;
+        }
+
+        double packedSum( const Tparticle &a, const ParticleSoA &s, int first, int last, std::true_type )
+        {
+            static thread_local vector<double> r2packed; // squared distances; one per thread
+            r2packed.resize(s.size());
+            Geometry::sqdistPacked(geo, a, s.x.data(), s.y.data(), s.z.data(), r2packed.data(), first, last);
+            return pairpot.sum(a, s, r2packed.data(), first, last);
+        }
+
+        double packedSum( const Tparticle &, const ParticleSoA &, int, int, std::false_type ) { return 0; }
+
+        /** @brief Pair energy of each homogeneous term summed over all pairs of grouped particles */
+        vector<double> termSums()
+        {
+            auto &p = Tbase::spc->p;
+            vector<int> index;
+            for ( auto g : Tbase::spc->groupList())
+                for ( auto i : *g )
+                    index.push_back(i);
+            size_t n = pairpot.powers().size(), m = index.size();
+            vector<double> rows(n * m, 0);  // sums of each particle with all preceding
+#pragma omp parallel for schedule (dynamic)
+            for ( int k = 1; k < int(m); k++ )
+            {
+                vector<double> u(n);
+                double *row = rows.data() + k * n;
+                auto &a = p[index[k]];
+                for ( int l = 0; l < k; l++ )
+                {
+                    auto &b = p[index[l]];
+                    pairpot.terms(a, b, geo.sqdist(a, b), u.data());
+                    for ( size_t t = 0; t < n; t++ )
+                        row[t] += u[t];
+                }
+            }
+            vector<double> sum(n, 0);
+            for ( size_t k = 0; k < m; k++ )
+                for ( size_t t = 0; t < n; t++ )
+                    sum[t] += rows[k * n + t];
+            return sum;
+        }
+
+        double scaledPairChange( double s, std::true_type )
+        {
+            if ( rc2 < pc::infty || Tbase::spc == nullptr )
+                return std::numeric_limits<double>::quiet_NaN();
+            if ( termSum.empty() || std::fabs(geo.getVolume() - termVolume) > 1e-9 * termVolume )
+            {
+                termSum = termSums();
+                termVolume = geo.getVolume();
+            }
+            auto n = pairpot.powers();
+            double du = 0;
+            termTrial.resize(n.size());
+            for ( size_t k = 0; k < n.size(); k++ )
+            {
+                termTrial[k] = termSum[k] * std::pow(s, -n[k]);
+                du += termTrial[k] - termSum[k];
+            }
+            return du;
+        }
+
+        double scaledPairChange( double, std::false_type ) { return std::numeric_limits<double>::quiet_NaN(); }
+
+        /**
+         * @brief Update `termSum` for the accepted move of `moved` from `movedOld`
+         *
+         * Pair terms of the moved particles with all other grouped particles
+         * and with each other are subtracted for the old positions and added
+         * for the new ones in `Space::p`.
+         */
+        void addMovedTerms( std::true_type )
+        {
+            auto &p = Tbase::spc->p;
+            size_t n = termSum.size();
+            vector<double> u(n);
+            auto add = [&]( const Tparticle &a, const Tparticle &b, double sign ) {
+                pairpot.terms(a, b, geo.sqdist(a, b), u.data());
+                for ( size_t t = 0; t < n; t++ )
+                    termSum[t] += sign * u[t];
+            };
+            auto mv = moved.begin();
+            for ( size_t k = 0; k < moved.size(); k++ )
+            {
+                auto &anew = p[mv[k]];
+                auto &aold = movedOld[k];
+                for ( auto g : Tbase::spc->groupList())
+                    for ( auto j : *g )
+                        if ( !moved.count(j))
+                        {
+                            add(anew, p[j], 1);
+                            add(aold, p[j], -1);
+                        }
+                for ( size_t l = 0; l < k; l++ )
+                {
+                    add(anew, p[mv[l]], 1);
+                    add(aold, movedOld[l], -1);
+                }
+            }
+        }
+
+        void addMovedTerms( std::false_type ) { termSum.clear(); }
+
+        /** @brief Add energy, force and virial of pair `a`,`b` within the cutoff to `s` */
+        inline void forcePair( const Tparticle &a, const Tparticle &b, PairForceSum &s )
+        {
+            Point r = geo.vdist(a, b), f;
+            double r2 = r.squaredNorm();
+            if ( r2 < rc2 )
+            {
+                double u = Potential::energyForce(pairpot, a, b, r2, r, f);
+                s.add(u, f, r);
+            }
+        }
+
+        /**
+         * @brief Sum of `row(i,s)` for all `i` in `[first,last)`
+         *
+         * Rows are split into a fixed number of interleaved blocks which,
+         * for many rows, are summed in parallel and then added in block
+         * order so that the result is independent of the number of threads.
+         */
+        template<class Tfunc>
+        PairForceSum forceRows( int first, int last, Tfunc row )
+        {
+            const int nblocks = (last - first > 64) ? 64 : 1;
+            vector<PairForceSum> partial(nblocks);
+#pragma omp parallel for schedule (dynamic) if (nblocks > 1 && threadSafe())
+            for ( int k = 0; k < nblocks; k++ )
+                for ( int i = first + k; i < last; i += nblocks )
+                    row(i, partial[k]);
+            PairForceSum s;
+            for ( auto &x : partial )
+                s += x;
+            return s;
+        }
+
+        /**
+         * @brief Call `f(j)` for all particles close to position `a` in `p`
+         *
+         * Particles moved in the current trial are indexed by their old
+         * position and are therefore visited separately when `p` is the
+         * trial vector.
+         */
+        template<class Tfunc>
+        void forEachNeighbour( const Tpvec &p, const Point &a, Tfunc f ) const
+        {
+            if ( &p == &Tbase::spc->trial )
+            {
+                cells.forEach(a, [&]( int j ) { if ( !moved.count(j)) f(j); });
+                for ( auto j : moved )
+                    f(j);
+            }
+            else
+                cells.forEach(a, f);
+        }
+
     public:
         typename Tspace::GeometryType geo;
         Tpairpot pairpot;
 
         Nonbonded(
             Tmjson &j,
-            const string &sec = "nonbonded" ) : pairpot(j["energy"][sec])
+            const string &sec = "nonbonded" ) : cellsStale(true), cellsTrial(false), termVolume(0),
+                                                geometryTrial(false), pairpot(j["energy"][sec])
         {
 
             assert(!j["energy"][sec].is_null());
@@ -803,7 +1436,13 @@ namespace Faunus
             static_assert(
                 std::is_base_of<Potential::PairPotentialBase, Tpairpot>::value,
                 "Tpairpot must be a pair potential");
+            rc2 = pow(j["energy"][sec]["cutoff_cell"] | pc::infty, 2);
+            usePacked = j["energy"][sec].value("packed", false);
             Tbase::name = "Nonbonded N" + textio::squared + " - " + pairpot.name;
+            if ( rc2 < pc::infty )
+                Tbase::name += " (cell cut=" + std::to_string(sqrt(rc2)) + textio::_angstrom + ")";
+            else if ( usePacked && Tpackable::value )
+                Tbase::name += " (packed)";
         }
 
         auto tuple() -> decltype(std::make_tuple(this))
@@ -811,37 +1450,176 @@ namespace Faunus
             return std::make_tuple(this);
         }
 
+        /**
+         * @brief Set space and geometry
+         *
+         * Summed terms of `scaledPairChange()` are kept if only the geometry
+         * of the same space changes, as done by `Move::Isobaric` to evaluate
+         * the trial volume, and forgotten for a new space.
+         */
         void setSpace( Tspace &s ) override
         {
+            if ( &s != Tbase::spc )
+            {
+                termSum.clear();
+                termTrial.clear();
+            }
             geo = s.geo;
             Tbase::setSpace(s);
             pairpot.setSpace(s);
+            cellsStale = true;
+            if ( usePacked )
+                s.syncPacked();
+        }
+
+        /** @brief Build the cell list and packed particle vectors used for `p` */
+        void prepare( const Tpvec &p ) override
+        {
+            useCells(p, 0);
+            packed(p);
+        }
+
+        /**
+         * @brief Register particles moved in the coming trial
+         *
+         * The cell list is used on the trial vector only if `c` lists the
+         * moved particles. Moves that do not fill in `Space::Change`
+         * leave `c` empty and are evaluated without cell list. If the
+         * summed terms of `scaledPairChange()` are known, the old moved
+         * particles are kept so that `update()` can correct the sums.
+         */
+        double updateChange( const typename Tspace::Change &c ) override
+        {
+            geometryTrial = c.geometryChange;
+            termTrial.clear();
+            moved.clear();
+            movedOld.clear();
+            cellsTrial = false;
+            if ( Tbase::spc == nullptr || (rc2 == pc::infty && termSum.empty()))
+                return 0;
+            if ( c.geometryChange || std::fabs(c.dV) > 1e-9 || !c.rmGroup.empty() || !c.inGroup.empty())
+                return 0;
+            c.movedIndex(Tbase::spc->groupList(), moved);
+            if ( rc2 < pc::infty )
+                cellsTrial = !moved.empty() && moved.size() < Tbase::spc->p.size() / 4 + 1;
+            if ( !termSum.empty())
+                for ( auto i : moved )
+                    movedOld.push_back(Tbase::spc->p[i]);
+            return 0;
+        }
+
+        /**
+         * @brief Move particles in cell list upon acceptance
+         *
+         * If the accepted move was not described via `updateChange()`
+         * the cell list is rebuilt before next use. Summed terms of
+         * `scaledPairChange()` are replaced by the scaled ones if the
+         * accepted move was the evaluated scaling, corrected for the
+         * moved particles if these were registered, and forgotten
+         * otherwise.
+         */
+        double update( bool acc ) override
+        {
+            if ( acc )
+            {
+                if ( geometryTrial && !termTrial.empty())
+                {
+                    termSum.swap(termTrial);
+                    termVolume = geo.getVolume();
+                }
+                else if ( !movedOld.empty())
+                    addMovedTerms(std::integral_constant<bool, Potential::isHomogeneous<Tpairpot>::value>());
+                else
+                    termSum.clear();
+            }
+            termTrial.clear();
+            movedOld.clear();
+            geometryTrial = false;
+            if ( acc && !cells.empty())
+            {
+                if ( cellsTrial && cells.size() == Tbase::spc->p.size())
+                    for ( auto i : moved )
+                        cells.update(i, Tbase::spc->p[i]);
+                else
+                    cellsStale = true;
+            }
+            moved.clear();
+            cellsTrial = false;
+            return 0;
         }
 
         //!< Particle-particle energy (kT)
         inline double p2p( const Tparticle &a, const Tparticle &b ) override
         {
-            return pairpot(a, b, geo.sqdist(a, b));
+            return pair(a, b);
         }
 
-        //!< Particle-particle force (kT/Angstrom)
+        //!< Particle-particle force (kT/Angstrom); zero beyond the cutoff
         inline Point f_p2p( const Tparticle &a, const Tparticle &b ) override
         {
             auto r = geo.vdist(a, b);
-            return pairpot.force(a, b, r.squaredNorm(), r);
+            double r2 = r.squaredNorm();
+            return (r2 < rc2) ? pairpot.force(a, b, r2, r) : Point(0, 0, 0);
+        }
+
+        /**
+         * @brief Energy, force and virial between groups from `Potential::energyForce()`
+         *
+         * Pairs beyond the cutoff are ignored and, if possible, found via the
+         * cell list so that `u` equals `g2g()`.
+         */
+        PairForceSum f_g2g( const Tpvec &p, Group &g1, Group &g2 ) override
+        {
+            if ( g1.empty() || g2.empty())
+                return PairForceSum();
+            int jfirst = g2.front(), jlast = g2.back();
+            if ( useCells(p, g2.size()))
+                return forceRows(g1.front(), g1.back() + 1, [&]( int i, PairForceSum &s ) {
+                    forEachNeighbour(p, p[i], [&]( int j ) {
+                        if ( j >= jfirst && j <= jlast )
+                            forcePair(p[i], p[j], s);
+                    });
+                });
+            return forceRows(g1.front(), g1.back() + 1, [&]( int i, PairForceSum &s ) {
+                for ( int j = jfirst; j <= jlast; j++ )
+                    forcePair(p[i], p[j], s);
+            });
+        }
+
+        PairForceSum f_g_internal( const Tpvec &p, Group &g ) override
+        {
+            if ( g.empty())
+                return PairForceSum();
+            int last = g.back();
+            if ( useCells(p, g.size()))
+                return forceRows(g.front(), last, [&]( int i, PairForceSum &s ) {
+                    forEachNeighbour(p, p[i], [&]( int j ) {
+                        if ( j > i && j <= last )
+                            forcePair(p[i], p[j], s);
+                    });
+                });
+            return forceRows(g.front(), last, [&]( int i, PairForceSum &s ) {
+                for ( int j = i + 1; j <= last; j++ )
+                    forcePair(p[i], p[j], s);
+            });
         }
 
         double all2p( const Tpvec &p, const Tparticle &a ) override
         {
             double u = 0;
-            for ( auto &b : p )
-                u += pairpot(a, b, geo.sqdist(a, b));
+            if ( useCells(p, p.size()))
+                forEachNeighbour(p, a, [&]( int j ) { u += pair(a, p[j]); });
+            else if ( auto s = packed(p))
+                u = packedSum(a, *s, 0, p.size());
+            else
+                for ( auto &b : p )
+                    u += pair(a, b);
             return u;
         }
 
         double i2i( const Tpvec &p, int i, int j ) override
         {
-            return pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+            return pair(p[i], p[j]);
         }
 
         double i2g( const Tpvec &p, Group &g, int j ) override
@@ -850,16 +1628,28 @@ namespace Faunus
             if ( !g.empty())
             {
                 int len = g.back() + 1;
-                if ( g.find(j))
+                if ( useCells(p, g.size()))
+                    forEachNeighbour(p, p[j], [&]( int i ) {
+                        if ( i != j && i >= g.front() && i < len )
+                            u += pair(p[i], p[j]);
+                    });
+                else if ( auto s = packed(p))
+                {
+                    if ( g.find(j))
+                        u = packedSum(p[j], *s, g.front(), j) + packedSum(p[j], *s, j + 1, len);
+                    else
+                        u = packedSum(p[j], *s, g.front(), len);
+                }
+                else if ( g.find(j))
                 {   //j is inside g - avoid self interaction
                     for ( int i = g.front(); i < j; i++ )
-                        u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                        u += pair(p[i], p[j]);
                     for ( int i = j + 1; i < len; i++ )
-                        u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                        u += pair(p[i], p[j]);
                 }
                 else              //simple - j not in g
                     for ( int i = g.front(); i < len; i++ )
-                        u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                        u += pair(p[i], p[j]);
             }
             return u;
         }
@@ -869,10 +1659,17 @@ namespace Faunus
             assert(i >= 0 && i < int(p.size()) && "index i outside particle vector");
             double u = 0;
             int n = (int) p.size();
+            if ( useCells(p, p.size()))
+            {
+                forEachNeighbour(p, p[i], [&]( int j ) { if ( j != i ) u += pair(p[i], p[j]); });
+                return u;
+            }
+            if ( auto s = packed(p))
+                return packedSum(p[i], *s, 0, i) + packedSum(p[i], *s, i + 1, n);
             for ( int j = 0; j != i; ++j )
-                u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                u += pair(p[i], p[j]);
             for ( int j = i + 1; j < n; ++j )
-                u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                u += pair(p[i], p[j]);
             return u;
         }
 
@@ -889,10 +1686,10 @@ namespace Faunus
                             assert(g1.size() >= g2.size());
                             for ( int i = g1.front(); i < g2.front(); i++ )
                                 for ( auto j : g2 )
-                                    u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                                    u += pair(p[i], p[j]);
                             for ( int i = g2.back() + 1; i <= g1.back(); i++ )
                                 for ( auto j : g2 )
-                                    u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                                    u += pair(p[i], p[j]);
                             return u;
                         }
                     if ( g2.find(g1.front()))
@@ -901,19 +1698,39 @@ namespace Faunus
                             assert(g2.size() >= g1.size());
                             for ( int i = g2.front(); i < g1.front(); i++ )
                                 for ( auto j : g1 )
-                                    u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                                    u += pair(p[i], p[j]);
                             for ( int i = g1.back() + 1; i <= g2.back(); i++ )
                                 for ( auto j : g1 )
-                                    u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                                    u += pair(p[i], p[j]);
                             return u;
                         }
 
                     // IN CASE BOTH GROUPS ARE INDEPENDENT (DEFAULT)
+                    if ( useCells(p, std::max(g1.size(), g2.size())))
+                    {   // loop over smallest group and search larger group via cells
+                        Group &a = (g1.size() < g2.size()) ? g1 : g2;
+                        Group &b = (g1.size() < g2.size()) ? g2 : g1;
+                        int bfirst = b.front(), blast = b.back();
+                        for ( auto i : a )
+                            forEachNeighbour(p, p[i], [&]( int j ) {
+                                if ( j >= bfirst && j <= blast )
+                                    u += pair(p[i], p[j]);
+                            });
+                        return u;
+                    }
+                    if ( auto s = packed(p))
+                    {   // loop over smallest group and vectorise over larger group
+                        Group &a = (g1.size() < g2.size()) ? g1 : g2;
+                        Group &b = (g1.size() < g2.size()) ? g2 : g1;
+                        for ( auto i : a )
+                            u += packedSum(p[i], *s, b.front(), b.back() + 1);
+                        return u;
+                    }
                     int ilen = g1.back() + 1, jlen = g2.back() + 1;
 #pragma omp parallel for reduction (+:u)
                     for ( int i = g1.front(); i < ilen; ++i )
                         for ( int j = g2.front(); j < jlen; ++j )
-                            u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+                            u += pair(p[i], p[j]);
                 }
             return u;
         }
@@ -923,7 +1740,7 @@ namespace Faunus
             double u = 0;
             for ( auto i : g1 )
                 for ( auto j : g2 )
-                    u += pairpot(p1[i], p2[j], geo.sqdist(p1[i], p2[j]));
+                    u += pair(p1[i], p2[j]);
             return u;
         }
 
@@ -933,21 +1750,52 @@ namespace Faunus
             double u = 0;
             int b = g.back(), f = g.front();
             if ( !g.empty())
-                for ( int i = f; i < b; ++i )
-                    for ( int j = i + 1; j <= b; ++j )
-                        u += pairpot(p[i], p[j], geo.sqdist(p[i], p[j]));
+            {
+                if ( useCells(p, g.size()))
+                    for ( int i = f; i <= b; ++i )
+                        forEachNeighbour(p, p[i], [&]( int j ) {
+                            if ( j > i && j <= b )
+                                u += pair(p[i], p[j]);
+                        });
+                else if ( auto s = packed(p))
+                    for ( int i = f; i < b; ++i )
+                        u += packedSum(p[i], *s, i + 1, b + 1);
+                else
+                    for ( int i = f; i < b; ++i )
+                        for ( int j = i + 1; j <= b; ++j )
+                            u += pair(p[i], p[j]);
+            }
 	    u += pairpot.internal(p,g);
             return u;
         }
 
+        /** @brief Energy between two particle vectors; uses cell list or packed loops if `p2` is `Space::p` */
         double v2v( const Tpvec &p1, const Tpvec &p2 ) override
         {
             double u = 0;
             for ( auto &i : p1 )
-                for ( auto &j : p2 )
-                    u += p2p(i, j);
+                u += all2p(p2, i);
             return u;
         }
+
+        /**
+         * @brief Pair energy change for isotropic scaling of all distances by `s`
+         *
+         * Available for homogeneous pair potentials without cutoff, see
+         * `Potential::isHomogeneous`. The summed terms of `Space::p` are
+         * calculated on first use and kept across accepted scalings
+         * evaluated here and accepted moves that list their particles in
+         * `Space::Change`, see `update()`.
+         */
+        double scaledPairChange( double s ) override
+        {
+            return scaledPairChange(s, std::integral_constant<bool, Potential::isHomogeneous<Tpairpot>::value>());
+        }
+
+        /** @brief True if the summed terms of `scaledPairChange()` are known */
+        bool hasScaledSums() const { return !termSum.empty(); }
+
+        bool threadSafe() override { return Potential::isThreadSafe<Tpairpot>::value; }
     };
 
 /**
@@ -1004,6 +1852,8 @@ namespace Faunus
             return pairpot(p[i], p[j], geo.sqdist(p[i], p[j])) * excl(i, j);
         }
 
+        double scaledPairChange( double ) override { return std::numeric_limits<double>::quiet_NaN(); }
+
         double i2g( const Tpvec &p, Group &g, int j ) override
         {
             double u = 0;
@@ -1108,6 +1958,30 @@ namespace Faunus
             return pairpot.force(a, b, geo.sqdist(a, b), geo.vdist(a, b));
         }
 
+        PairForceSum f_g2g( const Tpvec &p, Group &g1, Group &g2 ) override
+        {
+            PairForceSum s;
+            for ( auto i : g1 )
+                for ( auto j : g2 )
+                {
+                    auto r = geo.vdist(p[i], p[j]);
+                    s.add(pairpot(p[i], p[j], r), pairpot.force(p[i], p[j], r.squaredNorm(), r), r);
+                }
+            return s;
+        }
+
+        PairForceSum f_g_internal( const Tpvec &p, Group &g ) override
+        {
+            PairForceSum s;
+            for ( int i = g.front(); i < g.back(); i++ )
+                for ( int j = i + 1; j <= g.back(); j++ )
+                {
+                    auto r = geo.vdist(p[i], p[j]);
+                    s.add(pairpot(p[i], p[j], r), pairpot.force(p[i], p[j], r.squaredNorm(), r), r);
+                }
+            return s;
+        }
+
         double all2p( const Tpvec &p, const Tparticle &a ) override
         {
             double u = 0;
@@ -1501,6 +2375,14 @@ namespace Faunus
      * Takes care of bonded interactions and can handle mixed bond types. If you create bond BETWEEN
      * groups, make sure to set the `CrossGroupBonds` to `true`.
      *
+     * Bonds are stored in a list where each bond is tagged with its
+     * potential type. Harmonic and FENE bonds are evaluated directly
+     * while other pair potentials are wrapped in a function object.
+     * The bonds of each particle are found via a compressed sparse row
+     * (CSR) table so that `i2all()`, `i2g()` and `g_internal()` visit
+     * only the bonded neighbours. The table is rebuilt on first use
+     * after bonds have been added.
+     *
      * Example:
      *
      *     vector<particle> p(...);            // particle vector
@@ -1508,29 +2390,46 @@ namespace Faunus
      *     Energy::Bonded b;
      *     b.add(i, j, Potential::Harmonic(0.1,5.0) );
      *     std::cout << b.info();
-     *     double rij2 = ... ;                 // squared distance between i and j
-     *     double u = b(i,j)( p[i], p[j], rij2 ); // i j bond energy in kT
+     *     double u = b.i2i(p, i, j);          // i j bond energy in kT
      *
      * @date Lund, 2011-2012
      */
     template<class Tspace>
-    class Bonded : public Energybase<Tspace>,
-                   protected pair_list<std::function<
-                       double( const typename Tspace::ParticleType &,
-                               const typename Tspace::ParticleType &, double )> >
+    class Bonded : public Energybase<Tspace>
     {
     private:
         typedef typename Energybase<Tspace>::Tparticle Tparticle;
         typedef typename Energybase<Tspace>::Tpvec Tpvec;
 
-        typedef pair_list <std::function<
-            double( const Tparticle &, const Tparticle &, double )>> Tbase;
+        typedef std::function<
+            double( const Tparticle &, const Tparticle &, double )> Tfunc;
 
         typedef std::function<
             Point( const Tparticle &, const Tparticle &, double, const Point & )> Tforce;
 
+    public:
+        enum class Type : char { HARMONIC, FENE, FUNCTION }; //!< Bond potential type
+
+        /** @brief Bond between two particles */
+        struct Bond
+        {
+            int i, j;  //!< Particle index
+            Type type; //!< Potential type
+            int k;     //!< Index of potential among bonds of same type
+        };
+
+    private:
         using Energybase<Tspace>::spc;
-        std::map<typename Tbase::Tpair, Tforce> force_list;
+
+        std::vector<Bond> bonds;                    // all bonds
+        std::map<opair<int>, int> lookup;           // bond index for particle pairs (used when adding bonds)
+        std::vector<Potential::Harmonic> harmonic;  // parameters of harmonic bonds
+        std::vector<Potential::FENE> fene;          // parameters of FENE bonds
+        std::vector<Tfunc> func;                    // other bond potentials
+        std::vector<Tforce> force;                  // ...and their forces
+        std::vector<int> offset;                    // CSR: bonds of i'th particle in [offset[i],offset[i+1])
+        std::vector<int> adj;                       // CSR: bond index
+        bool stale;                                 // CSR table must be rebuilt
 
         string _infolist;
 
@@ -1560,10 +2459,99 @@ namespace Faunus
             }
         };
 
+        /** @brief Rebuild CSR table from bond list */
+        void build()
+        {
+            int n = 0;
+            for ( auto &b : bonds )
+                n = std::max(n, std::max(b.i, b.j) + 1);
+            offset.assign(n + 1, 0);
+            for ( auto &b : bonds )
+            {
+                offset[b.i + 1]++;
+                offset[b.j + 1]++;
+            }
+            for ( int i = 0; i < n; i++ )
+                offset[i + 1] += offset[i];
+            adj.resize(offset[n]);
+            vector<int> pos(offset.begin(), offset.end() - 1);
+            for ( size_t k = 0; k < bonds.size(); k++ )
+            {
+                adj[pos[bonds[k].i]++] = k;
+                adj[pos[bonds[k].j]++] = k;
+            }
+            stale = false;
+        }
+
+        /** @brief Call `f(bond)` for all bonds of i'th particle */
+        template<class Tfunction>
+        void forEachBond( int i, Tfunction f )
+        {
+            if ( stale )
+                build();
+            if ( i >= 0 && i + 1 < (int) offset.size())
+                for ( int n = offset[i]; n < offset[i + 1]; n++ )
+                    f(bonds[adj[n]]);
+        }
+
+        /** @brief Energy of bond between `a` and `b` */
+        inline double energy( const Bond &bond, const Tparticle &a, const Tparticle &b )
+        {
+            double r2 = spc->geo.sqdist(a, b);
+            switch ( bond.type )
+            {
+                case Type::HARMONIC:
+                    return harmonic[bond.k](a, b, r2);
+                case Type::FENE:
+                    return fene[bond.k](a, b, r2);
+                default:
+                    return func[bond.k](a, b, r2);
+            }
+        }
+
+        /** @brief Force on `a` from bond with `b` */
+        inline Point bondForce( const Bond &bond, const Tparticle &a, const Tparticle &b )
+        {
+            auto r = spc->geo.vdist(a, b);
+            double r2 = r.squaredNorm();
+            switch ( bond.type )
+            {
+                case Type::HARMONIC:
+                    return harmonic[bond.k].force(a, b, r2, r);
+                case Type::FENE:
+                    return fene[bond.k].force(a, b, r2, r);
+                default:
+                    return force[bond.k](a, b, r2, r);
+            }
+        }
+
+        /** @brief Register bond, replacing any existing bond between `i` and `j` */
+        void addBond( int i, int j, Type type, int k )
+        {
+            assert(i >= 0 && j >= 0 && i != j);
+            auto it = lookup.find(opair<int>(i, j));
+            if ( it != lookup.end()) // replace existing bond
+                bonds[it->second] = {i, j, type, k};
+            else
+            {
+                lookup[opair<int>(i, j)] = bonds.size();
+                bonds.push_back({i, j, type, k});
+            }
+            stale = true;
+        }
+
+        void addInfo( int i, int j, const string &brief )
+        {
+            std::ostringstream o;
+            o << textio::indent(textio::SUBSUB) << std::left << setw(7) << i
+              << setw(7) << j << brief + "\n";
+            _infolist += o.str();
+        }
+
     public:
         bool CrossGroupBonds; //!< Set to true if bonds cross groups (slower!). Default: false
 
-        Bonded()
+        Bonded() : stale(false)
         {
             this->name = "Bonded particles";
             CrossGroupBonds = false;
@@ -1571,33 +2559,60 @@ namespace Faunus
 
         ~Bonded()
         {
-            if ( !Tbase::list.empty())
-                IO::writeFile("bondlist.tcl", VMDBonds(Tbase::list));
+            if ( !lookup.empty())
+                IO::writeFile("bondlist.tcl", VMDBonds(lookup));
         }
 
         void setSpace( Tspace &s ) override
         {
             Energybase<Tspace>::setSpace(s);
-            if ( Tbase::mlist.empty())
+            if ( bonds.empty())
                 add(spc->groupList()); // search for bonds
         }
 
+        /** @brief Rebuild the bond table if bonds have been added */
+        void prepare( const typename Energybase<Tspace>::Tpvec & ) override
+        {
+            if ( stale )
+                build();
+        }
+
+        /** @brief Bond table is rebuilt on first use after `add()`, see `prepare()` */
+        bool threadSafe() override { return !stale; }
+
         auto tuple() -> decltype(std::make_tuple(this))
         {
             return std::make_tuple(this);
         }
 
-        /**
-             * @brief Bond energy i with j
-             * @todo Optimize by using iterator directly as returned by find.
-             */
+        /** @brief Bond energy i with j */
         double i2i( const Tpvec &p, int i, int j ) override
         {
             assert(i != j);
-            auto f = this->list.find(opair<int>(i, j));
-            if ( f != this->list.end())
-                return f->second(p[i], p[j], spc->geo.sqdist(p[i], p[j]));
-            return 0;
+            double u = 0;
+            forEachBond(i, [&]( const Bond &b ) {
+                if ( b.i == j || b.j == j )
+                    u += energy(b, p[i], p[j]);
+            });
+            return u;
+        }
+
+        /**
+             * @brief Bonds between i'th particle and group
+             *
+             * Bonds with a group not containing `i` are included only
+             * if `CrossGroupBonds=true`, consistent with `g2g()`.
+             */
+        double i2g( const Tpvec &p, Group &g, int i ) override
+        {
+            double u = 0;
+            if ( CrossGroupBonds || g.find(i))
+                forEachBond(i, [&]( const Bond &b ) {
+                    int j = b.i + b.j - i; // partner index
+                    if ( g.find(j))
+                        u += energy(b, p[i], p[j]);
+                });
+            return u;
         }
 
         /**
@@ -1610,13 +2625,38 @@ namespace Faunus
             int j = spc->findIndex(b);
             assert(i >= 0 && j >= 0);
             assert(i < (int) spc->p.size() && j < (int) spc->p.size());
-            auto f = force_list.find(opair<int>(i, j));
-            if ( f != this->force_list.end())
-            {
-                auto r = spc->geo.vdist(a, b);
-                return f->second(a, b, r.squaredNorm(), r);
-            }
-            return Point(0, 0, 0);
+            Point f(0, 0, 0);
+            forEachBond(i, [&]( const Bond &bond ) {
+                if ( bond.i == j || bond.j == j )
+                    f += bondForce(bond, a, b);
+            });
+            return f;
+        }
+
+        /** @brief Energy, force and virial of bonds between `g1` and `g2` */
+        PairForceSum f_g2g( const Tpvec &p, Group &g1, Group &g2 ) override
+        {
+            PairForceSum s;
+            for ( auto i : g1 )
+                forEachBond(i, [&]( const Bond &b ) {
+                    int j = b.i + b.j - i; // partner index
+                    if ( g2.find(j))
+                        s.add(energy(b, p[i], p[j]), bondForce(b, p[i], p[j]), spc->geo.vdist(p[i], p[j]));
+                });
+            return s;
+        }
+
+        /** @brief Energy, force and virial of bonds within `g` */
+        PairForceSum f_g_internal( const Tpvec &p, Group &g ) override
+        {
+            PairForceSum s;
+            for ( auto i : g )
+                forEachBond(i, [&]( const Bond &b ) {
+                    int j = b.i + b.j - i;
+                    if ( j > i && g.find(j))
+                        s.add(energy(b, p[i], p[j]), bondForce(b, p[i], p[j]), spc->geo.vdist(p[i], p[j]));
+                });
+            return s;
         }
 
         //!< All bonds w. i'th particle
@@ -1624,53 +2664,40 @@ namespace Faunus
         {
             assert(i >= 0 && i < (int) p.size()); //debug
             double u = 0;
-            auto eqr = this->mlist.equal_range(i);
-            for ( auto it = eqr.first; it != eqr.second; ++it )
-            {
-                int j = it->second; // partner index
-                u += this->list[opair<int>(i, j)](
-                    p[i], p[j], spc->geo.sqdist(p[i], p[j]));
-            }
+            forEachBond(i, [&]( const Bond &b ) {
+                int j = b.i + b.j - i; // partner index
+                u += energy(b, p[i], p[j]);
+            });
             return u;
         }
 
         double total( const Tpvec &p )
         {
             double u = 0;
-            for ( auto &m : Tbase::list )
+            for ( auto &b : bonds )
             {
-                int i = m.first.first;
-                int j = m.first.second;
-                assert(i >= 0 && i < (int) p.size() && j >= 0 && j < (int) p.size()); //debug
-                u += m.second(p[i], p[j], spc->geo.sqdist(p[i], p[j]));
+                assert(b.i >= 0 && b.i < (int) p.size() && b.j >= 0 && b.j < (int) p.size()); //debug
+                u += energy(b, p[b.i], p[b.j]);
             }
             return u;
         }
 
         /**
              * Group-to-group bonds are disabled by default as these are
-             * rarely used and the current implementation is rather slow
-             * for systems with *many* groups (but very general). To
-             * activate `g2g()`, set `CrossGroupBonds=true`.
+             * rarely used. To activate `g2g()`, set `CrossGroupBonds=true`.
              *
              * @warning Untested!
-             * @todo Possible optimization: swap groups so that `g1<g2`;
              */
         double g2g( const Tpvec &p, Group &g1, Group &g2 ) override
         {
             double u = 0;
             if ( CrossGroupBonds )
                 for ( auto i : g1 )
-                {
-                    auto eqr = this->mlist.equal_range(i);
-                    for ( auto it = eqr.first; it != eqr.second; ++it )
-                    {
-                        int j = it->second; // partner index
+                    forEachBond(i, [&]( const Bond &b ) {
+                        int j = b.i + b.j - i; // partner index
                         if ( g2.find(j))
-                            u += this->list[opair<int>(i, j)](
-                                p[i], p[j], spc->geo.sqdist(p[i], p[j]));
-                    }
-                }
+                            u += energy(b, p[i], p[j]);
+                    });
             return u;
         }
 
@@ -1685,50 +2712,52 @@ namespace Faunus
         double g_internal( const Tpvec &p, Group &g ) override
         {
             double u = 0;
-            if ( this->list.size() > pow(g.size(), 2))
-            {
-                // small group compared to bond list
-                auto end = this->list.end();
-                for ( auto i = g.front(); i < g.back(); i++ )
-                    for ( auto j = i + 1; j <= g.back(); j++ )
-                    {
-                        auto it = this->list.find(opair<int>(i, j));
-                        if ( it != end )
-                            u += it->second(p[i], p[j], spc->geo.sqdist(p[i], p[j]));
-                    }
-            }
-            else
-            {
-                // big group compared to bond list
-                for ( auto &m : this->list )
-                {
-                    int i = m.first.first, j = m.first.second;
-                    if ( g.find(i))
+            for ( auto i : g )
+                forEachBond(i, [&]( const Bond &b ) {
+                    int j = b.i + b.j - i; // partner index
+                    if ( j > i )
                         if ( g.find(j))
-                            u += m.second(p[i], p[j], spc->geo.sqdist(p[i], p[j]));
-                }
-            }
+                            u += energy(b, p[i], p[j]);
+                });
             return u;
         }
 
+        /** @brief Add bond with arbitrary pair potential */
         template<class Tpairpot>
         void add( int i, int j, Tpairpot pot )
         {
-            std::ostringstream o;
-            o << textio::indent(textio::SUBSUB) << std::left << setw(7) << i
-              << setw(7) << j << pot.brief() + "\n";
-            _infolist += o.str();
+            addInfo(i, j, pot.brief());
             pot.name.clear();   // potentially save a little bit of memory
-            Tbase::add(i, j, pot);// create and add functor to pair list
-            force_list[typename Tbase::Tpair(i, j)]
-                = ForceFunctionObject<decltype(pot)>(pot);
+            addBond(i, j, Type::FUNCTION, func.size());
+            func.push_back(pot);
+            force.push_back(ForceFunctionObject<decltype(pot)>(pot));
         }
 
         /** @brief Add harmonic bond */
+        void add( int i, int j, Potential::Harmonic pot )
+        {
+            addInfo(i, j, pot.brief());
+            pot.name.clear();
+            addBond(i, j, Type::HARMONIC, harmonic.size());
+            harmonic.push_back(pot);
+        }
+
+        /** @brief Add FENE bond */
+        void add( int i, int j, Potential::FENE pot )
+        {
+            addInfo(i, j, pot.brief());
+            pot.name.clear();
+            addBond(i, j, Type::FENE, fene.size());
+            fene.push_back(pot);
+        }
+
+        /** @brief Add harmonic or FENE bond */
         void add( const Faunus::Bonded::BondData &hb )
         {
             if ( hb.type == Faunus::Bonded::BondData::Type::HARMONIC )
                 add(hb.index.at(0), hb.index.at(1), Potential::Harmonic(hb.k, hb.req));
+            else if ( hb.type == Faunus::Bonded::BondData::Type::FENE )
+                add(hb.index.at(0), hb.index.at(1), Potential::FENE(hb.k, hb.req));
         }
 
         /** @brief Add all bonds found in a list of groups */
@@ -1741,16 +2770,25 @@ namespace Faunus
                         b.shift(g->front());
                         add(b);
                     }
+            build();
         }
 
         /** @brief Get list of bonds */
-        auto getBondList() -> decltype(this->list) { return Tbase::getBondList(); }
+        const std::vector<Bond> &getBondList() const { return bonds; }
 
         /** @brief Reset and clear all bonds */
         void clear()
         {
             _infolist.clear();
-            Tbase::clear();
+            bonds.clear();
+            lookup.clear();
+            harmonic.clear();
+            fene.clear();
+            func.clear();
+            force.clear();
+            offset.clear();
+            adj.clear();
+            stale = false;
         }
 
     };
@@ -1882,6 +2920,8 @@ namespace Faunus
             return P * V - log(V);
         }
 
+        double scaledPairChange( double ) override { return 0; } // no pair interactions
+
         double g_external( const Tpvec &p, Group &g ) override
         {
             // should this group be ignored?
@@ -2046,6 +3086,10 @@ namespace Faunus
             return u;
         }
 
+        bool cacheable() override { return expot.isStatic(); }
+
+        bool threadSafe() override { return expot.threadSafe(); }
+
         /** @brief Field on all particles due to external potential */
         void field( const typename base::Tpvec &p, Eigen::MatrixXd &E ) override
         {
@@ -2142,6 +3186,8 @@ namespace Faunus
             return std::make_tuple(this);
         }
 
+        bool cacheable() override { return false; } // g_external() depends on other groups
+
         /** @brief Constrain treated as external potential */
         double g_external( const typename Tspace::ParticleVector &p, Group &g1 ) override
         {
@@ -2229,7 +3275,6 @@ namespace Faunus
 
         std::map<string, Tuofr> uofr; // sasa energy vs. group-2-group distance
 
-        vector<bool> v;      // bool for all particles; true=active
         vector<double> sasa; // sasa for all particles
         double threshold;    // surface-surface distance threshold
         double tension;
@@ -2321,6 +3366,8 @@ namespace Faunus
 
         auto tuple() -> decltype(std::make_tuple(this)) { return std::make_tuple(this); }
 
+        bool threadSafe() override { return !sample_uofr; } // g2g() samples U(r) in order of evaluation
+
         /** @brief Group-to-group energy */
         double g2g( const Tpvec &p, Group &g1, Group &g2 ) override
         {
@@ -2331,8 +3378,8 @@ namespace Faunus
                 if ( g1.isMolecular())
                     if ( g2.isMolecular())
                     {
-                        v.resize(p.size());
-                        std::fill(v.begin(), v.end(), true);
+                        static thread_local vector<bool> v; // bool for all particles; true=active
+                        v.assign(p.size(), true);
                         for ( auto i : g1 )
                             for ( auto j : g2 )
                                 if ( p[i].hydrophobic )
@@ -2356,6 +3403,7 @@ namespace Faunus
                         {
                             double r = base::spc->geo.dist(g1.cm, g2.cm);
                             auto k = std::minmax(g1.name, g2.name);
+#pragma omp critical (HydrophobicSASA_uofr)
                             uofr[k.first + "-" + k.second][to_bin(r, dr)] += -tension * dsasa;
                         }
                     }
@@ -3248,6 +4296,12 @@ class SASAEnergy : public Energybase<Tspace> {
                     {
                     }
 
+                    if ( i.key() == "cache" )
+                    {
+                        Tbase::cache.setup(j);
+                        continue;
+                    }
+
                     if (n==baselist.size()) // nothing was added --> unknown type given --> error
                         throw std::runtime_error("unknown energy '" + i.key() + "'");
 
@@ -3290,6 +4344,12 @@ class SASAEnergy : public Energybase<Tspace> {
                 b->setSpace(s);
         }
 
+        void prepare( const Tpvec &p ) override
+        {
+            for ( auto b : baselist )
+                b->prepare(p);
+        }
+
         double p2p( const Tparticle &p1, const Tparticle &p2 ) override
         {
             double u = 0;
@@ -3306,6 +4366,22 @@ class SASAEnergy : public Energybase<Tspace> {
             return p;
         }
 
+        PairForceSum f_g2g( const Tpvec &p, Group &g1, Group &g2 ) override
+        {
+            PairForceSum s;
+            for ( auto b : baselist )
+                s += b->f_g2g(p, g1, g2);
+            return s;
+        }
+
+        PairForceSum f_g_internal( const Tpvec &p, Group &g ) override
+        {
+            PairForceSum s;
+            for ( auto b : baselist )
+                s += b->f_g_internal(p, g);
+            return s;
+        }
+
         double all2p( const Tpvec &p, const Tparticle &a ) override
         {
             double u = 0;
@@ -3406,6 +4482,62 @@ class SASAEnergy : public Energybase<Tspace> {
             return u;
         }
 
+        double scaledPairChange( double s ) override
+        {
+            double du = 0;
+            for ( auto b : baselist )
+                du += b->scaledPairChange(s);
+            return du;
+        }
+
+        bool cacheable() override
+        {
+            for ( auto b : baselist )
+                if ( !b->cacheable())
+                    return false;
+            return true;
+        }
+
+        bool threadSafe() override
+        {
+            for ( auto b : baselist )
+                if ( !b->threadSafe())
+                    return false;
+            return true;
+        }
+
+        bool storesPairs() override
+        {
+            for ( auto b : baselist )
+                if ( b->storesPairs())
+                    return true;
+            return false;
+        }
+
+        Tmjson json() override
+        {
+            Tmjson js;
+            for ( auto b : baselist )
+                js = merge(js, b->json());
+            return js;
+        }
+
+        double update( bool acc ) override
+        {
+            double u = 0;
+            for ( auto b : baselist )
+                u += b->update(acc);
+            return u;
+        }
+
+        double updateChange( const typename Tspace::Change &c ) override
+        {
+            double u = 0;
+            for ( auto b : baselist )
+                u += b->updateChange(c);
+            return u;
+        }
+
         double g1g2( const Tpvec &p1, Group &g1, const Tpvec &p2, Group &g2 ) override
         {
             double u = 0;
@@ -3442,13 +4574,12 @@ class SASAEnergy : public Energybase<Tspace> {
          */
         virtual double systemEnergy( const Tpvec &p )
         {
+            auto &g = Energybase<Tspace>::spc->groupList();
+            prepare(p);
             double u = external(p);
-            for ( auto g : Energybase<Tspace>::spc->groupList())
-                u += g_external(p, *g) + g_internal(p, *g);
-            for ( unsigned int i = 0; i < Energybase<Tspace>::spc->groupList().size() - 1; i++ )
-                for ( unsigned int j = i + 1; j < Energybase<Tspace>::spc->groupList().size(); j++ )
-                    u += g2g(p, *Energybase<Tspace>::spc->groupList()[i], *Energybase<Tspace>::spc->groupList()[j]);
-            return u;
+            for ( auto i : g )
+                u += g_external(p, *i) + g_internal(p, *i);
+            return u + Tbase::pairSum(g, [&]( int i, int j ) { return g2g(p, *g[j], *g[i]); }, threadSafe());
         }
 
         /**
@@ -3490,30 +4621,30 @@ class SASAEnergy : public Energybase<Tspace> {
         return pot.systemEnergy(p);
     }
 
-    /**
-     * @brief Calculates the total system energy
-     *
-     * For a given particle vector, space, and energy class we try to
-     * calculate the total energy taking into account inter- and
-     * intra-molecular interactions as well as external potentials.
-     * While this may not work for all systems it may be a useful
-     * first guess.
-     * This is the default energy routine for `Move::ParallelTempering`
-     * and may also be used for checking energy drifts.
-     */
-    template<class Tspace, class Tenergy, class Tpvec>
-    double systemEnergy_old( Tspace &spc, Tenergy &pot, const Tpvec &p )
-    {
-        pot.setSpace(spc); // ensure pot geometry is in sync with spc
-        double u = pot.external(p);
-        for ( auto g : spc.groupList())
-            u += pot.g_external(p, *g) + pot.g_internal(p, *g);
-        for ( int i = 0; i < (int) spc.groupList().size() - 1; i++ )
-            for ( int j = i + 1; j < (int) spc.groupList().size(); j++ )
-                u += pot.g2g(p, *spc.groupList()[i], *spc.groupList()[j]);
-        return u;
-    }
     
+      /**
+       * @brief Energy of moved atoms with all atoms in their (atomic) group
+       *
+       * Pairs of moved atoms are counted only once.
+       */
+      template<class Tenergy, class Tpvec>
+      double movedAtomsEnergy( Tenergy &pot, const Tpvec &p, Group &g, const vector<int> &index )
+      {
+          double u = 0;                                 // moved atoms <-> all atoms in moved group
+          for ( auto j : index )
+              u += pot.i2g(p, g, j);
+          if ( u < pc::infty )                          // moved atoms interact only once
+          {
+              if ( int(index.size()) == g.size() )
+                  u *= 0.5;
+              else
+                  for ( size_t j = 0; j < index.size(); j++ )
+                      for ( size_t k = j + 1; k < index.size(); k++ )
+                          u -= pot.i2i(p, index[j], index[k]);
+          }
+          return u;
+      }
+
       /**
        * @brief Help-function to 'energyChange'
        * @todo Fix such that it works for inserted and removed particles
@@ -3542,14 +4673,8 @@ class SASAEnergy : public Energybase<Tspace> {
 
               du += pot.g_external(p, *g[i]);                   // moved group <-> external
 
-              if ( g[i]->isAtomic() )
-              {                                                 // Check if moved group is atomic
-                  for ( auto j : m.second )                     // loop over all moved groups
-                      for ( auto k : *g[i] )                    // loop over all atoms in moved group
-                          if ( std::find(m.second.begin(), m.second.end(), k) == m.second.end() || j
-                              > k ) // check such that moved atoms does not interact OR moved atoms interact only once
-                              du += pot.i2i(p, j, k);
-              }
+              if ( g[i]->isAtomic() && !m.second.empty() )   // Check if moved group is atomic
+                  du += movedAtomsEnergy(pot, p, *g[i], m.second);
               if ( g[i]->isMolecular() )
               {
                   if (!m.second.empty()) // only recalculate internal energy if N>0
@@ -3571,8 +4696,46 @@ class SASAEnergy : public Energybase<Tspace> {
           return du;
       }
 
+      /**
+       * @brief As `energyChangeConfiguration` but with separate terms
+       *
+       * Terms already present in `t` (i.e. not NaN) are not recalculated.
+       */
+      template<class Tenergy, class Tpvec, class Tgeo, class Tparticle>
+      void energyChangeTerms(
+          Space<Tgeo,Tparticle> &spc,
+          Tenergy &pot,
+          const Tpvec &p,
+          const typename Space<Tgeo,Tparticle>::Change &c,
+          EnergyCache::Terms &t )
+      {
+          auto &g = spc.groupList();
+          if ( std::isnan(t.pair) )
+          {
+              t.pair = pot.g2All(p, c.mvGroup);
+              for ( auto &m : c.mvGroup )
+                  if ( g[m.first]->isAtomic() && !m.second.empty() )
+                      t.pair += movedAtomsEnergy(pot, p, *g[m.first], m.second);
+          }
+          if ( std::isnan(t.external) )
+              t.external = pot.external(p);
+
+          for ( auto &m : c.mvGroup )
+          {
+              size_t i = size_t(m.first);
+              if ( std::isnan(t.gExternal[i]) )
+                  t.gExternal[i] = pot.g_external(p, *g[i]);
+              if ( g[i]->isMolecular() && !m.second.empty() )
+                  if ( std::isnan(t.gInternal[i]) )
+                      t.gInternal[i] = pot.g_internal(p, *g[i]);
+          }
+      }
+
     /**
      * @brief Calculate energy change due to proposed modification defined by `Space::Change`
+     *
+     * If `pot.cache` is enabled, known energies of the current configuration
+     * are taken from the cache instead of being recalculated; see `EnergyCache`.
      */
       template<class Tenergy, class Tgeometry, class Tparticle>
       double energyChange( Space<Tgeometry, Tparticle> &s,
@@ -3606,7 +4769,19 @@ class SASAEnergy : public Energybase<Tspace> {
                       if ( s.geo.collision(s.trial[j], s.trial[j].radius, Geometry::Geometrybase::BOUNDARY))
                           return pc::infty;
 
-          double duNew = energyChangeConfiguration(s, pot, s.trial, c);
+          EnergyCache &cache = pot.cache;
+          if ( cache.enabled && !pot.cacheable())
+              throw std::runtime_error("energy cache cannot be used with time dependent or non-local energy terms");
+          double duNew;
+
+          if ( cache.enabled )
+          {
+              auto &tNew = cache.trialConfiguration(c.mvGroup, s.groupList().size());
+              energyChangeTerms(s, pot, s.trial, c, tNew);
+              duNew = tNew.sum(c.mvGroup);
+          }
+          else
+              duNew = energyChangeConfiguration(s, pot, s.trial, c);
 
           // restore original geometry
           if ( c.geometryChange )
@@ -3615,7 +4790,16 @@ class SASAEnergy : public Energybase<Tspace> {
               pot.setSpace(s);
           }
 
-          double duOld = energyChangeConfiguration(s, pot, s.p, c);
+          if ( !cache.enabled )
+              return duNew - energyChangeConfiguration(s, pot, s.p, c);
+
+          auto &tOld = cache.currentConfiguration(c.mvGroup, s.groupList().size(), pot.storesPairs());
+          energyChangeTerms(s, pot, s.p, c, tOld);
+          double duOld = tOld.sum(c.mvGroup);
+          cache.trial(c.mvGroup);
+
+          if ( cache.checkNow())
+              cache.verify(duOld, energyChangeConfiguration(s, pot, s.p, c));
 
           return (duNew - duOld);
       }
@@ -3670,6 +4854,12 @@ class SASAEnergy : public Energybase<Tspace> {
               Tbase::setSpace(s);
           }
 
+          void prepare( const Tpvec &p ) override
+          {
+              first.prepare(p);
+              second.prepare(p);
+          }
+
           double p2p( const Tparticle &a, const Tparticle &b ) override { return first.p2p(a, b); }
 
           Point f_p2p( const Tparticle &a, const Tparticle &b ) override
@@ -3677,6 +4867,16 @@ class SASAEnergy : public Energybase<Tspace> {
               return first.f_p2p(a, b);
           }
 
+          PairForceSum f_g2g( const Tpvec &p, Group &g1, Group &g2 ) override { return first.f_g2g(p, g1, g2); }
+
+          PairForceSum f_g_internal( const Tpvec &p, Group &g ) override { return first.f_g_internal(p, g); }
+
+          bool cacheable() override { return first.cacheable() && second.cacheable(); }
+
+          bool threadSafe() override { return first.threadSafe() && second.threadSafe(); }
+
+          bool storesPairs() override { return first.storesPairs() || second.storesPairs(); }
+
           double all2p( const Tpvec &p, const Tparticle &a ) override { return first.all2p(p, a); }
 
           double i2i( const Tpvec &p, int i, int j ) override { return first.i2i(p, i, j); }
@@ -3728,6 +4928,11 @@ class SASAEnergy : public Energybase<Tspace> {
 
           double update( bool b ) override { return first.update(b) + second.update(b); }
 
+          double updateChange( const typename Tspace::Change &c ) override
+          {
+              return first.updateChange(c) + second.updateChange(c);
+          }
+
           double v2v( const Tpvec &p1, const Tpvec &p2 ) override { return first.v2v(p1, p2) + second.v2v(p1, p2); }
 
           void field( const Tpvec &p, Eigen::MatrixXd &E ) override
@@ -3736,7 +4941,7 @@ class SASAEnergy : public Energybase<Tspace> {
               second.field(p, E);
           }
 
-          double g2All(const Tpvec & p, const std::map<int, vector<int>>& mg) override
+          double g2All(const Tpvec & p, const ChangeMap<vector<int>>& mg) override
           {
               double a = first.g2All(p, mg);
               double b = second.g2All(p, mg);
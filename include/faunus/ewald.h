@@ -29,6 +29,11 @@ namespace Faunus {
 		 * E_{Real} = \sum_{i=1}^{N-1}\sum_{j=i+1}^N \left( q_i\boldsymbol{{\rm T}}_0(\boldsymbol{r}_{ij})q_j   +      q_i\boldsymbol{{\rm T}}_1(\boldsymbol{r}_{ij})\cdot \boldsymbol{\mu}_j  - q_j\boldsymbol{{\rm T}}_1(\boldsymbol{r}_{ij})\cdot \boldsymbol{\mu}_i   -       \boldsymbol{\mu}_i^T\boldsymbol{{\rm T}}_2(\boldsymbol{r}_{ij})\boldsymbol{\mu}_j    \right)
 		 * @f]
 		 * 
+		 * For ion-ion interactions the screened form,
+		 * \f$ \left( {\rm erfc}(\alpha r + \kappa/2\alpha)e^{\kappa r} + {\rm erfc}(\alpha r - \kappa/2\alpha)e^{-\kappa r} \right)/2r \f$,
+		 * is used. The radial parts are tabulated as functions of \f$ r/r_c \f$ using `Tabulate::Andrea`
+		 * with tolerances `tab_utol` and `tab_ftol`, and `analytic()` gives the same energy without tables.
+		 *
 		 * @note Optimal parameters for ion-dipole interactions are assumed to be the same as for ion-ion interactions.
 		 *
 		 */
@@ -42,17 +47,21 @@ namespace Faunus {
 				Tabulate::Andrea<double> T0_tabulator, T1_tabulator, T2_tabulator;
 				Tabulate::TabulatorBase<double>::data table_T0, table_T1, table_T2;
 
-				std::function<double(double)> T0_sf = [&](double r1) { return erfc(alpha*r1); }; 
-				std::function<double(double)> T1_sf = [&](double r1) { return (r1*2.0*alpha/sqrt(pc::pi)*exp(-alpha2*r1*r1) + erfc(alpha*r1)); }; 
-				std::function<double(double)> T2_sf = [&](double r1) { return 3.0*(T1_sf(r1) + 4.0*alpha2*alpha/3.0/sqrt(pc::pi)*r1*r1*r1*exp(-alpha2*r1*r1) ); }; 
+				// Radial parts of T0, T1 and T2 as functions of q=r/rc
+				double T0_sf(double q) const { double r1 = q*rc; if (alpha <= 0) return exp(-kappa*r1); return (erfc(alpha*r1+kappa/2.0/alpha)*exp(kappa*r1) + erfc(alpha*r1-kappa/2.0/alpha)*exp(-kappa*r1))/2.0; }
+				double T1_sf(double q) const { double r1 = q*rc; return (r1*2.0*alpha/sqrt(pc::pi)*exp(-alpha2*r1*r1) + erfc(alpha*r1)); }
+				double T2_sf(double q) const { double r1 = q*rc; return 3.0*(T1_sf(q) + 4.0*alpha2*alpha/3.0/sqrt(pc::pi)*r1*r1*r1*exp(-alpha2*r1*r1) ); }
 
-				EwaldReal(Tmjson &j, string sec="ewald") : Tbase(j), alpha(0), alpha2(0), rc(1), rc2(1) {
+				EwaldReal(Tmjson &j, string sec="ewald") : Tbase(j), alpha(0), alpha2(0), rc(1), rc2(1), kappa(0) {
 					Tbase::name="Ewald Real";
 					tab_utol = j[sec]["tab_utol"] | 1e-9;
 					tab_ftol = j[sec]["tab_ftol"] | 1e-5;
 					T0_tabulator.setTolerance(tab_utol,tab_ftol); // Tolerance in energy and force
 					T1_tabulator.setTolerance(tab_utol,tab_ftol); // Tolerance in energy and force
 					T2_tabulator.setTolerance(tab_utol,tab_ftol); // Tolerance in energy and force
+					T0_tabulator.setRange(0,1); // tables are functions of r/rc
+					T1_tabulator.setRange(0,1);
+					T2_tabulator.setRange(0,1);
 					lB = Tbase::bjerrumLength();
 				}
 				
@@ -61,6 +70,8 @@ namespace Faunus {
 				}
 
 				void updateAlpha(double alpha_in) {
+					if (alpha_in < 0)
+						throw std::runtime_error("Ewald: alpha must be non-negative");
 					alpha = alpha_in;
 					alpha2 = alpha*alpha;
 					updateSpline();
@@ -69,20 +80,22 @@ namespace Faunus {
 				void updateRcut(double rc_in) {
 					rc = rc_in;
 					rc2 = rc*rc;
-					T0_tabulator.setRange(0,rc);
-					T1_tabulator.setRange(0,rc);
-					T2_tabulator.setRange(0,rc);
 					updateSpline();
 				}
 
 				void updateKappa(double kappa_in) {
 					kappa = kappa_in;
+					updateSpline();
 				}
 
+				/** @brief Regenerate tables; for `alpha=0` they hold the plain (screened) Coulomb terms */
 				void updateSpline() {
-					table_T0 = T0_tabulator.generate( T0_sf );
-					table_T1 = T1_tabulator.generate( T1_sf );
-					table_T2 = T2_tabulator.generate( T2_sf );
+					if (useIonIon)
+						table_T0 = T0_tabulator.generate( [this](double q) { return T0_sf(q); } );
+					if (useIonDipole || useDipoleDipole) {
+						table_T1 = T1_tabulator.generate( [this](double q) { return T1_sf(q); } );
+						table_T2 = T2_tabulator.generate( [this](double q) { return T2_sf(q); } );
+					}
 				}
 
 				/**
@@ -94,27 +107,21 @@ namespace Faunus {
 					return (1.0 + 3.0*M2V); 
 				}
 
+				/**
+				 * @brief Energy in kT from the radial parts of the interaction tensors
+				 * @param t0 Radial part of T0 at distance r
+				 * @param t1 Radial part of T1 at distance r
+				 * @param t2 Radial part of T2 at distance r
+				 */
 				template<class Tparticle>
-					double operator() (const Tparticle &a, const Tparticle &b, const Point &r) const {
-						if(!useIonIon && !useIonDipole && !useDipoleDipole)
-							return 0.0;
-
-						double r2 = r.squaredNorm();
-						if (r2 > rc2)
-							return 0.0;
-
-						double r1 = sqrt(r2);
+					double energy(const Tparticle &a, const Tparticle &b, const Point &r, double r1, double r2, double t0, double t1, double t2) const {
 						double E = 0.0;
-
-						E += a.charge*b.charge*(erfc(alpha*r1+kappa/2.0/alpha)*exp(kappa*r1) + erfc(alpha*r1-kappa/2.0/alpha)*exp(-kappa*r1))/(2.0*r1)*QeQe(a.id, b.id)*lB;
-						return E;
-
 						if(useIonIon)
-							E += a.charge*b.charge*T0_tabulator.eval(table_T0,r1)/r1;
+							E += a.charge*b.charge*t0/r1*QeQe(a.id, b.id);
 						if(!useIonDipole && !useDipoleDipole)
 							return lB*E;
 
-						double T1 = T1_tabulator.eval(table_T1,r1)/r1/r2;
+						double T1 = t1/r1/r2;
 						if(useIonDipole) {
 							E += a.charge*r.dot(b.mu())*b.muscalar()*T1;
 							E -= b.charge*r.dot(a.mu())*a.muscalar()*T1;
@@ -122,21 +129,58 @@ namespace Faunus {
 
 						if(useDipoleDipole) {
 							double t3 = -b.mu().dot(a.mu())*T1;
-							double t5 = b.mu().dot(r)*a.mu().dot(r)*T2_tabulator.eval(table_T2,r1)/r2/r2/r1;
+							double t5 = b.mu().dot(r)*a.mu().dot(r)*t2/r2/r2/r1;
 							E += -(t5 + t3)*b.muscalar()*a.muscalar();
 						}
 						return lB*E;
 					}
+
+				template<class Tparticle>
+					double operator() (const Tparticle &a, const Tparticle &b, const Point &r) const {
+						if(!useIonIon && !useIonDipole && !useDipoleDipole)
+							return 0.0;
+
+						double r2 = r.squaredNorm();
+						if (r2 > rc2)
+							return 0.0;
+
+						double r1 = sqrt(r2);
+						double q = r1/rc;
+						double t0 = 0, t1 = 0, t2 = 0;
+						if(useIonIon)
+							t0 = T0_tabulator.eval(table_T0,q);
+						if(useIonDipole || useDipoleDipole)
+							t1 = T1_tabulator.eval(table_T1,q);
+						if(useDipoleDipole)
+							t2 = T2_tabulator.eval(table_T2,q);
+						return energy(a, b, r, r1, r2, t0, t1, t2);
+					}
+
+				/** @brief Energy in kT evaluated without tables */
+				template<class Tparticle>
+					double analytic(const Tparticle &a, const Tparticle &b, const Point &r) const {
+						if(!useIonIon && !useIonDipole && !useDipoleDipole)
+							return 0.0;
+
+						double r2 = r.squaredNorm();
+						if (r2 > rc2)
+							return 0.0;
+
+						double r1 = sqrt(r2);
+						double q = r1/rc;
+						return energy(a, b, r, r1, r2, T0_sf(q), T1_sf(q), T2_sf(q));
+					}
 			};
 
 		template<bool useIonIon=true, bool useIonDipole=false, bool useDipoleDipole=false>
 			struct EwaldParameters {
 
-				int kcc, N;
+				int kcc, N, mesh, spline_order;
 				double alpha, alpha2, rc, kc, kc2, minL, maxL, check_k2_zero, debyelength, kappa;
+				bool spme; // reciprocal structure factors from particle mesh
 				Point L;
 
-				EwaldParameters() { }
+				EwaldParameters() : mesh(0), spline_order(6), spme(false) { }
 
 				void update(Point L_in) {
 					L = L_in;
@@ -164,9 +208,261 @@ namespace Faunus {
 					kc = alpha*minL;
 					kc2 = kc*kc;
 				}
+
+				/**
+				 * @brief Estimated RMS error of the real space energy (\f$ e^2/\AA \f$)
+				 * @param Q2 Sum of squared charges
+				 * @param V Volume
+				 * @note Implemented from  <http://dx.doi.org/10.1080/08927029208049126>
+				 */
+				double realError(double Q2, double V) const {
+					return Q2*sqrt(rc/(2*V))*exp(-alpha2*rc*rc)/(alpha2*rc*rc);
+				}
+
+				/**
+				 * @brief Estimated error of the reciprocal space energy (\f$ e^2/\AA \f$)
+				 * @param Q2 Sum of squared charges
+				 *
+				 * Sum of the omitted k-vectors, \f$ |{\bf n}| > k_c \f$, assuming \f$ |Q({\bf k})|^2 \approx Q^2 \f$.
+				 * This is a systematic shift which for random configurations is larger than the
+				 * fluctuating error given in <http://dx.doi.org/10.1080/08927029208049126>.
+				 */
+				double reciprocalError(double Q2) const {
+					double x = pc::pi*kc/(alpha*maxL);
+					return Q2*alpha/(pc::pi*x)*exp(-x*x);
+				}
 			};
 
-	}//namespace
+			/**
+			 * @brief Smooth particle mesh evaluation of Ewald structure factors
+			 *
+			 * Charges and dipoles are spread onto a regular mesh of `M` points per dimension
+			 * using cardinal B-splines of order `p` and Fourier transformed. The structure
+			 * factor for a k-vector with integer index \f$ {\bf n} \f$ is then approximated by
+			 *
+			 * @f[
+			 * S({\bf n}) \approx b(n_x)b(n_y)b(n_z) \sum_{\bf g} Q({\bf g}) e^{2\pi i {\bf n}\cdot{\bf g}/M}
+			 * \;\;,\;\; b(n) = \left ( \sum_{k=1}^{p-1} M_p(k) e^{-2\pi i n k/M} \right )^{-1}
+			 * @f]
+			 *
+			 * where \f$ Q \f$ is the spread charge, see doi:10.1063/1.470117. Dipoles are
+			 * spread with the spline gradient which gives \f$ \sum_j i({\bf k}\cdot\boldsymbol{\mu}_j)e^{i{\bf k}\cdot{\bf r}_j} \f$.
+			 * The cost is \f$ O(Np^3 + M^3\log M) \f$ rather than \f$ O(N N_k) \f$ for the direct sum
+			 * and `M` must be a power of two larger than twice the largest k-vector index.
+			 */
+			class EwaldMesh {
+				private:
+					int M, order;
+					std::vector<complex<double>> Q, b, line, twiddle;
+					std::vector<int> wanted;         // mesh indices within the k-vector cut-off
+					std::vector<double> w[3], dw[3]; // spline weights and derivatives for current particle
+
+					/** @brief In-place radix-2 transform with positive exponent of `M` points separated by `stride` */
+					void fft(complex<double> *a, int stride) {
+						for (int i=0; i<M; i++)
+							line[i] = a[i*stride];
+						for (int i=1, j=0; i<M; i++) { // bit reversal
+							int bit = M >> 1;
+							for (; j & bit; bit >>= 1)
+								j ^= bit;
+							j ^= bit;
+							if (i < j)
+								std::swap(line[i], line[j]);
+						}
+						for (int len=2; len<=M; len<<=1)
+							for (int i=0; i<M; i+=len)
+								for (int k=0; k<len/2; k++) {
+									complex<double> u = line[i+k], v = line[i+k+len/2]*twiddle[k*(M/len)];
+									line[i+k] = u + v;
+									line[i+k+len/2] = u - v;
+								}
+						for (int i=0; i<M; i++)
+							a[i*stride] = line[i];
+					}
+
+					/**
+					 * @brief 3D transform of the mesh evaluated only for indices `|n|<=nmax`
+					 *
+					 * Lines along y and x are transformed only where they are needed by a later
+					 * k-vector lookup which for `M>>nmax` saves most of the work.
+					 */
+					void fft3d(int nmax) {
+						wanted.clear();
+						for (int n=-nmax; n<=nmax; n++)
+							wanted.push_back((n + M) % M);
+						line.resize(M);
+						for (int i=0; i<M*M; i++)
+							fft(&Q[i*M], 1);              // z
+						for (int i=0; i<M; i++)
+							for (int z : wanted)
+								fft(&Q[i*M*M+z], M);      // y
+						for (int y : wanted)
+							for (int z : wanted)
+								fft(&Q[y*M+z], M*M);      // x
+					}
+
+					/** @brief Spline weights, M_p(t+k), and derivatives for fractional coordinate `t` */
+					void weights(double t, std::vector<double> &m, std::vector<double> &dm) const {
+						m.assign(order, 0.0);
+						dm.assign(order, 0.0);
+						m[0] = t;
+						m[1] = 1 - t;
+						for (int j=3; j<=order; j++) {
+							if (j == order)
+								for (int k=0; k<order; k++) // M_p' from M_{p-1}
+									dm[k] = m[k] - (k > 0 ? m[k-1] : 0.0);
+							for (int k=j-1; k>=0; k--)
+								m[k] = ( (t+k)*m[k] + (j-t-k)*(k > 0 ? m[k-1] : 0.0) ) / (j-1);
+						}
+						if (order == 2) {
+							dm[0] = 1;
+							dm[1] = -1;
+						}
+					}
+
+					/** @brief Exact value of M_p(x) */
+					double spline(double x, int p) const {
+						if (x <= 0 || x >= p)
+							return 0;
+						if (p == 2)
+							return 1 - std::fabs(x - 1);
+						return ( x*spline(x, p-1) + (p-x)*spline(x-1, p-1) ) / (p-1);
+					}
+
+				public:
+					EwaldMesh() : M(0), order(0) {}
+
+					/** @brief Set mesh size (rounded up to power of two) and spline order */
+					void resize(int mesh, int spline_order) {
+						int m = 2;
+						while (m < mesh)
+							m <<= 1;
+						if (m == M && std::max(spline_order, 2) == order)
+							return;
+						M = m;
+						order = std::max(spline_order, 2);
+						Q.resize(M*M*M);
+						twiddle.resize(M/2+1);
+						for (int k=0; k<=M/2; k++)
+							twiddle[k] = std::polar(1.0, 2*pc::pi*k/M);
+						b.resize(M);
+						for (int n=0; n<M; n++) {
+							complex<double> sum(0,0);
+							for (int k=1; k<order; k++)
+								sum += spline(k, order) * std::polar(1.0, -2*pc::pi*n*k/M);
+							b[n] = (std::norm(sum) > 1e-14) ? 1.0/sum : 0.0;
+						}
+					}
+
+					int size() const { return M; }
+
+					/**
+					 * @brief Structure factors for all k-vectors
+					 * @param p Particle vector
+					 * @param qe Effective charges
+					 * @param kIndices Integer indices of k-vectors
+					 * @param kUnit Reciprocal unit vector, 2*pi/L
+					 * @param n Number of k-vectors to evaluate
+					 * @param Q_ion_out Structure factors for charges
+					 * @param Q_dip_out Structure factors for dipoles
+					 * @param ions Spread charges
+					 * @param dipoles Spread dipoles
+					 *
+					 * Both meshes are real so charges and dipoles are spread as the real and imaginary
+					 * parts of a single mesh and separated after the transform using
+					 * \f$ F_{ion}({\bf n}) = (F({\bf n}) + F^*(-{\bf n}))/2 \f$.
+					 */
+					template<class Tpvec>
+						void structureFactors(const Tpvec &p, const std::vector<double> &qe, const Eigen::Matrix3Xi &kIndices, const Point &kUnit, int n,
+								std::vector<complex<double>> &Q_ion_out, std::vector<complex<double>> &Q_dip_out, bool ions, bool dipoles) {
+							std::fill(Q.begin(), Q.end(), 0.0);
+							int g0[3];
+							Point scale = kUnit * M / (2*pc::pi); // mesh points per unit length
+							for (size_t j=0; j<p.size(); j++) {
+								Point mu = p[j].mu() * p[j].muscalar();
+								for (int d=0; d<3; d++) {
+									double u = p[j][d] * scale[d];
+									double f = std::floor(u);
+									g0[d] = int(f);
+									weights(u-f, w[d], dw[d]);
+								}
+								for (int kx=0; kx<order; kx++) {
+									int gx = ((g0[0]-kx) % M + M) % M;
+									for (int ky=0; ky<order; ky++) {
+										int gy = ((g0[1]-ky) % M + M) % M;
+										double wxy = w[0][kx]*w[1][ky];
+										for (int kz=0; kz<order; kz++) {
+											int gz = ((g0[2]-kz) % M + M) % M;
+											double q = ions ? qe[j] * wxy * w[2][kz] : 0.0;
+											double m = dipoles ? mu.x()*scale.x()*dw[0][kx]*w[1][ky]*w[2][kz]
+												+ mu.y()*scale.y()*w[0][kx]*dw[1][ky]*w[2][kz]
+												+ mu.z()*scale.z()*wxy*dw[2][kz] : 0.0;
+											Q[(gx*M + gy)*M + gz] += complex<double>(q, m);
+										}
+									}
+								}
+							}
+							fft3d(n > 0 ? kIndices.leftCols(n).cwiseAbs().maxCoeff() : 0);
+							for (int k=0; k<n; k++) {
+								int m[3], mm[3];
+								complex<double> bk(1,0);
+								for (int d=0; d<3; d++) {
+									m[d] = (kIndices(d,k) % M + M) % M;
+									mm[d] = (M - m[d]) % M;
+									bk *= b[m[d]];
+								}
+								complex<double> F = Q[(m[0]*M + m[1])*M + m[2]];
+								complex<double> Fc = std::conj(Q[(mm[0]*M + mm[1])*M + mm[2]]);
+								Q_ion_out.at(k) = bk * 0.5 * (F + Fc);
+								Q_dip_out.at(k) = bk * complex<double>(0,-0.5) * (F - Fc);
+							}
+						}
+			};
+
+			/**
+			 * @brief Phase factors for the reciprocal part of Ewald
+			 *
+			 * For each particle and Cartesian direction, \f$ e^{inb_dr_d} \f$ with \f$ b_d=2\pi/L_d \f$
+			 * is generated for \f$ n=0,\ldots,n_{max} \f$ by complex recurrence. This way
+			 * only one `cos` and one `sin` per particle and direction is evaluated,
+			 * independent of the number of k-vectors. Factors are stored as structure of
+			 * arrays, `re[d][n*N+i]`, so that sums over particles for a given k-vector
+			 * run over contiguous memory and can be vectorised. Negative `n` is obtained
+			 * by complex conjugation.
+			 */
+			struct EwaldPhases {
+				int N, nmax;
+				std::vector<double> re[3], im[3];
+
+				EwaldPhases() : N(0), nmax(0) {}
+
+				/** @brief Fill `exp(i*n*t)` for `n=0..nmax` into strided arrays */
+				static void recurrence(double t, int nmax, double *r, double *i, int stride=1) {
+					double c = cos(t), s = sin(t);
+					r[0] = 1.0;
+					i[0] = 0.0;
+					for (int n=1; n<=nmax; n++) {
+						r[n*stride] = r[(n-1)*stride]*c - i[(n-1)*stride]*s;
+						i[n*stride] = r[(n-1)*stride]*s + i[(n-1)*stride]*c;
+					}
+				}
+
+				/** @brief Generate phase factors for all particles */
+				template<class Tpvec>
+					void update(const Tpvec &p, const Point &b, int n_max) {
+						N = p.size();
+						nmax = n_max;
+						for (int d=0; d<3; d++) {
+							re[d].resize((nmax+1)*N);
+							im[d].resize((nmax+1)*N);
+						}
+						for (int i=0; i<N; i++)
+							for (int d=0; d<3; d++)
+								recurrence(b[d]*p[i][d], nmax, &re[d][i], &im[d][i], N);
+					}
+			};
+
+		}//namespace
 
 	namespace Energy {
 
@@ -190,8 +486,12 @@ namespace Faunus {
 		 * `cutoffK_y`       |  Maximum number of vectors in y-axis in k-space for ions. Is overridden if 'cutoffK' is set.                      (Default: According to DOI: (Ions) 10.1080/08927029208049126 or (Dipoles) 10.1063/1.1398588 )  
 		 * `cutoffK_z`       |  Maximum number of vectors in z-axis in k-space for ions. Is overridden if 'cutoffK' is set.                      (Default: According to DOI: (Ions) 10.1080/08927029208049126 or (Dipoles) 10.1063/1.1398588 )  
 		 * `update_frequency`|  The frequency of how often the total sum of all complex numbers are updated (an optimization optin).             (Default: Number of particles in system)
-		 * `tab_utol`        |  Tolerance of splined energy-error. Only used if isotropic interactions alone are handled.                        (Default: \f$ 10^{-9}\f$)
-		 * `tab_ftol`        |  Tolerance of splined force-error. Only used if isotropic interactions alone are handled.                         (Default: \f$ 10^{-5}\f$)
+		 * `tab_utol`        |  Tolerance of splined real space interaction tensors.                                                             (Default: \f$ 10^{-9}\f$)
+		 * `tab_ftol`        |  Tolerance of splined derivative of real space interaction tensors.                                               (Default: \f$ 10^{-5}\f$)
+		 * `tune`            |  Choose `alpha`, `cutoff` and `cutoffK` from `delta` and timings on the initial configuration; reported in `info()` and `json()`. See `tune()`. (Default: false)
+		 * `method`          |  Evaluation of structure factors in reciprocal space: `direct` sum or smooth particle mesh, `spme`.            (Default: `direct`)
+		 * `mesh`            |  Mesh points per dimension for `spme`, rounded up to a power of two.                                              (Default: \f$ 3\times \f$ `cutoffK`)
+		 * `spline_order`    |  Order of B-splines for `spme`.                                                                                    (Default: 6)
 		 * 
 		 * @note Tested and implemented through DOI: 10.1063/1.481216
 		 * @note If parameters are not set; optimized parameters for ion-ion-interactions will be used for all interactions save the case when only dipoles are present, then optimized parameters for dipole-dipole-interactions will be used. This is done since the wave-functions for ions and dipoles needs to be compatible with each other in order to get ion-dipole interactions.
@@ -220,7 +520,6 @@ namespace Faunus {
 		 * {\bf k} = 2\pi\left( \frac{n_x}{L_x} , \frac{n_y}{L_y} ,\frac{n_z}{L_z} \right)  \;\;,\;\; {\bf n} \in \mathbb{Z}^3
 		 * @f]
 		 * 
-		 * @todo Need to implement measurement of the average evaluation time for real part of Ewald, this in order to get optimal parametrization to work properly.
 		 * @warning Current version is constucted such that paramaters can not be correctly updated during a run if splines are used (i.e. only isotropic Coulomb is handled).
 		 * @warning Ewald summation does not work properly at the moment.
 		 * 
@@ -242,13 +541,21 @@ namespace Faunus {
 					EwaldParameters<useIonIon,useIonDipole,useDipoleDipole> parameters;
 					int kVectorsInUse, kVectorsInUse_trial, N, cnt_accepted, update_frequency;
 					double V, V_trial, surfaceEnergy, surfaceEnergyTrial, reciprocalEnergy, reciprocalEnergyTrial, eps_surf, const_inf, lB, update_drift; 
-					bool spherical_sum, isotropic_pbc;
+					bool spherical_sum, isotropic_pbc, kVectorsChanged; // kVectorsChanged: k-vectors differ between old and trial state
+					bool tuneParameters;  // tune alpha, cutoff and cutoffK when space is set
+					double delta;         // target accuracy for tuning
+					Tmjson tuning;        // result of last tuning
 					PairMatrix<double> QeQe; // matrix of effective charges
 					vector<double> effective_charges;
 					vector<complex<double>> Q_ion_tot, Q_dip_tot, Q_ion_tot_trial, Q_dip_tot_trial;
 					typename Tspace::Change change;
 
 					Eigen::MatrixXd kVectors, kVectors_trial;  // Matrices with k-vectors
+					Eigen::Matrix3Xi kIndices, kIndices_trial; // Integer indices of k-vectors, i.e. k = kUnit*n
+					Point kUnit, kUnit_trial;                  // 2*pi/L
+					EwaldPhases phases;                        // exp(i*k*r) factors for all particles
+					EwaldMesh mesh;                            // structure factors from particle mesh
+					vector<double> qe, mux, muy, muz, phase_re, phase_im; // packed charges, dipoles and single particle phases
 					Eigen::VectorXd Aks, Aks_trial;  // Stores values based on k-vectors in order to minimize computational effort. (See Eq.24 in DOI: 10.1063/1.481216)
 
 					/**
@@ -327,10 +634,12 @@ namespace Faunus {
 					 * @brief Updates all vectors and matrices which depends on the number of k-space vectors.
 					 * @note Needs to be called whenever 'kcc_x', 'kcc_y' or 'kcc_z' has been updated
 					 */
-					void kVectorChange(Eigen::MatrixXd &kVectors_in, Eigen::VectorXd &Aks_in, vector<complex<double>> &Q_ion_tot_in, vector<complex<double>> &Q_dip_tot_in, int &kVectorsInUse_in, EwaldParameters<useIonIon,useIonDipole,useDipoleDipole> &parameters_in) const {
+					void kVectorChange(Eigen::MatrixXd &kVectors_in, Eigen::VectorXd &Aks_in, vector<complex<double>> &Q_ion_tot_in, vector<complex<double>> &Q_dip_tot_in, int &kVectorsInUse_in, EwaldParameters<useIonIon,useIonDipole,useDipoleDipole> &parameters_in, Eigen::Matrix3Xi &kIndices_in, Point &kUnit_in) const {
 						int kVectorsLength = (2*parameters_in.kcc + 1)*(2*parameters_in.kcc + 1)*(2*parameters_in.kcc + 1) - 1;
+						kUnit_in = 2*pc::pi*Point(1.0/parameters_in.L.x(),1.0/parameters_in.L.y(),1.0/parameters_in.L.z());
 						if(kVectorsLength == 0) {
 							kVectors_in.resize(3, 1); 
+							kIndices_in.setZero(3, 1);
 							Aks_in.resize(1);
 							kVectors_in.col(0) = Point(1.0,0.0,0.0); // Just so it is not the zero-vector
 							Aks_in[0] = 0.0;
@@ -340,6 +649,7 @@ namespace Faunus {
 							return;
 						}
 						kVectors_in.resize(3, kVectorsLength); 
+						kIndices_in.setZero(3, kVectorsLength);
 						Aks_in.resize(kVectorsLength);
 						kVectorsInUse_in = 0;
 						kVectors_in.setZero();
@@ -367,6 +677,7 @@ namespace Faunus {
 										if( (dkx2/parameters_in.kc2) + (dky2/parameters_in.kc2) + (dkz2/parameters_in.kc2) > 1.0)
 											continue;
 									kVectors_in.col(kVectorsInUse_in) = kv; 
+									kIndices_in.col(kVectorsInUse_in) = Eigen::Vector3i(kx,ky,kz);
 									Aks_in[kVectorsInUse_in] = factor*exp(-(k2+parameters_in.kappa*parameters_in.kappa)/(4.0*parameters_in.alpha2))/(k2+parameters_in.kappa*parameters_in.kappa);
 									//Aks_in[kVectorsInUse_in] = factor*exp(-k2/(4.0*parameters_in.alpha2))/k2;
 									kVectorsInUse_in++;
@@ -383,34 +694,119 @@ namespace Faunus {
 					 * @param Q_ion_tot_in Vector of complex numbers for ions
 					 * @param Q_dip_tot_in Vector of complex numbers for dipoles
 					 * @param kVectors_in k-vectors
+					 * @param kIndices_in Integer indices of k-vectors
+					 * @param kUnit_in Reciprocal unit vector, 2*pi/L
 					 * @param kVectorsInUse_in Number of k-vectors (not necessarily the same as the length of 'kVectors_in')
+					 *
+					 * Phase factors are taken from `EwaldPhases` and the sum over particles is vectorised.
+					 * If `spme` is enabled the structure factors are instead interpolated from `EwaldMesh`.
 					 */
-					void updateAllComplexNumbers(const Tpvec &p, vector<complex<double>> &Q_ion_tot_in, vector<complex<double>> &Q_dip_tot_in, const Eigen::MatrixXd &kVectors_in, int kVectorsInUse_in) const {
+					void updateAllComplexNumbers(const Tpvec &p, vector<complex<double>> &Q_ion_tot_in, vector<complex<double>> &Q_dip_tot_in, const Eigen::MatrixXd &kVectors_in, const Eigen::Matrix3Xi &kIndices_in, const Point &kUnit_in, int kVectorsInUse_in) {
+						const bool ions = useIonIon || useIonDipole;
+						const bool dipoles = useDipoleDipole || useIonDipole;
+						const int N = p.size();
+						const int nmax = kVectorsInUse_in > 0 ? kIndices_in.leftCols(kVectorsInUse_in).cwiseAbs().maxCoeff() : 0;
+						if (!parameters.spme)
+							phases.update(p, kUnit_in, nmax);
+						qe.resize(N);
+						mux.resize(N);
+						muy.resize(N);
+						muz.resize(N);
+						for (int i=0; i<N; i++) {
+							qe[i] = p[i].charge*effective_charges.at(p[i].id);
+							Point mu = p[i].mu()*p[i].muscalar();
+							mux[i] = mu.x();
+							muy[i] = mu.y();
+							muz[i] = mu.z();
+						}
+						if (parameters.spme) {
+							mesh.resize(parameters.mesh > 0 ? parameters.mesh : 3*parameters.kcc, parameters.spline_order);
+							if (mesh.size() <= 2*nmax)
+								throw std::runtime_error("Ewald: mesh must be larger than twice the k-vector cut-off");
+							mesh.structureFactors(p, qe, kIndices_in, kUnit_in, kVectorsInUse_in, Q_ion_tot_in, Q_dip_tot_in, ions, dipoles);
+							return;
+						}
+						const double *q = qe.data(), *mx = mux.data(), *my = muy.data(), *mz = muz.data();
 						for (int k=0; k<kVectorsInUse_in; k++) {
-							Point kv = kVectors_in.col(k);
-							complex<double> Q_temp_ion(0.0,0.0);
-							complex<double> Q_temp_dip(0.0,0.0);
-							for (size_t i = 0; i < p.size(); i++) {
-								double dot = kv.dot(p[i]);
-								if( ( useIonIon || useIonDipole ) && !isotropic_pbc ) {
-									Q_temp_ion += p[i].charge * complex<double>(cos(dot),sin(dot))*effective_charges.at(p[i].id);
-								} else if( ( useIonIon || useIonDipole ) && isotropic_pbc ) {
-									Q_temp_ion += p[i].charge*cos(kv.x()*p[i].x())*cos(kv.y()*p[i].y())*cos(kv.z()*p[i].z())*effective_charges.at(p[i].id); 
+							const double kx = kVectors_in(0,k), ky = kVectors_in(1,k), kz = kVectors_in(2,k);
+							const int ny = kIndices_in(1,k), nz = kIndices_in(2,k);
+							const double sy = (ny < 0) ? -1.0 : 1.0, sz = (nz < 0) ? -1.0 : 1.0; // conjugate for negative index
+							const double *xr = &phases.re[0][kIndices_in(0,k)*N], *xi = &phases.im[0][kIndices_in(0,k)*N];
+							const double *yr = &phases.re[1][std::abs(ny)*N], *yi = &phases.im[1][std::abs(ny)*N];
+							const double *zr = &phases.re[2][std::abs(nz)*N], *zi = &phases.im[2][std::abs(nz)*N];
+							double Qr = 0, Qi = 0, Dr = 0, Di = 0;
+							if (!isotropic_pbc) {
+#pragma omp simd reduction(+:Qr,Qi,Dr,Di)
+								for (int i=0; i<N; i++) {
+									double ar = xr[i]*yr[i] - sy*xi[i]*yi[i];
+									double ai = sy*xr[i]*yi[i] + xi[i]*yr[i];
+									double er = ar*zr[i] - sz*ai*zi[i];
+									double ei = sz*ar*zi[i] + ai*zr[i];
+									if (ions) {
+										Qr += q[i]*er;
+										Qi += q[i]*ei;
+									}
+									if (dipoles) {
+										double kmu = kx*mx[i] + ky*my[i] + kz*mz[i];
+										Dr -= kmu*ei;
+										Di += kmu*er;
+									}
 								}
-								if(useDipoleDipole && !isotropic_pbc) {
-									Q_temp_dip += kv.dot(p[i].mu()) * p[i].muscalar() * complex<double>(-sin(dot),cos(dot));
-								} else if(useDipoleDipole && isotropic_pbc) {
-									double xx = spc->p[i].x()*kv.x();
-									double yy = spc->p[i].y()*kv.y();
-									double zz = spc->p[i].z()*kv.z();
-									double cosX = cos(xx);
-									double cosY = cos(yy);
-									double cosZ = cos(zz);
-									Q_temp_dip += ( sin(xx)*cosY*cosZ*spc->p[i].mu().x()*kv.x() + cosX*sin(yy)*cosZ*spc->p[i].mu().y()*kv.y() + cosX*cosY*sin(zz)*spc->p[i].mu().z()*kv.z() )*spc->p[i].muscalar();
+							} else {
+#pragma omp simd reduction(+:Qr,Dr)
+								for (int i=0; i<N; i++) {
+									if (ions)
+										Qr += q[i]*xr[i]*yr[i]*zr[i];
+									if (dipoles)
+										Dr += xi[i]*yr[i]*zr[i]*mx[i]*kx + xr[i]*yi[i]*zr[i]*my[i]*ky + xr[i]*yr[i]*zi[i]*mz[i]*kz;
 								}
 							}
-							Q_ion_tot_in.at(k) = Q_temp_ion;
-							Q_dip_tot_in.at(k) = Q_temp_dip;
+							Q_ion_tot_in.at(k) = complex<double>(Qr,Qi);
+							Q_dip_tot_in.at(k) = complex<double>(Dr,Di);
+						}
+					}
+
+					/**
+					 * @brief Adds (or subtracts) the contribution of a single particle to the vectors of complex numbers
+					 * @param a Particle
+					 * @param sign +1 to add, -1 to subtract
+					 * @param Q_ion_tot_in Vector of complex numbers for ions
+					 * @param Q_dip_tot_in Vector of complex numbers for dipoles
+					 * @param kVectors_in k-vectors
+					 * @param kIndices_in Integer indices of k-vectors
+					 * @param kUnit_in Reciprocal unit vector, 2*pi/L
+					 * @param kVectorsInUse_in Number of k-vectors (not necessarily the same as the length of 'kVectors_in')
+					 */
+					void updateComplexNumbers(const Tparticle &a, double sign, vector<complex<double>> &Q_ion_tot_in, vector<complex<double>> &Q_dip_tot_in, const Eigen::MatrixXd &kVectors_in, const Eigen::Matrix3Xi &kIndices_in, const Point &kUnit_in, int kVectorsInUse_in) {
+						const bool ions = useIonIon || useIonDipole;
+						const bool dipoles = useDipoleDipole || useIonDipole;
+						int nmax = kVectorsInUse_in > 0 ? kIndices_in.leftCols(kVectorsInUse_in).cwiseAbs().maxCoeff() : 0;
+						phase_re.resize(3*(nmax+1));
+						phase_im.resize(3*(nmax+1));
+						double *er[3], *ei[3];
+						for (int d=0; d<3; d++) {
+							er[d] = &phase_re[d*(nmax+1)];
+							ei[d] = &phase_im[d*(nmax+1)];
+							EwaldPhases::recurrence(kUnit_in[d]*a[d], nmax, er[d], ei[d]);
+						}
+						double q = sign * a.charge * effective_charges.at(a.id);
+						Point mu = sign * a.mu() * a.muscalar();
+						for (int k=0; k<kVectorsInUse_in; k++) {
+							const int nx = kIndices_in(0,k), ny = std::abs(kIndices_in(1,k)), nz = std::abs(kIndices_in(2,k));
+							const double sy = (kIndices_in(1,k) < 0) ? -1.0 : 1.0, sz = (kIndices_in(2,k) < 0) ? -1.0 : 1.0;
+							Point kv = kVectors_in.col(k);
+							if (!isotropic_pbc) {
+								complex<double> e = complex<double>(er[0][nx],ei[0][nx]) * complex<double>(er[1][ny],sy*ei[1][ny]) * complex<double>(er[2][nz],sz*ei[2][nz]);
+								if (ions)
+									Q_ion_tot_in[k] += q * e;
+								if (dipoles)
+									Q_dip_tot_in[k] += kv.dot(mu) * complex<double>(-e.imag(),e.real());
+							} else {
+								if (ions)
+									Q_ion_tot_in[k] += q * er[0][nx]*er[1][ny]*er[2][nz];
+								if (dipoles)
+									Q_dip_tot_in[k] += ei[0][nx]*er[1][ny]*er[2][nz]*mu.x()*kv.x() + er[0][nx]*ei[1][ny]*er[2][nz]*mu.y()*kv.y() + er[0][nx]*er[1][ny]*ei[2][nz]*mu.z()*kv.z();
+							}
 						}
 					}
 
@@ -465,6 +861,12 @@ namespace Faunus {
 						} else {
 							o << pad(SUB,w, "Wavefunctions") << kVectorsInUse << " (" << realKvectors << ")" << endl;
 						}
+						if(parameters.spme)
+							o << pad(SUB,w, "Reciprocal method") << "SPME (mesh " << mesh.size() << ", spline order " << parameters.spline_order << ")" << endl;
+						else
+							o << pad(SUB,w, "Reciprocal method") << "Direct sum" << endl;
+						if(!tuning.empty())
+							o << pad(SUB,w, "Tuned for accuracy") << tuning["delta"].get<double>() << " (estimated errors " << tuning["real error"].get<double>() << ", " << tuning["reciprocal error"].get<double>() << ")" << endl;
 						o << pad(SUB,w, "alpha") << parameters.alpha << endl;
 						o << pad(SUB,w, "kappa") << parameters.kappa << endl;
 						o << pad(SUB,w, "Debyelength") << parameters.debyelength << endl;
@@ -509,24 +911,32 @@ namespace Faunus {
 						auto _j = j["energy"]["nonbonded"]["ewald"];
 						cnt_accepted = 0;
 						update_drift = 0.0;
+						kVectorsChanged = true;
 						lB = Tbase::pairpot.first.bjerrumLength();
 						eps_surf = ( _j.at("eps_surf") );
 						const_inf = (eps_surf < 1) ? 0.0 : 1.0;                 // if the value is unphysical (< 1) then we set infinity as the dielectric sonatant of the surronding medium
 						spherical_sum = ( _j.value("spherical_sum",true) );     // specifies if Spherical or Cubical summation should be used in reciprocal space
 						update_frequency = ( _j.value("update_frequency",-1) );
-						parameters.alpha = ( _j.at("alpha") );
+						tuneParameters = ( _j.value("tune",false) );
+						delta = ( _j.value("delta",5e-5) );
+						parameters.alpha = tuneParameters ? _j.value("alpha",0.0) : _j.at("alpha").get<double>();
 						parameters.alpha2 = parameters.alpha*parameters.alpha;
-						parameters.rc = ( _j.at("cutoff") );
-						parameters.kc = ( _j.at("cutoffK") );
+						parameters.rc = tuneParameters ? _j.value("cutoff",1.0) : _j.at("cutoff").get<double>();
+						parameters.kc = tuneParameters ? _j.value("cutoffK",1.0) : _j.at("cutoffK").get<double>();
 						parameters.debyelength = ( _j.at("debyelength") );
 						parameters.kappa = 1.0/parameters.debyelength;
 						parameters.kc2 = parameters.kc*parameters.kc;
 						parameters.kcc = ceil(parameters.kc);
 						isotropic_pbc = ( _j.value("isotropic_pbc",false) );
+						parameters.spme = ( _j.value("method",string("direct")) == "spme" );
+						parameters.mesh = ( _j.value("mesh",0) );
+						parameters.spline_order = ( _j.value("spline_order",6) );
+						if (parameters.spme && isotropic_pbc)
+							throw std::runtime_error("Ewald: 'spme' cannot be combined with 'isotropic_pbc'");
 						Tbase::pairpot.first.updateRcut(parameters.rc);
 						Tbase::pairpot.first.updateAlpha(parameters.alpha);
 						Tbase::pairpot.first.updateKappa(parameters.kappa);
-						kVectorChange(kVectors,Aks,Q_ion_tot,Q_dip_tot,kVectorsInUse,parameters);
+						kVectorChange(kVectors,Aks,Q_ion_tot,Q_dip_tot,kVectorsInUse,parameters,kIndices,kUnit);
 
 
 						effective_charges.resize(atom.size());
@@ -559,7 +969,145 @@ namespace Faunus {
 						Tbase::pairpot.first.updateRcut(parameters.rc);
 						Tbase::pairpot.first.updateAlpha(parameters.alpha);
 						Tbase::pairpot.first.updateKappa(parameters.kappa);
-						kVectorChange(kVectors,Aks,Q_ion_tot,Q_dip_tot,kVectorsInUse,parameters);
+						kVectorChange(kVectors,Aks,Q_ion_tot,Q_dip_tot,kVectorsInUse,parameters,kIndices,kUnit);
+						kVectorsChanged = true;
+					}
+
+					/**
+					 * @brief Tune `alpha`, `cutoff` and `cutoffK` for the current configuration
+					 * @param delta Target RMS error in both real and reciprocal space energy (\f$ e^2/\AA \f$)
+					 *
+					 * For a range of real space cut-offs up to half the box length, `alpha` is chosen so that
+					 * the estimated real space error equals `delta`, and `cutoffK` is the smallest integer
+					 * for which the reciprocal error is below `delta`, see `EwaldParameters::realError()`.
+					 * Each candidate is timed on the current configuration: the reciprocal part by a full
+					 * evaluation with the candidate k-vectors and the real part from the measured time per
+					 * pair and the number of pairs within the cut-off. The fastest candidate is applied.
+					 * Dipoles enter the error estimates as charges weighted by \f$ 2\alpha^2/3 \f$, as in the self energy.
+					 *
+					 * The tolerance is an absolute error in energy, as for the `delta` keyword, rather than a
+					 * relative one since the total electrostatic energy is not known before the parameters are.
+					 * For a relative accuracy \f$ \epsilon \f$ use \f$ \delta = \epsilon |U| / l_B \f$ with
+					 * an estimate of the electrostatic energy \f$ U \f$ in kT.
+					 *
+					 * @returns Chosen parameters, error estimates and timings (seconds per total energy evaluation)
+					 */
+					Tmjson tune(double delta) {
+						using namespace std::chrono;
+						const Tpvec &p = spc->p;
+						const int N = p.size();
+						const int kmax = 40;    // largest cutoffK considered
+						const int sample = std::min(N, 200);
+						parameters.update(spc->geo.len);
+						V = spc->geo.getVolume();
+
+						double Q2q = 0, Q2mu = 0;
+						for (auto &a : p) {
+							if (useIonIon || useIonDipole)
+								Q2q += a.charge*a.charge;
+							if (useDipoleDipole || useIonDipole)
+								Q2mu += a.muscalar()*a.muscalar();
+						}
+						if (Q2q + Q2mu < 1e-20)
+							throw std::runtime_error("Ewald tuning: no charges or dipoles in system");
+
+						// squared distances from a sample of particles, used for counting pairs within cut-off
+						double rcmax = parameters.minL / 2;
+						vector<double> r2;
+						vector<std::pair<int,int>> pairs;
+						for (int n=0; n<sample; n++) {
+							int i = n*N/sample;
+							for (int j=0; j<N; j++) {
+								double d2 = Tbase::geo.sqdist(p[i],p[j]);
+								if (j != i && d2 < rcmax*rcmax) {
+									r2.push_back(d2);
+									pairs.push_back({i,j});
+								}
+							}
+						}
+						std::sort(r2.begin(), r2.end());
+
+						Tbase::pairpot.first.updateAlpha(pc::pi/rcmax);
+						Tbase::pairpot.first.updateRcut(rcmax);
+						double u = 0;
+						auto t0 = steady_clock::now();
+						for (auto &ij : pairs)
+							u += Tbase::pairpot.first(p[ij.first], p[ij.second], Tbase::geo.vdist(p[ij.first], p[ij.second]));
+						double tpair = duration<double>(steady_clock::now() - t0).count() / std::max(size_t(1), pairs.size());
+
+						Tmjson candidates = Tmjson::array();
+						double best = pc::infty;
+						EwaldParameters<useIonIon,useIonDipole,useDipoleDipole> opt = parameters;
+						Eigen::MatrixXd kv;
+						Eigen::Matrix3Xi ki;
+						Eigen::VectorXd aks;
+						Point ku;
+						vector<complex<double>> qi, qd;
+						int nk;
+						for (int n=2; n<=10; n++) {
+							parameters.rc = rcmax * n / 10;
+							double lo = 0.1, hi = 10; // alpha*rc
+							for (int it=0; it<60; it++) {
+								parameters.alpha = (lo+hi) / 2 / parameters.rc;
+								parameters.alpha2 = parameters.alpha*parameters.alpha;
+								double err = parameters.realError(Q2q + 2*parameters.alpha2/3*Q2mu, V);
+								(err > delta ? lo : hi) = parameters.alpha*parameters.rc;
+							}
+							parameters.alpha = hi / parameters.rc;
+							parameters.alpha2 = parameters.alpha*parameters.alpha;
+							double Q2 = Q2q + 2*parameters.alpha2/3*Q2mu;
+							for (parameters.kc=1; parameters.kc<kmax; parameters.kc++)
+								if (parameters.reciprocalError(Q2) < delta)
+									break;
+							if (parameters.reciprocalError(Q2) > delta)
+								continue;
+							parameters.kc2 = parameters.kc*parameters.kc;
+							parameters.kcc = ceil(parameters.kc);
+
+							kVectorChange(kv, aks, qi, qd, nk, parameters, ki, ku);
+							double trecip = pc::infty;
+							for (int rep=0; rep<3; rep++) {
+								t0 = steady_clock::now();
+								updateAllComplexNumbers(p, qi, qd, kv, ki, ku, nk);
+								u += getReciprocalEnergy(qi, qd, aks, V);
+								trecip = std::min(trecip, duration<double>(steady_clock::now() - t0).count());
+							}
+							size_t npairs = std::lower_bound(r2.begin(), r2.end(), parameters.rc*parameters.rc) - r2.begin();
+							double treal = tpair * npairs * N / (2.0*sample);
+
+							candidates.push_back({
+									{"cutoff", parameters.rc}, {"alpha", parameters.alpha}, {"cutoffK", parameters.kc},
+									{"real time", treal}, {"reciprocal time", trecip} });
+							if (treal + trecip < best) {
+								best = treal + trecip;
+								opt = parameters;
+							}
+						}
+						if (best == pc::infty)
+							throw std::runtime_error("Ewald tuning: tolerance cannot be met with cutoffK < " + std::to_string(kmax));
+
+						parameters = opt;
+						updateParameters(opt.alpha, opt.kc, opt.rc);
+						double Q2 = Q2q + 2*opt.alpha2/3*Q2mu;
+						Tmjson js = {
+							{"delta", delta}, {"alpha", opt.alpha}, {"cutoff", opt.rc}, {"cutoffK", opt.kc},
+							{"real error", opt.realError(Q2, V)}, {"reciprocal error", opt.reciprocalError(Q2)},
+							{"time per pair", tpair}, {"candidates", candidates} };
+						volatile double sink = u; // keeps timed evaluations from being optimised away
+						(void) sink;
+						return js;
+					}
+
+					/** @brief Ewald parameters, and result of tuning if performed, as json object */
+					Tmjson json() override {
+						Tmjson js;
+						auto &j = js["ewald"];
+						j = {
+							{"alpha", parameters.alpha}, {"cutoff", parameters.rc}, {"cutoffK", parameters.kc},
+							{"method", parameters.spme ? "spme" : "direct"} };
+						if (!tuning.empty())
+							j["tuning"] = tuning;
+						return js;
 					}
 
 					/**
@@ -570,15 +1118,14 @@ namespace Faunus {
 						kVectorsInUse_trial = kVectorsInUse;
 						surfaceEnergyTrial = surfaceEnergy;
 						reciprocalEnergyTrial = reciprocalEnergy;
-						Q_ion_tot_trial.resize(kVectorsInUse);
-						Q_dip_tot_trial.resize(kVectorsInUse);
-						kVectors_trial.resize(3, kVectorsInUse); 
-						Aks_trial.resize(kVectorsInUse); 
-						for (int k=0; k < kVectorsInUse; k++) {
-							Q_ion_tot_trial.at(k) = Q_ion_tot.at(k);
-							Q_dip_tot_trial.at(k) = Q_dip_tot.at(k);
-							kVectors_trial.col(k) = kVectors.col(k);
-							Aks_trial[k] = Aks[k];
+						Q_ion_tot_trial = Q_ion_tot;
+						Q_dip_tot_trial = Q_dip_tot;
+						if (kVectorsChanged) {
+							kVectors_trial = kVectors;
+							kIndices_trial = kIndices;
+							kUnit_trial = kUnit;
+							Aks_trial = Aks;
+							kVectorsChanged = false;
 						}
 					}
 
@@ -590,15 +1137,14 @@ namespace Faunus {
 						kVectorsInUse = kVectorsInUse_trial;
 						surfaceEnergy = surfaceEnergyTrial;
 						reciprocalEnergy = reciprocalEnergyTrial;
-						Q_ion_tot.resize(kVectorsInUse);
-						Q_dip_tot.resize(kVectorsInUse);
-						kVectors.resize(3, kVectorsInUse);
-						Aks.resize(kVectorsInUse); 
-						for (int k=0; k < kVectorsInUse; k++) {
-							Q_ion_tot.at(k) = Q_ion_tot_trial.at(k);
-							Q_dip_tot.at(k) = Q_dip_tot_trial.at(k);
-							kVectors.col(k) = kVectors_trial.col(k);
-							Aks[k] = Aks_trial[k];
+						Q_ion_tot = Q_ion_tot_trial;
+						Q_dip_tot = Q_dip_tot_trial;
+						if (kVectorsChanged) {
+							kVectors = kVectors_trial;
+							kIndices = kIndices_trial;
+							kUnit = kUnit_trial;
+							Aks = Aks_trial;
+							kVectorsChanged = false;
 						}
 					}
 
@@ -632,7 +1178,7 @@ namespace Faunus {
 
 						if(++cnt_accepted > update_frequency - 1) {
 							double duB = getReciprocalEnergy(Q_ion_tot_trial,Q_dip_tot_trial,Aks_trial,V_trial);                        // Calulate with old vectors/matrices
-							updateAllComplexNumbers(spc->trial, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kVectorsInUse_trial); // Re-calculate the vectors/matrices
+							updateAllComplexNumbers(spc->trial, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kIndices_trial, kUnit_trial, kVectorsInUse_trial); // Re-calculate the vectors/matrices
 							double duA = getReciprocalEnergy(Q_ion_tot_trial,Q_dip_tot_trial,Aks_trial,V_trial);                        // Calulate with new vectors/matrices
 							accept(); 
 							cnt_accepted = 0;
@@ -652,54 +1198,34 @@ namespace Faunus {
 						change = c;
 
 						if(c.geometryChange) {
-							updateAllComplexNumbers(spc->trial, Q_ion_tot_trial, Q_dip_tot_trial,kVectors_trial,kVectorsInUse_trial);
+							kVectorsChanged = true;
+							updateAllComplexNumbers(spc->trial, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kIndices_trial, kUnit_trial, kVectorsInUse_trial);
 							V_trial = V + c.dV;
 							parameters.update(spc->geo_trial.len);
 							return 0.0;
 						}
 
-						// If the volume has not changed
-						for (int k=0; k<kVectorsInUse_trial; k++) {
-							complex<double> Q2_ion = Q_ion_tot.at(k);
-							complex<double> Q2_dip = Q_dip_tot.at(k);
-							for (auto m : change.mvGroup) {
+						// Insertion or deletion of particles - recalculate from scratch
+						if(!c.rmGroup.empty() || !c.inGroup.empty()) {
+							updateAllComplexNumbers(spc->trial, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kIndices_trial, kUnit_trial, kVectorsInUse_trial);
+							return 0.0;
+						}
+
+						// If the volume has not changed only moved particles contribute, i.e. O(Nk*Nmoved)
+						Q_ion_tot_trial = Q_ion_tot;
+						Q_dip_tot_trial = Q_dip_tot;
+						for (auto &m : change.mvGroup) {
+							if (m.second.empty()) { // no index given; whole group has moved
+								for (auto i : *spc->groupList()[m.first]) {
+									updateComplexNumbers(spc->p[i], -1.0, Q_ion_tot_trial, Q_dip_tot_trial, kVectors, kIndices, kUnit, kVectorsInUse);
+									updateComplexNumbers(spc->trial[i], 1.0, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kIndices_trial, kUnit_trial, kVectorsInUse_trial);
+								}
+							} else {
 								for (auto i : m.second) {
-									double dotTrial = kVectors_trial.col(k).dot(spc->trial[i]);
-									double dot = kVectors.col(k).dot(spc->p[i]);
-									if ( ( useIonIon || useIonDipole ) && !isotropic_pbc ) {
-										Q2_ion += spc->trial[i].charge * complex<double>(cos(dotTrial),sin(dotTrial))*effective_charges.at(spc->trial[i].id);
-										Q2_ion -= spc->p[i].charge * complex<double>(cos(dot),sin(dot))*effective_charges.at(spc->p[i].id);
-									} else if( ( useIonIon || useIonDipole ) && isotropic_pbc ) {
-										Point kv = kVectors_trial.col(k);
-										Q2_ion += spc->trial[i].charge*cos(kv.x()*spc->trial[i].x())*cos(kv.y()*spc->trial[i].y())*cos(kv.z()*spc->trial[i].z())*effective_charges.at(spc->trial[i].id); 
-										kv = kVectors.col(k);
-										Q2_ion -= spc->p[i].charge*cos(kv.x()*spc->p[i].x())*cos(kv.y()*spc->p[i].y())*cos(kv.z()*spc->p[i].z())*effective_charges.at(spc->p[i].id); 
-									}
-									if ( ( useDipoleDipole || useIonDipole ) && !isotropic_pbc ) {
-										Q2_dip += kVectors_trial.col(k).dot(spc->trial[i].mu()) * spc->trial[i].muscalar() * complex<double>(-sin(dotTrial),cos(dotTrial));
-										Q2_dip -= kVectors.col(k).dot(spc->p[i].mu()) * spc->p[i].muscalar() * complex<double>(-sin(dot),cos(dot));
-									} else if ( ( useDipoleDipole || useIonDipole ) && isotropic_pbc ) {
-										Point kv = kVectors_trial.col(k);
-										double xx = spc->trial[i].x()*kv.x();
-										double yy = spc->trial[i].y()*kv.y();
-										double zz = spc->trial[i].z()*kv.z();
-										double cosX = cos(xx);
-										double cosY = cos(yy);
-										double cosZ = cos(zz);
-										Q2_dip += ( sin(xx)*cosY*cosZ*spc->trial[i].mu().x()*kv.x() + cosX*sin(yy)*cosZ*spc->trial[i].mu().y()*kv.y() + cosX*cosY*sin(zz)*spc->trial[i].mu().z()*kv.z() )*spc->trial[i].muscalar();
-										kv = kVectors.col(k);
-										xx = spc->p[i].x()*kv.x();
-										yy = spc->p[i].y()*kv.y();
-										zz = spc->p[i].z()*kv.z();
-										cosX = cos(xx);
-										cosY = cos(yy);
-										cosZ = cos(zz);
-										Q2_dip -= ( sin(xx)*cosY*cosZ*spc->p[i].mu().x()*kv.x() + cosX*sin(yy)*cosZ*spc->p[i].mu().y()*kv.y() + cosX*cosY*sin(zz)*spc->p[i].mu().z()*kv.z() )*spc->p[i].muscalar();
-									}
+									updateComplexNumbers(spc->p[i], -1.0, Q_ion_tot_trial, Q_dip_tot_trial, kVectors, kIndices, kUnit, kVectorsInUse);
+									updateComplexNumbers(spc->trial[i], 1.0, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kIndices_trial, kUnit_trial, kVectorsInUse_trial);
 								}
 							}
-							Q_ion_tot_trial.at(k) = Q2_ion;
-							Q_dip_tot_trial.at(k) = Q2_dip;
 						}
 						return 0.0;
 					}
@@ -731,23 +1257,33 @@ namespace Faunus {
 					void setGeometry(typename Tspace::GeometryType &g) override {
 						Tbase::setGeometry(g);
 						parameters.update(g.len);
+						kVectorsChanged = true;
 						if(Tbase::isGeometryTrial(g)) {
 							V_trial = g.getVolume();
-							kVectorChange(kVectors_trial,Aks_trial,Q_ion_tot_trial,Q_dip_tot_trial,kVectorsInUse_trial,parameters);
-							updateAllComplexNumbers(spc->trial,Q_ion_tot_trial,Q_dip_tot_trial,kVectors_trial,kVectorsInUse_trial);
+							kVectorChange(kVectors_trial,Aks_trial,Q_ion_tot_trial,Q_dip_tot_trial,kVectorsInUse_trial,parameters,kIndices_trial,kUnit_trial);
+							updateAllComplexNumbers(spc->trial, Q_ion_tot_trial, Q_dip_tot_trial, kVectors_trial, kIndices_trial, kUnit_trial, kVectorsInUse_trial);
 						} else {
 							V = g.getVolume();
-							kVectorChange(kVectors,Aks,Q_ion_tot,Q_dip_tot,kVectorsInUse,parameters);
-							updateAllComplexNumbers(spc->p,Q_ion_tot,Q_dip_tot,kVectors,kVectorsInUse);
+							kVectorChange(kVectors,Aks,Q_ion_tot,Q_dip_tot,kVectorsInUse,parameters,kIndices,kUnit);
+							updateAllComplexNumbers(spc->p, Q_ion_tot, Q_dip_tot, kVectors, kIndices, kUnit, kVectorsInUse);
 						}
 					}
 
 					/**
 					 * @brief Set space and updates parameters (if not set by user)
+					 *
+					 * If `tune` is set in the input, parameters are tuned for the configuration in `s`.
 					 */
 					void setSpace(Tspace &s) override {
 						Tbase::setSpace(s);
 						N = s.p.size();
+						if (update_frequency < 1)
+							update_frequency = N;
+						if (tuneParameters) {
+							tuning = tune(delta);
+							tuneParameters = false;
+							updateAllComplexNumbers(s.p, Q_ion_tot, Q_dip_tot, kVectors, kIndices, kUnit, kVectorsInUse);
+						}
 						Group g(0, N-1);
 						surfaceEnergy = getSurfaceEnergy(s.p,g,V);
 						reciprocalEnergy = getReciprocalEnergy(Q_ion_tot,Q_dip_tot,Aks,V);
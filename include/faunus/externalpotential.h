@@ -48,6 +48,12 @@ namespace Faunus
 
                     string info() { return _info(); }
 
+                    /** @brief False if the potential is updated during simulation, cf. `Energy::EnergyCache` */
+                    bool isStatic() const { return true; }
+
+                    /** @brief False if `operator()` modifies the potential, cf. `Energy::Energybase::threadSafe()` */
+                    bool threadSafe() const { return true; }
+
                     template<class Tparticle>
                         Point field( const Tparticle & ) { return Point(0, 0, 0); }
 
@@ -251,6 +257,7 @@ namespace Faunus
                 string _info();
             public:
                 CylindricalCorrectionDH( Tmjson&, std::string= "mfc_" );    //!< Constructor
+                bool threadSafe() const { return false; }                   //!< `qdensity` lookup inserts into `Table2D`
                 template<class Tparticle> T operator()( const Tparticle & );//!< External potential on particle
                 template<class Tpvec> void sample( const Tpvec &, T, T );   //!< Sample charge density
         };
@@ -596,10 +603,10 @@ namespace Faunus
                     unsigned int cnt=0;                     //!< Number of charge density updates
                     double dz=0.1;                          //!< z spacing between slits (A)
                     double lB;                              //!< Bjerrum length (A)
-                    Table2D<double, Average<double>> rho;   //!< Charge density at z (unit A^-2)
-                    Table2D<double, double> phi;            //!< External potential at z (unit: beta*e)
+                    FlatTable2D<double, Average<double>> rho;   //!< Charge density at z (unit A^-2)
+                    FlatTable2D<double, double> phi;            //!< External potential at z (unit: beta*e)
 
-                    double getPotential(const Point &a) { return phi(a.z()); }
+                    double getPotential(const Point &a) const { return phi.find(a.z()); }
 
                     //!< This is Eq. 15 of the mol. phys. 1996 paper by Greberg et al.
                     //!< (sign typo in manuscript: phi^infty(z) should be "-2*pi*z" on page 413, middle)
@@ -618,11 +625,13 @@ namespace Faunus
                     }
 
                 public:
+                    bool isStatic() const { return loadfromdisk; } // else updated by sample()
+
                     ExternalAkesson(const Tmjson &j, const string &sec = "gouychapman") {
                         dz = 0.1;
                         lB = 7;
                         phi.load("akesson.dat");
-                        loadfromdisk = phi.getMap().empty() ? false : true;
+                        loadfromdisk = phi.empty() ? false : true;
                         if (loadfromdisk)
                             cout << "loaded akesson.dat" << endl;
                         else
@@ -631,7 +640,7 @@ namespace Faunus
 
                     ~ExternalAkesson() {
                         if (loadfromdisk==false)
-                            if (!phi.getMap().empty())
+                            if (!phi.empty())
                             {
                                 phi.save("akesson.dat");
                                 cout << "saved akesson.dat to disk" << endl;
@@ -663,14 +672,15 @@ namespace Faunus
                                     rho(z) += Q / area; 
                                 }
 
-                                if (slump()>0.99) {
+                                if (slumpStreams()()()>0.99) {
                                     double a=len_half.x();
                                     for (double z=-len_half.z(); z<=len_half.z(); z+=dz) {
                                         double s=0;
-                                        for (double zn=-len_half.z(); zn<=len_half.z(); zn+=dz)
-                                            if (rho(zn).cnt>0)
-                                                s += rho(zn).avg() * phi_ext( std::fabs(z-zn), a );  // Eq. 14 in Greberg paper
-                                            else s+=0;
+                                        for (double zn=-len_half.z(); zn<=len_half.z(); zn+=dz) {
+                                            auto r = rho.find(zn);
+                                            if (r.cnt>0)
+                                                s += r.avg() * phi_ext( std::fabs(z-zn), a );  // Eq. 14 in Greberg paper
+                                        }
                                         phi(z) = lB*s;
                                     }
                                 }
@@ -613,6 +613,266 @@ namespace Faunus
 	    inline void boundary( Point &a ) const override {}
 	};
 
+	/**
+	 * @brief Cell list for neighbour search in cuboidal containers
+	 *
+	 * The container is divided into cells with side lengths equal to or
+	 * larger than the cutoff so that all particles within the cutoff of a
+	 * point are found in the surrounding 27 cells. Periodic directions
+	 * are wrapped, while non-periodic directions (`z` in `Cuboidslit` and
+	 * all directions in `CuboidNoPBC`) are not. Neighbouring cells are
+	 * stored without duplicates so that small boxes with only one or two
+	 * cells in a direction are handled correctly.
+	 *
+	 * Particles can be relocated one at a time which makes the list
+	 * suitable for Monte Carlo where only few particles move in each step.
+	 * Only geometries derived from `Cuboid` are supported and `build()`
+	 * returns false for all others.
+	 *
+	 * Example:
+	 *
+	 * ~~~~
+	 * Geometry::CellList<Geometry::Cuboid> cells;
+	 * if ( cells.build(spc.geo, spc.p, 12.0) )
+	 *   cells.forEach( spc.p[i], [&](int j) { ... } );
+	 * ~~~~
+	 */
+	template<class Tgeometry>
+	class CellList
+	{
+	    private:
+		typedef std::is_base_of<Cuboid, Tgeometry> Tsupported;
+		double rc;                                 // cutoff
+		Point len, len_half, cellLen;              // box and cell side lengths
+		int n[3];                                  // number of cells in each direction
+		bool periodic[3];                          // periodicity in each direction
+		vector<vector<int>> cells;                 // particle indices in each cell
+		vector<vector<int>> nb;                    // neighbouring cells of each cell (incl. self)
+		vector<int> cellOf;                        // cell of each particle
+		vector<int> slot;                          // position of each particle in its cell
+
+		static bool boxLength( const Tgeometry &geo, Point &l, std::true_type )
+		{
+		    l = geo.len;
+		    return true;
+		}
+
+		static bool boxLength( const Tgeometry &, Point &, std::false_type ) { return false; }
+
+		int cellIndex( const Point &a ) const
+		{
+		    int c[3];
+		    for ( int d = 0; d < 3; d++ )
+		    {
+			c[d] = int(std::floor((a[d] + len_half[d]) / cellLen[d]));
+			if ( periodic[d] )
+			{
+			    c[d] %= n[d];
+			    if ( c[d] < 0 )
+				c[d] += n[d];
+			}
+			else
+			    c[d] = std::max(0, std::min(c[d], n[d] - 1));
+		    }
+		    return c[0] + n[0] * (c[1] + n[1] * c[2]);
+		}
+
+		void add( int i, int c )
+		{
+		    cellOf[i] = c;
+		    slot[i] = cells[c].size();
+		    cells[c].push_back(i);
+		}
+
+		void remove( int i )
+		{
+		    auto &v = cells[cellOf[i]];
+		    int last = v.back();
+		    v[slot[i]] = last;
+		    slot[last] = slot[i];
+		    v.pop_back();
+		}
+
+	    public:
+		CellList() : rc(0) {}
+
+		/** @brief True if the list has been built */
+		bool empty() const { return cells.empty(); }
+
+		/** @brief Number of indexed particles */
+		size_t size() const { return cellOf.size(); }
+
+		/** @brief Cutoff used to build the list */
+		double cutoff() const { return rc; }
+
+		/** @brief True if built for given geometry and number of particles */
+		bool isValid( const Tgeometry &geo, size_t N ) const
+		{
+		    Point l;
+		    return !empty() && N == size() && boxLength(geo, l, Tsupported()) && l == len;
+		}
+
+		/** @brief Total number of cells */
+		int numCells() const { return n[0] * n[1] * n[2]; }
+
+		/** @brief Average number of particles visited in `forEach()` */
+		double neighbourEstimate() const
+		{
+		    return empty() ? double(size()) : double(size()) * nb.front().size() / numCells();
+		}
+
+		/** @brief Remove all particles and cells */
+		void clear()
+		{
+		    cells.clear();
+		    nb.clear();
+		    cellOf.clear();
+		    slot.clear();
+		}
+
+		/**
+		 * @brief Build cell list for all particles in `p`
+		 * @param geo Geometry (must derive from `Cuboid`)
+		 * @param p Particle vector
+		 * @param cutoff Neighbour cutoff (angstrom)
+		 * @returns False if the geometry or cutoff cannot be handled
+		 */
+		template<class Tpvec>
+		bool build( const Tgeometry &geo, const Tpvec &p, double cutoff )
+		{
+		    clear();
+		    if ( !boxLength(geo, len, Tsupported()) || !(cutoff > 0) || !(cutoff < pc::infty) )
+			return false;
+		    rc = cutoff;
+		    len_half = 0.5 * len;
+		    periodic[0] = periodic[1] = periodic[2] = !std::is_base_of<CuboidNoPBC, Tgeometry>::value;
+		    if ( std::is_base_of<Cuboidslit, Tgeometry>::value )
+			periodic[2] = false;
+
+		    // limit the number of cells to avoid excessive memory use for tiny cutoffs
+		    size_t maxcells = 8 * p.size() + 27;
+		    for ( int d = 0; d < 3; d++ )
+			n[d] = std::max(1, int(std::min(len[d] / rc, 1024.)));
+		    while ( size_t(n[0]) * n[1] * n[2] > maxcells )
+			--*std::max_element(n, n + 3);
+		    for ( int d = 0; d < 3; d++ )
+			cellLen[d] = len[d] / n[d];
+
+		    cells.resize(numCells());
+		    nb.resize(numCells());
+		    for ( int cz = 0; cz < n[2]; cz++ )
+			for ( int cy = 0; cy < n[1]; cy++ )
+			    for ( int cx = 0; cx < n[0]; cx++ )
+			    {
+				auto &v = nb[cx + n[0] * (cy + n[1] * cz)];
+				int c[3] = {cx, cy, cz};
+				for ( int dz = -1; dz <= 1; dz++ )
+				    for ( int dy = -1; dy <= 1; dy++ )
+					for ( int dx = -1; dx <= 1; dx++ )
+					{
+					    int m[3] = {c[0] + dx, c[1] + dy, c[2] + dz};
+					    bool inside = true;
+					    for ( int d = 0; d < 3; d++ )
+						if ( m[d] < 0 || m[d] >= n[d] )
+						{
+						    if ( periodic[d] )
+							m[d] = (m[d] + n[d]) % n[d];
+						    else
+							inside = false;
+						}
+					    if ( inside )
+						v.push_back(m[0] + n[0] * (m[1] + n[1] * m[2]));
+					}
+				std::sort(v.begin(), v.end());
+				v.erase(std::unique(v.begin(), v.end()), v.end());
+			    }
+
+		    cellOf.resize(p.size());
+		    slot.resize(p.size());
+		    for ( size_t i = 0; i < p.size(); i++ )
+			add(i, cellIndex(p[i]));
+		    return true;
+		}
+
+		/** @brief Relocate particle `i` to new position `a` */
+		void update( int i, const Point &a )
+		{
+		    assert(i >= 0 && i < (int) size());
+		    int c = cellIndex(a);
+		    if ( c != cellOf[i] )
+		    {
+			remove(i);
+			add(i, c);
+		    }
+		}
+
+		/**
+		 * @brief Call `f(j)` for all indexed particles in cells neighbouring `a`
+		 *
+		 * All particles within the cutoff are visited, but so are particles
+		 * further away and the caller is responsible for any distance check.
+		 * Each particle is visited once.
+		 */
+		template<class Tfunc>
+		void forEach( const Point &a, Tfunc f ) const
+		{
+		    assert(!empty());
+		    for ( auto c : nb[cellIndex(a)] )
+			for ( auto j : cells[c] )
+			    f(j);
+		}
+	};
+
+	/**
+	 * @brief Squared distances between a point and packed coordinates
+	 *
+	 * Minimum image distances from `a` to particles `[first,last)` stored
+	 * in separate `x`, `y`, and `z` arrays are written to `r2`. The loop
+	 * is free of branches so that it can be vectorised by the compiler
+	 * and periodicity is resolved at compile time. Only for geometries
+	 * derived from `Cuboid`; results are identical to `sqdist()`.
+	 */
+	template<class Tgeometry>
+	void sqdistPacked( const Tgeometry &geo, const Point &a, const double *x, const double *y,
+		const double *z, double *r2, int first, int last )
+	{
+	    static_assert(std::is_base_of<Cuboid, Tgeometry>::value, "Cuboid geometry required");
+	    const bool pbcxy = !std::is_base_of<CuboidNoPBC, Tgeometry>::value;
+	    const bool pbcz = pbcxy && !std::is_base_of<Cuboidslit, Tgeometry>::value;
+	    const double ax = a.x(), ay = a.y(), az = a.z();
+	    const double lx = geo.len.x(), ly = geo.len.y(), lz = geo.len.z();
+	    const double hx = geo.len_half.x(), hy = geo.len_half.y(), hz = geo.len_half.z();
+#pragma omp simd
+	    for ( int j = first; j < last; j++ )
+	    {
+		double dx = ax - x[j], dy = ay - y[j], dz = az - z[j];
+		if ( pbcxy )
+		{
+		    dx += (dx > hx) ? -lx : ((dx < -hx) ? lx : 0);
+		    dy += (dy > hy) ? -ly : ((dy < -hy) ? ly : 0);
+		}
+		if ( pbcz )
+		    dz += (dz > hz) ? -lz : ((dz < -hz) ? lz : 0);
+		r2[j] = dx * dx + dy * dy + dz * dz;
+	    }
+	}
+
+	/**
+	 * @brief Factor by which `scale()` changes all distances, or NaN if anisotropic
+	 *
+	 * If the positions as well as the side lengths are scaled with the same
+	 * arguments, all (minimum image) distances change by the returned factor.
+	 */
+	template<class Tgeometry>
+	double isotropicScaling( const Tgeometry &geo, Point dir, double xyz, double xy )
+	{
+	    Point a(1, 1, 1);
+	    geo.scale(a, dir, xyz, xy);
+	    if ( std::fabs(a.y() - a.x()) > 1e-12 * a.x() || std::fabs(a.z() - a.x()) > 1e-12 * a.x())
+		return std::numeric_limits<double>::quiet_NaN();
+	    return a.x();
+	}
+
 	/**
 	 * @brief Cylindrical simulation container
 	 *
@@ -698,6 +958,22 @@ namespace Faunus
 		}
 	};
 
+	/**
+	 * @brief Upper bound for the distance between two points in `geo`
+	 *
+	 * Half the diagonal for periodic cuboids, the largest minimum image
+	 * distance for slits, and otherwise the diagonal of the inscribing
+	 * cuboid, see `Geometrybase::inscribe()`.
+	 */
+	inline double maxDistance( const Geometrybase &geo )
+	{
+	    if ( auto slit = dynamic_cast<const Cuboidslit *>(&geo))
+		return Point(slit->len.x() / 2, slit->len.y() / 2, slit->len.z()).norm();
+	    if ( auto box = dynamic_cast<const Cuboid *>(&geo))
+		return box->len.norm() / 2;
+	    return geo.inscribe().len.norm();
+	}
+
 	/**
 	 * @brief Calculate center of cluster of particles
 	 * @param geo Geometry
@@ -1058,12 +1334,13 @@ namespace Faunus
 
 		// Start shooting!
 		Point r;
+		auto &ran = slumpStreams()();
 		unsigned int hit = 0, cnt = 0;
 		while ( ++cnt < n )
 		{
-		    r.x() = slump.half();
-		    r.y() = slump.half();
-		    r.z() = slump.half();
+		    r.x() = ran.half();
+		    r.y() = ran.half();
+		    r.z() = ran.half();
 		    r = r * L + gc;
 		    for ( auto &i : p )
 			if ((i - r).squaredNorm() < pow(i.radius + pradius, 2))
@@ -129,7 +129,7 @@ namespace Faunus
 	    int random() const
 	    {
 		if ( !empty())
-		    return *slump.element(begin(), end());
+		    return *slumpStreams()().element(begin(), end());
 		return -1;
 	    }
 
@@ -14,6 +14,15 @@
 #endif
 #include <xdrfile/xdrfile_trr.h>
 #include <xdrfile/xdrfile_xtc.h>
+#include <cstdio>
+#include <cstdint>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define FAU_MMAP
+#endif
 
 #endif
 #include <xdrfile/xdrfile_trr.h>
@@ -71,6 +80,90 @@ namespace Faunus {
 				else ++iter;
 		}
 
+		/**
+		 * @brief 64-bit FNV-1a checksum of a memory block
+		 * @param h Checksum of preceding blocks, if any
+		 */
+		inline uint64_t checksum(const void *data, size_t n, uint64_t h=14695981039346656037ULL) {
+			auto c = static_cast<const unsigned char*>(data);
+			for (size_t i=0; i<n; i++)
+				h = (h ^ c[i]) * 1099511628211ULL;
+			return h;
+		}
+
+		/**
+		 * @brief Write binary data atomically
+		 *
+		 * The data is written to `file.tmp` which is then renamed to `file`.
+		 * An existing `file` is thus either left untouched or completely replaced.
+		 */
+		inline bool writeFileAtomic(const string &file, const string &s) {
+			string tmp = file + ".tmp";
+			std::ofstream f(tmp.c_str(), std::ios_base::out | std::ios_base::binary);
+			if (f) {
+				f.write(s.data(), s.size());
+				f.close();
+				if (f && std::rename(tmp.c_str(), file.c_str())==0)
+					return true;
+			}
+			std::remove(tmp.c_str());
+			return false;
+		}
+
+		/**
+		 * @brief Read-only view of a whole file
+		 *
+		 * The file is memory mapped where supported (POSIX) and
+		 * otherwise read into memory. `data()` is `nullptr` if the
+		 * file could not be opened.
+		 */
+		class MappedFile {
+			private:
+				const char *ptr;
+				size_t n;
+				string buffer;
+				bool mapped;
+			public:
+				MappedFile(const string &file) : ptr(nullptr), n(0), mapped(false) {
+#ifdef FAU_MMAP
+					int fd = ::open(file.c_str(), O_RDONLY);
+					if (fd>=0) {
+						struct stat st;
+						if (::fstat(fd, &st)==0 && st.st_size>0) {
+							void *m = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+							if (m!=MAP_FAILED) {
+								ptr = static_cast<const char*>(m);
+								n = st.st_size;
+								mapped = true;
+							}
+						}
+						::close(fd);
+					}
+					if (mapped)
+						return;
+#endif
+					std::ifstream f(file.c_str(), std::ios_base::in | std::ios_base::binary);
+					if (f) {
+						buffer.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+						ptr = buffer.data();
+						n = buffer.size();
+					}
+				}
+
+				~MappedFile() {
+#ifdef FAU_MMAP
+					if (mapped)
+						::munmap(const_cast<char*>(ptr), n);
+#endif
+				}
+
+				MappedFile(const MappedFile&) = delete;
+				MappedFile &operator=(const MappedFile&) = delete;
+
+				const char *data() const { return ptr; } //!< File content (`nullptr` if not opened)
+				size_t size() const { return n; }        //!< File size in bytes
+		};
+
 	}//namespace
 
 	/**
@@ -40,6 +40,7 @@ namespace Faunus
 
       Tpvec operator()( Geometry::Geometrybase &geo, const Tpvec &p, TMoleculeData &mol )
       {
+          auto &ran = slumpStreams()();
           bool _overlap = true;
           Tpvec v;
           int cnt = 0;
@@ -56,10 +57,10 @@ namespace Faunus
                   { // for each atom type id
                       Geometry::QuaternionRotate rot;
                       Point u;
-                      u.ranunit(slump);
+                      u.ranunit(ran);
                       if ( rotate )
                       {
-                          rot.setAxis(geo, {0, 0, 0}, u, 2 * pc::pi * slump());
+                          rot.setAxis(geo, {0, 0, 0}, u, 2 * pc::pi * ran());
                           i.rotate(rot);
                       }
                       geo.randompos(i);
@@ -82,8 +83,8 @@ namespace Faunus
                       a = a.cwiseProduct(dir);       // apply user defined directions (default: 1,1,1)
                       Geometry::cm2origo(geo, v);    // translate to origo - obey boundary conditions
                       Geometry::QuaternionRotate rot;
-                      b.ranunit(slump);              // random unit vector
-                      rot.setAxis(geo, {0, 0, 0}, b, slump() * 2 * pc::pi); // random rot around random vector
+                      b.ranunit(ran);              // random unit vector
+                      rot.setAxis(geo, {0, 0, 0}, b, ran() * 2 * pc::pi); // random rot around random vector
                       for ( auto &i : v )
                       {            // apply rotation to all points
                           if ( rotate )
@@ -246,7 +247,7 @@ namespace Faunus
           assert(size_t(confDist.max()) == conformations.size() - 1);
           assert(atoms.size() == conformations.front().size());
 
-          _confid = confDist(slump.eng); // store the index of the conformation
+          _confid = confDist(slumpStreams()().eng); // store the index of the conformation
           return conformations.at( _confid );
       }
 
@@ -369,7 +370,7 @@ namespace Faunus
                       a = Point(0, 0, 0);
                   else
                   {
-                      u.ranunit(slump);   // position randomly
+                      u.ranunit(slumpStreams()());   // position randomly
                       a = v.back() + req * u; // around previous particle
                   }
                   v.push_back(a);
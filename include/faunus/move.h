@@ -132,6 +132,8 @@ namespace Faunus
                 template<typename Tenergy, typename Tparticles>
                     void induceDipoles( Tenergy &pot, Tparticles &p )
                     {
+                        static_assert(hasDipole<typename Tparticles::value_type>::value,
+                                "PolarizeMove requires particles with dipole moments");
 
                         int cnt = 0;
                         Eigen::VectorXd mu_err_norm((int) p.size());
@@ -201,7 +203,10 @@ namespace Faunus
                 {
                     Tmove::_acceptMove();
                     if ( updateDip )
+                    {
                         Tmove::spc->p = Tmove::spc->trial;
+                        Tmove::pot->cache.clear(); // induced dipoles changed everywhere
+                    }
                 }
 
                 string _info() override
@@ -352,11 +357,16 @@ namespace Faunus
                         }
                     }
 
-                    /** @brief Internal, deterministic random number generator, independent of global */
+                    /**
+                     * @brief Internal, deterministic random number generator, independent of global
+                     *
+                     * OpenMP threads other than the master draw from their own stream.
+                     */
                     static RandomTwister<> &_slump()
                     {
                         static RandomTwister<> r;
-                        return r;
+                        static RandomStreams<> streams(r, "move");
+                        return streams();
                     }
 
                 public:
@@ -456,7 +466,7 @@ namespace Faunus
                 if ( !mollist.empty())
                 {
                     auto it = _slump().element(mollist.begin(), mollist.end());
-                    auto g = spc->findMolecules(it->first); // vector of group pointers
+                    auto &g = spc->findMolecules(it->first); // vector of group pointers (no copy)
                     if ( !g.empty())
                         gPtr = *_slump().element(g.begin(), g.end());
                 }
@@ -479,12 +489,14 @@ namespace Faunus
             {
                 cnt_accepted++;
                 _acceptMove();
+                pot->cache.accept(change);
             }
 
         template<class Tspace>
             void Movebase<Tspace>::rejectMove()
             {
                 _rejectMove();
+                pot->cache.reject();
             }
 
         /** @return Energy change in units of kT */
@@ -531,6 +543,7 @@ namespace Faunus
                     while ( n-- > 0 )
                     {
                         trialMove();
+                        spc->syncPacked(change);
                         pot->updateChange(change);
 
                         double du = energyChange();
@@ -545,6 +558,7 @@ namespace Faunus
                             dusum += du;
                             utot += du;
                         }
+                        spc->syncPacked(change);
                         utot += pot->update(acceptance);
                         change.clear();
                     }
@@ -820,7 +834,7 @@ namespace Faunus
             {
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -1326,7 +1340,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -1624,7 +1638,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -1833,7 +1847,7 @@ namespace Faunus
 
                 void _trialMove() override
                 {
-                    auto gvec = spc->findMolecules(base::currentMolId);
+                    auto &gvec = spc->findMolecules(base::currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(igroup != nullptr); // make sure we really found a group
@@ -2132,6 +2146,7 @@ namespace Faunus
                 using base::dir2;
                 Geometry::QuaternionRotate vrot;
                 vector<int> cindex; //!< index of mobile ions to move with group
+                IndexSet imoved;    //!< index of cluster and main group particles
                 void _trialMove() override;
                 void _acceptMove() override;
                 void _rejectMove() override;
@@ -2216,7 +2231,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -2278,9 +2293,10 @@ namespace Faunus
             double TranslateRotateCluster<Tspace>::_energyChange()
             {
                 double bias = 1;             // cluster bias -- see Frenkel 2nd ed, p.405
-                vector<int> imoved = cindex; // index of moved particles
+                imoved.clear();              // index of moved particles
+                imoved.insert(cindex.begin(), cindex.end());
                 for ( auto l : *gmobile )    // mobile index, "l", NOT in cluster (Frenkel's "k" is the main group)
-                    if ( std::find(cindex.begin(), cindex.end(), l) == cindex.end())
+                    if ( !imoved.count(l))
                         bias *= (1 - ClusterProbability(spc->trial, l)) / (1 - ClusterProbability(spc->p, l));
                 avgbias += bias;
                 if ( bias < 1e-7 )
@@ -2289,8 +2305,7 @@ namespace Faunus
                 if ( dp_rot < 1e-6 && dp_trans < 1e-6 )
                     return 0;
 
-                for ( auto i : *igroup )     // Add macromolecule to list of moved particle index
-                    imoved.push_back(i);
+                imoved.insert(igroup->begin(), igroup->end()); // add macromolecule to moved particles
 
                 // container boundary collision?
                 for ( auto i : imoved )
@@ -2311,11 +2326,10 @@ namespace Faunus
                 }
 
                 // pair energy between static and moved particles
-                // note: this could be optimized!
                 double du = 0;
 #pragma omp parallel for reduction (+:du)
                 for ( int j = 0; j < (int) spc->p.size(); j++ )
-                    if ( std::find(imoved.begin(), imoved.end(), j) == imoved.end())
+                    if ( !imoved.count(j))
                         for ( auto i : imoved )
                             du += pot->i2i(spc->trial, i, j) - pot->i2i(spc->p, i, j);
                 return unew - uold + du - log(bias); // exp[ -( dU-log(bias) ) ] = exp(-dU)*bias
@@ -2469,7 +2483,7 @@ namespace Faunus
                         continue;
                     // molecule type 'i' is not prohibited from being in the cluster around molecule 'g'
 
-                    auto gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
+                    auto &gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
                     for( auto g0 : gvec) { 			// For every molecule of type 'i' ...
                         for(auto index : *g0) { 	// For every atom in molecule ...
                             if ( ClusterProbability(*g,spc->p, index) > slump()) {
@@ -2502,7 +2516,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -2954,7 +2968,7 @@ namespace Faunus
                         continue;
                     // molecule type 'i' is not prohibited from being in the cluster around molecule 'g'
 
-                    auto gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
+                    auto &gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
                     for( auto g0 : gvec) { 			// For every molecule of type 'i' ...
                         for(auto index : *g0) { 	// For every atom in molecule ...
                             if ( ClusterProbability(*g,spc->p, index) > slump()) {
@@ -2987,7 +3001,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -3407,7 +3421,7 @@ namespace Faunus
                         continue;
                     // molecule type 'i' is not prohibited from being in the cluster around molecule 'g'
 
-                    auto gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
+                    auto &gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
                     for( auto g0 : gvec) { 			// For every molecule of type 'i' ...
                         for(auto index : *g0) { 	// For every atom in molecule ...
                             if ( ClusterProbability(*g,spc->p, index) > slump()) {
@@ -3440,7 +3454,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -3890,7 +3904,7 @@ namespace Faunus
                         continue;
                     // molecule type 'i' is not prohibited from being in the cluster around molecule 'g'
 
-                    auto gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
+                    auto &gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
                     for( auto g0 : gvec) { 			// For every molecule of type 'i' ...
                         for(auto index : *g0) { 	// For every atom in molecule ...
                             if ( ClusterProbability(*g,spc->p, index) > slump()) {
@@ -3923,7 +3937,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -4291,7 +4305,7 @@ namespace Faunus
                         continue;
                     // molecule type 'i' is not prohibited from being in the cluster around molecule 'g'
 
-                    auto gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
+                    auto &gvec = spc->findMolecules(cntI); 	// Find all molecules of type 'i'
                     for( auto g0 : gvec) { 			// For every molecule of type 'i' ...
                         for(auto index : *g0) { 	// For every atom in molecule ...
                             if ( ClusterProbability(*g,spc->p, index) > slump()) {
@@ -4324,7 +4338,7 @@ namespace Faunus
                 // Note that `currentMolId` is set by Movebase::move()
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     igroup = *slump.element(gvec.begin(), gvec.end());
                     assert(!igroup->empty());
@@ -5068,7 +5082,7 @@ namespace Faunus
 
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     assert(!gvec.empty());
                     gPtr = *slump.element(gvec.begin(), gvec.end());
                     assert(!gPtr->empty());
@@ -5302,7 +5316,7 @@ namespace Faunus
                 gPtr = nullptr;
                 if ( !this->mollist.empty())
                 {
-                    auto gvec = spc->findMolecules(this->currentMolId);
+                    auto &gvec = spc->findMolecules(this->currentMolId);
                     if ( !gvec.empty())
                     {
                         gPtr = *slump.element(gvec.begin(), gvec.end());
@@ -5419,6 +5433,12 @@ namespace Faunus
          * Note that new volumes are generated according to
          * \f$ V^{\prime} = \exp\left ( \log V \pm \delta dp \right ) \f$
          * where \f$\delta\f$ is a random number between zero and one half.
+         *
+         * If all groups are atomic and the geometry is scaled isotropically,
+         * the change in pair energy is taken from `Energybase::scaledPairChange()`
+         * if available, i.e. from the pair energies of the current volume summed
+         * per power of r. Otherwise, or for molecular groups, all pair energies
+         * are calculated in both volumes, see `Energy::GroupPairSum`.
          */
         template<class Tspace>
             class Isobaric : public Movebase<Tspace>
@@ -5432,6 +5452,7 @@ namespace Faunus
                 void _acceptMove() override;
                 void _rejectMove() override;
                 template<class Tpvec> double _energy( const Tpvec & );
+                template<class Tpvec> double _external( const Tpvec & );
                 double _energyChange() override;
                 using base::spc;
                 using base::pot;
@@ -5446,6 +5467,8 @@ namespace Faunus
                 Average<double> msd;       //!< Mean squared volume displacement
                 Average<double> val;          //!< Average volume
                 Average<double> rval;         //!< Average 1/volume
+                double scaling;               //!< Isotropic scaling factor of trial or NaN
+                Energy::GroupPairSum pairSum;
             public:
                 template<typename Tenergy>
                     Isobaric( Tenergy &, Tspace &, Tmjson & );
@@ -5537,6 +5560,7 @@ namespace Faunus
                 Point s = Point(1, 1, 1);
                 double xyz = cbrt(newval / oldval);
                 double xy = sqrt(newval / oldval);
+                scaling = Geometry::isotropicScaling(spc->geo, s, xyz, xy);
                 newlen.scale(spc->geo, s, xyz, xy);
                 for ( auto g : spc->groupList())
                 {
@@ -5546,22 +5570,9 @@ namespace Faunus
 
                 spc->geo_trial.setlen(newlen);
 
-                // register all moved groups in change object
-                int i = 0;
-                for ( auto gPtr : spc->groupList())
-                {
-                    if (gPtr->isAtomic())
-                    {
-                        change.mvGroup[i].resize(gPtr->size());
-                        std::iota( change.mvGroup[i].begin(), change.mvGroup[i].end(), gPtr->front());
-                        assert(gPtr->size() == int(change.mvGroup[i].size()));
-                        assert(gPtr->front() == change.mvGroup[i].front());
-                        assert(gPtr->back() == change.mvGroup[i].back());
-                    }
-                    else
-                        change.mvGroup[i].clear();
-                    i++;
-                }
+                // register all groups as moved; empty index = all particles
+                for ( size_t i = 0; i < spc->groupList().size(); i++ )
+                    change.mvGroup[i].clear();
                 change.geometryChange = true;
                 change.dV = newval - oldval;
             }
@@ -5593,33 +5604,66 @@ namespace Faunus
 
         /**
          * This will calculate the total energy of the configuration
-         * associated with the current Hamiltonian volume
+         * associated with the current Hamiltonian volume. Internal
+         * energies of molecular groups are left out as these are
+         * not affected by scaling.
          */
         template<class Tspace>
             template<class Tpvec>
             double Isobaric<Tspace>::_energy( const Tpvec &p )
             {
-                double u = 0;
                 if ( dp < 1e-6 )
-                    return u;
-                size_t n = spc->groupList().size();  // number of groups
-                for ( size_t i = 0; i < n - 1; ++i )      // group-group
-                    for ( size_t j = i + 1; j < n; ++j )
-                        u += pot->g2g(p, *spc->groupList()[i], *spc->groupList()[j]);
+                    return 0;
+                auto &g = spc->groupList();
+                pot->prepare(p);
+                double u = _external(p);
+                for ( auto i : g )
+                    if ( i->numMolecules() > 1 )
+                        u += pot->g_internal(p, *i);
+                return u + pairSum(g, [&]( int i, int j ) { return pot->g2g(p, *g[j], *g[i]); }, pot->threadSafe());
+            }
 
+        /** @brief Energy of all groups with external potentials, `external()` and `g_external()` */
+        template<class Tspace>
+            template<class Tpvec>
+            double Isobaric<Tspace>::_external( const Tpvec &p )
+            {
+                double u = pot->external(p);
                 for ( auto g : spc->groupList())
-                {
                     u += pot->g_external(p, *g);
-                    if ( g->numMolecules() > 1 )
-                        u += pot->g_internal(p, *g);
-                }
-                return u + pot->external(p);
+                return u;
             }
 
         template<class Tspace>
             double Isobaric<Tspace>::_energyChange()
             {
-                return Energy::energyChange(*spc, *pot, change);
+                if ( !change.geometryChange )
+                    return Energy::energyChange(*spc, *pot, change);
+
+                auto &g = spc->groupList();
+                double du = std::numeric_limits<double>::quiet_NaN();
+                if ( !std::isnan(scaling) && std::all_of(g.begin(), g.end(), []( Group *i ) { return i->isAtomic(); }))
+                    du = pot->scaledPairChange(scaling);
+                bool full = std::isnan(du); // pair energies must be calculated
+
+                auto backup = spc->geo;
+                spc->geo = spc->geo_trial;  // trial geometry
+                pot->setSpace(*spc);
+                double unew = 0;
+                for ( auto i : g )          // container overlap
+                    for ( auto j : *i )
+                        if ( spc->geo.collision(spc->trial[j], spc->trial[j].radius, Geometry::Geometrybase::BOUNDARY))
+                            unew = pc::infty;
+                if ( unew < pc::infty )
+                    unew = full ? _energy(spc->trial) : _external(spc->trial);
+                spc->geo = backup;
+                pot->setSpace(*spc);
+
+                if ( unew == pc::infty )
+                    return pc::infty;
+                if ( full )
+                    return unew - _energy(spc->p);
+                return du + unew - _external(spc->p);
             }
 
         /**
@@ -5876,41 +5920,24 @@ namespace Faunus
 
                         for ( auto &p : trial_insert ) //assign random positions
                             spc->geo.randompos(p);
+                        base::change.inGroup[spc->findIndex(saltPtr)] = trial_insert;
                         break;
 
                     case 1: // attempt to delete
 
-                        vector<int> vecA = spc->atomTrack[ida]; // vector of ida index
-                        vector<int> vecB = spc->atomTrack[idb]; // vector of idb index
-
-                        if ( vecA.size() < Na || vecB.size() < Nb )
+                        if ( spc->atomTrack.size(ida) < Na || spc->atomTrack.size(idb) < Nb )
                             return; // abort - not enough particles to delete
 
                         trial_delete.reserve(Na + Nb);
+                        spc->atomTrack.find(ida, Na, trial_delete); // Na random, unique ida particles
+                        spc->atomTrack.find(idb, Nb, trial_delete); // Nb random, unique idb particles
 
-                        while ( trial_delete.size() != Na )
-                        {
-                            assert(!vecA.empty());
-                            auto it = slump.element(vecA.begin(), vecA.end()); // random ida particle
-                            int i = *it;
-                            vecA.erase(it);
-
-                            assert(ida == spc->p[i].id && "id mismatch");
-
-                            trial_delete.push_back(i);
-                        }
-                        while ( trial_delete.size() != Na + Nb )
-                        {
-                            assert(!vecB.empty());
-                            auto it = slump.element(vecB.begin(), vecB.end()); // random ida particle
-                            int i = *it;
-                            vecB.erase(it);
-
-                            assert(idb == spc->p[i].id && "id mismatch" );
-
-                            trial_delete.push_back(i);
-                        }
+#ifndef NDEBUG
+                        for ( size_t k = 0; k < trial_delete.size(); k++ )
+                            assert((k < Na ? ida : idb) == spc->p[trial_delete[k]].id && "id mismatch");
+#endif
                         assert( trial_delete.size() == Na + Nb);
+                        base::change.rmGroup[spc->findIndex(saltPtr)] = trial_delete;
                         break;
                 }
             }
@@ -5979,7 +6006,7 @@ namespace Faunus
             void GrandCanonicalSalt<Tspace>::_acceptMove()
             {
                 int Nold = 0;
-                auto v = spc->findMolecules(saltmolid);
+                auto &v = spc->findMolecules(saltmolid);
                 if (!v.empty()) {
                     assert( v.front()==saltPtr );
                     Nold = v.front()->size();
@@ -7778,7 +7805,7 @@ namespace Faunus
                             if (val.is_string())
                                 jsonfile = val;
 
-                        base::_slump().eng = slump.eng; // seed from global slump() instance
+                        base::_slump().seed(slump.eng); // seed from global slump() instance
 
                         if ( i.key() == "random" )
                             if (val.is_object()) {
@@ -7850,6 +7877,8 @@ namespace Faunus
                 if ( mPtr.empty())
                     throw std::runtime_error("No moves defined - check JSON file.");
 
+                randomStates().add("move", base::_slump().eng); // saved in binary state files
+
                 // Bind function to calculate initial system energy
                 using std::ref;
                 ufunction = std::bind(
@@ -175,6 +175,7 @@ namespace Faunus {
       MPI_Comm_size(comm, &_nproc);
       MPI_Comm_rank(comm, &_rank);
       id=std::to_string(_rank);
+      slumpStreams().setRank(_rank);
       textio::prefix += "mpi" + id + ".";
       cout.open(textio::prefix+"stdout");
     }
@@ -461,11 +461,6 @@ namespace Faunus
 	Tmw mw;                                   //!< Molecular weight
 	Thydrophobic hydrophobic;                 //!< Hydrophobic flag
 
-	Tensor<double> zeroT;
-	Point zeroP;
-	double zeroD;
-	bool trueD;
-
 	PointParticle() { clear(); }              //!< Constructor
 
 	template<typename OtherDerived>
@@ -482,42 +477,31 @@ namespace Faunus
 
 	Tcharge q() const { return charge; }
 
-	Point mu() const { return zeroP; }
-	Point mup() const { return zeroP; }
-	double muscalar() const { return zeroD; }
-	Point& mu() { return zeroP; }
-	Point& mup() { return zeroP; }
-	double& muscalar() { return zeroD; }
-
-	Point cap_center_point() const { return zeroP; } 
-	Point charge_position() const { return zeroP; }
-	double cap_radius() const { return zeroD; }
-	double cap_center() const { return zeroD; }
-	double angle_p() const { return zeroD; }
-	double angle_c() const { return zeroD; }
-	bool is_sphere() const { return trueD; }
-	Point& cap_center_point() { return zeroP; } 
-	Point& charge_position() { return zeroP; }
-	double& cap_radius() { return zeroD; }
-	double& cap_center() { return zeroD; }
-	double& angle_p() { return zeroD; }
-	double& angle_c() { return zeroD; }
-	bool& is_sphere() { return trueD; }
-	Tensor<double> alpha() const { return zeroT; }
-	Tensor<double> theta() const { return zeroT; }
-	
-	Point lv() const { return zeroP; } 
-	Point wv() const { return zeroP; } 
-	Point dv() const { return zeroP; } 
-	double length() const { return zeroD; }
-	double width() const { return zeroD; }
-	double depth() const { return zeroD; }
-	Point& lv() { return zeroP; } 
-	Point& wv() { return zeroP; }
-	Point& dv() { return zeroP; }
-	double& length() { return zeroD; }
-	double& width() { return zeroD; }
-	double& depth() { return zeroD; }
+	/*
+	 * Properties of anisotropic particles. Point particles have none, so
+	 * these are read-only and return zero (`true` for `is_sphere()`).
+	 * Generic code that writes them should check e.g. `hasDipole<T>`.
+	 */
+	Point mu() const { return Point(0, 0, 0); }
+	Point mup() const { return Point(0, 0, 0); }
+	double muscalar() const { return 0; }
+
+	Point cap_center_point() const { return Point(0, 0, 0); }
+	Point charge_position() const { return Point(0, 0, 0); }
+	double cap_radius() const { return 0; }
+	double cap_center() const { return 0; }
+	double angle_p() const { return 0; }
+	double angle_c() const { return 0; }
+	bool is_sphere() const { return true; }
+	Tensor<double> alpha() const { return Tensor<double>(); }
+	Tensor<double> theta() const { return Tensor<double>(); }
+
+	Point lv() const { return Point(0, 0, 0); }
+	Point wv() const { return Point(0, 0, 0); }
+	Point dv() const { return Point(0, 0, 0); }
+	double length() const { return 0; }
+	double width() const { return 0; }
+	double depth() const { return 0; }
 
 	template<class T,
 	    class = typename std::enable_if<std::is_base_of<AtomData, T>::value>::type>
@@ -578,9 +562,6 @@ namespace Faunus
 	    charge = mw = radius = alphax = 0;
 	    hydrophobic = false;
 	    id = 0;
-	    zeroP = Point(0,0,0);
-	    zeroD = 0.0;
-	    trueD = true;
 	}
 
     };
@@ -1537,5 +1518,16 @@ namespace Faunus
 		}
     };
 
+    /**
+     * @brief Determines if a particle type stores a dipole moment
+     *
+     * If true, `mu()`, `mup()`, `muscalar()` and `alpha()` return mutable
+     * references. For other particles these are read-only zeros inherited
+     * from `PointParticle`.
+     */
+    template<class T> struct hasDipole : std::false_type {};
+    template<> struct hasDipole<DipoleParticle> : std::true_type {};
+    template<> struct hasDipole<DipCapParticle> : std::true_type {};
+
 }//namespace
 #endif
@@ -1565,6 +1565,39 @@ namespace Faunus {
 			double x(r6(a.radius+b.radius,r2));
 			return eps*(x*x - x);
 		    }
+
+		/** @brief Exponents of the terms written by `terms()`, see `isHomogeneous` */
+		vector<int> powers() const { return {12, 6}; }
+
+		/** @brief Energy of the repulsive and attractive terms written to `u[0]` and `u[1]`; returns `u+2` */
+		template<class Tparticle>
+		    double* terms(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+			double x(r6(a.radius+b.radius,r2));
+			u[0] = eps*x*x;
+			u[1] = -eps*x;
+			return u+2;
+		    }
+
+		/** @brief Energy in kT and force on `a` written to `f`, see `hasEnergyForce` */
+		template<class Tparticle>
+		    double energyForce(const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f) const {
+			double x(r6(a.radius+b.radius,r2));
+			f = 6.*eps*(2*x*x - x) / r2 * p;
+			return eps*(x*x - x);
+		    }
+
+		/** @brief Summed energy in kT between `a` and packed particles `[first,last)` */
+		template<class Tparticle, class Tpacked>
+		    double sum(const Tparticle &a, const Tpacked &s, const double *r2, int first, int last) const {
+			const double *radius = s.radius.data();
+			double u=0;
+#pragma omp simd reduction(+:u)
+			for (int j=first; j<last; j++) {
+			    double x(r6(a.radius+radius[j],r2[j]));
+			    u += eps*(x*x - x);
+			}
+			return u;
+		    }
 		template<class Tparticle>
 		    double operator() (const Tparticle &a, const Tparticle &b, const Point &r) {
 			return operator()(a,b,r.squaredNorm());
@@ -2039,6 +2072,44 @@ namespace Faunus {
 			    return eps(a.id,b.id) * (x*x - x);
 			}
 
+		    /** @brief Exponents of the terms written by `terms()`, see `isHomogeneous` */
+		    vector<int> powers() const { return {12, 6}; }
+
+		    /** @brief Energy of the repulsive and attractive terms written to `u[0]` and `u[1]`; returns `u+2` */
+		    template<class Tparticle>
+			double* terms(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+			    double x=s2(a.id,b.id)/r2;
+			    x=x*x*x;
+			    u[0] = eps(a.id,b.id) * x*x;
+			    u[1] = -eps(a.id,b.id) * x;
+			    return u+2;
+			}
+
+		    /** @brief Energy in kT and force on `a` written to `f`, see `hasEnergyForce` */
+		    template<class Tparticle>
+			double energyForce(const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f) const {
+			    double x=s2(a.id,b.id)/r2;
+			    x=x*x*x;
+			    double e=eps(a.id,b.id);
+			    f = 6.*e*(2*x*x - x) / r2 * p;
+			    return e * (x*x - x);
+			}
+
+		    /** @brief Summed energy in kT between `a` and packed particles `[first,last)` */
+		    template<class Tparticle, class Tpacked>
+			double sum(const Tparticle &a, const Tpacked &s, const double *r2, int first, int last) const {
+			    const int *id = s.id.data();
+			    const double *s2a = s2.m[a.id].data(), *epsa = eps.m[a.id].data();
+			    double u=0;
+#pragma omp simd reduction(+:u)
+			    for (int j=first; j<last; j++) {
+				double x=s2a[id[j]]/r2[j];
+				x=x*x*x;
+				u += epsa[id[j]] * (x*x - x);
+			    }
+			    return u;
+			}
+
 		    template<typename Tparticle>
 			Point force(const Tparticle &a, const Tparticle &b, double r2, const Point &p) {
 			    double s6=_powi<3>( s2(a.id,b.id) );
@@ -2543,6 +2614,35 @@ namespace Faunus {
 		    return operator()(a,b,r.squaredNorm());
 		}
 
+	    /** @brief Exponents of the terms written by `terms()`, see `isHomogeneous` */
+	    vector<int> powers() const { return {1}; }
+
+	    /** @brief Energy written to `u[0]`; returns `u+1` */
+	    template<class Tparticle>
+		double* terms(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+		    u[0] = operator()(a,b,r2);
+		    return u+1;
+		}
+
+	    /**
+	     * @brief Summed energy in kT between `a` and packed particles `[first,last)`
+	     * @param s Packed particles, see `ParticleSoA`
+	     * @param r2 Squared distances with same indexing as `s`
+	     */
+	    template<class Tparticle, class Tpacked>
+		double sum(const Tparticle &a, const Tpacked &s, const double *r2, int first, int last) const {
+		    const double *q = s.charge.data();
+		    double lBqa = lB*a.charge, u=0;
+#pragma omp simd reduction(+:u)
+		    for (int j=first; j<last; j++)
+#ifdef FAU_APPROXMATH
+			u += lBqa*q[j] * invsqrtQuake(r2[j]);
+#else
+			u += lBqa*q[j] / sqrt(r2[j]);
+#endif
+		    return u;
+		}
+
 	    template<class Tparticle>
 		Point force(const Tparticle &a, const Tparticle &b, double r2, const Point &p) {
 #ifdef FAU_APPROXMATH
@@ -2552,6 +2652,20 @@ namespace Faunus {
 #endif
 		}
 
+	    /** @brief Energy in kT and force on `a` written to `f` from a single square root, see `hasEnergyForce` */
+	    template<class Tparticle>
+		double energyForce(const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f) const {
+#ifdef FAU_APPROXMATH
+		    double u = lB*a.charge*b.charge * invsqrtQuake(r2);
+		    f = u / r2 * p;
+		    return u;
+#else
+		    double lBqq = lB*a.charge*b.charge, r = sqrt(r2);
+		    f = lBqq * p / (r*r2);
+		    return lBqq / r;
+#endif
+		}
+
 	    /** @brief Electric field at `r` due to charge `p`
 	     * Gets returned in [e/Å] (\f$\beta eE \f$)
 	     */
@@ -3322,6 +3436,24 @@ namespace Faunus {
 #endif
 		    }
 
+		/** @brief Summed energy in kT between `a` and packed particles `[first,last)` */
+		template<class Tparticle, class Tpacked>
+		    double sum(const Tparticle &a, const Tpacked &s, const double *r2, int first, int last) const {
+			const double *q = s.charge.data();
+			double lBqa = lB * a.charge, u=0;
+#pragma omp simd reduction(+:u)
+			for (int j=first; j<last; j++) {
+#ifdef FAU_APPROXMATH
+			    double rinv = invsqrtQuake(r2[j]);
+			    u += lBqa * q[j] * rinv * exp_cawley(-k/rinv);
+#else
+			    double r=sqrt(r2[j]);
+			    u += lBqa * q[j] / r * exp(-k*r);
+#endif
+			}
+			return u;
+		    }
+
 		double entropy(double, double) const;         //!< Returns the interaction entropy
 		double ionicStrength() const;                 //!< Returns the ionic strength (mol/l)
 		double debyeLength() const;                   //!< Returns the Debye screening length (angstrom)
@@ -3340,6 +3472,22 @@ namespace Faunus {
 #endif
 		    }
 
+		/** @brief Energy in kT and force on `a` written to `f` sharing the exponential, see `hasEnergyForce` */
+		template<class Tparticle>
+		    double energyForce(const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f) const {
+			double lBqq = lB * a.charge * b.charge;
+#ifdef FAU_APPROXMATH
+			double rinv = invsqrtQuake(r2);
+			double u = lBqq * rinv * exp_cawley(-k/rinv);
+			f = u * ( 1/r2 + k*rinv ) * p;
+			return u;
+#else
+			double r=sqrt(r2), e=exp(-k*r);
+			f = lBqq / (r*r2) * e * ( 1 + k*r ) * p;
+			return lBqq / r * e;
+#endif
+		    }
+
 		template<class Tparticle>
 		    double operator() (const Tparticle &a, const Tparticle &b, const Point &r) {
 			return operator()(a,b,r.squaredNorm());
@@ -3645,28 +3793,58 @@ namespace Faunus {
 			}
 	    };
 
+	/** @brief Position of `T` in `Ts...`, or -1 if not found */
+	template<class T, class... Ts> struct typeIndex : std::integral_constant<int,-1> {};
+	template<class T, class... Ts> struct typeIndex<T,T,Ts...> : std::integral_constant<int,0> {};
+	template<class T, class U, class... Ts> struct typeIndex<T,U,Ts...> :
+	    std::integral_constant<int, (typeIndex<T,Ts...>::value<0) ? -1 : 1+typeIndex<T,Ts...>::value> {};
+
 	/**
 	 * @brief Custom potentials between specific particle types
 	 *
 	 * If the pair is not recognized, i.e. not added with the
 	 * `add()` function, the `Tdefault` pair potential is used.
+	 * Pairs are resolved through a dense `atom.size()`^2 table
+	 * indexed by the particle id's so that no tree lookup is made
+	 * for each pair.
+	 *
+	 * Added potentials of the types listed in `Tpairpots` are stored
+	 * by value and called directly after a switch on the type.
+	 * Potentials of other types are wrapped in `std::function`.
 	 *
 	 * Example:
 	 *
-	 *     PotentialMap<CoulombLJ> pot(...);
+	 *     PotentialMap<CoulombLJ, PointParticle, double, ChargeNonpolar> pot(...);
 	 *     pot.add( atom["Na"].id ,atom["CH4"].id, ChargeNonpolar(...) );
 	 *     pot.add( atom["Cl"].id ,atom["CH4"].id, ChargeNonpolar(...) );
 	 */
-	template<typename Tdefault, typename Tparticle=PointParticle, typename Tdist=double>
+	template<typename Tdefault, typename Tparticle=PointParticle, typename Tdist=double, typename... Tpairpots>
 	    class PotentialMap : public Tdefault {
 		protected:
 		    typedef opair<int> Tpair;
 		    typedef std::function<double(const Tparticle&,const Tparticle&,Tdist)> Tfunc;
 		    typedef std::function<Point(const Tparticle&,const Tparticle&,double,const Point&)> Tforce;
-		    std::map<Tpair,Tfunc> m;
-		    std::map<Tpair,Tforce> mforce;
+		    typedef std::integral_constant<int, sizeof...(Tpairpots)> Tother; // type of potentials in `func`
+
+		    struct Entry {
+			int type;  // position in `Tpairpots`; `Tother::value` for `func`
+			int index; // index among potentials of that type
+		    };
+
+		    std::tuple<std::vector<Tpairpots>...> pots; // added potentials of listed types
+		    std::vector<Tfunc> func;     // added potentials of other types
+		    std::vector<Tforce> mforce;  // ...and their forces
+		    std::vector<Entry> m;        // added potentials
+		    std::vector<Tpair> pairs;    // ...and their id pairs
+		    std::vector<int> slot;       // index in `m` for all id pairs; -1 for default
+		    size_t nid;                  // number of id's in `slot`
 		    std::string _info; // info for the added potentials (before turning into functors)
 
+		    /** @brief Index of added potential for id pair, -1 if default */
+		    int find(int i, int j) const {
+			return ( size_t(i)<nid && size_t(j)<nid ) ? slot[i*nid+j] : -1;
+		    }
+
 		    // Force function object wrapper class
 		    template<class Tpairpot>
 			struct ForceFunctionObject {
@@ -3677,34 +3855,92 @@ namespace Faunus {
 			    }
 			};
 
+		    template<class Tpairpot, int I>
+			Entry store(const Tpairpot &pot, std::integral_constant<int,I>) {
+			    auto &v = std::get<I>(pots);
+			    v.push_back(pot);
+			    return {I, int(v.size())-1};
+			}
+
+		    template<class Tpairpot>
+			Entry store(const Tpairpot &pot, std::integral_constant<int,-1>) {
+			    func.push_back(pot);
+			    mforce.push_back( ForceFunctionObject<Tpairpot>(pot) );
+			    return {Tother::value, int(func.size())-1};
+			}
+
+		    template<int I>
+			double energy(const Entry &e, const Tparticle &a, const Tparticle &b, const Tdist &r2, std::integral_constant<int,I>) {
+			    if (e.type==I)
+				return std::get<I>(pots)[e.index](a,b,r2);
+			    return energy(e, a, b, r2, std::integral_constant<int,I+1>());
+			}
+
+		    double energy(const Entry &e, const Tparticle &a, const Tparticle &b, const Tdist &r2, Tother) {
+			return func[e.index](a,b,r2);
+		    }
+
+		    template<int I>
+			Point force(const Entry &e, const Tparticle &a, const Tparticle &b, double r2, const Point &p, std::integral_constant<int,I>) {
+			    if (e.type==I)
+				return std::get<I>(pots)[e.index].force(a,b,r2,p);
+			    return force(e, a, b, r2, p, std::integral_constant<int,I+1>());
+			}
+
+		    Point force(const Entry &e, const Tparticle &a, const Tparticle &b, double r2, const Point &p, Tother) {
+			return mforce[e.index](a,b,r2,p);
+		    }
+
+		    /** @brief Energy from k'th added potential */
+		    double energy(int k, const Tparticle &a, const Tparticle &b, const Tdist &r2) {
+			return energy(m[k], a, b, r2, std::integral_constant<int,0>());
+		    }
+
 		public:
-		    PotentialMap(Tmjson &j) : Tdefault(j) {
+		    PotentialMap(Tmjson &j) : Tdefault(j), nid(0) {
 			Tdefault::name += " (default)";
 		    }
 
 		    /**
-		     * @warning Templating `Tpairpot` may cause code-bloat if used on
-		     * many different potentials
+		     * @brief Add pair potential between two atom types
+		     * @return Index of the pair potential
+		     *
+		     * Adding a potential for an already added pair replaces it.
 		     */
 		    template<class Tpairpot>
-			void add(AtomData::Tid id1, AtomData::Tid id2, Tpairpot pot) {
+			int add(AtomData::Tid id1, AtomData::Tid id2, Tpairpot pot) {
 			    pot.name=atom[id1].name + "<->" + atom[id2].name + ": " + pot.name;
 			    _info+="\n  " + pot.name + ":\n" + pot.info(20);
-			    m[Tpair(id1,id2)] = pot;
-			    mforce[Tpair(id1,id2)] = ForceFunctionObject<decltype(pot)>(pot);
+			    if ( nid < atom.size() ) { // grow table, keeping added pairs
+				nid = atom.size();
+				slot.assign(nid*nid, -1);
+				for ( size_t k=0; k<pairs.size(); k++ ) {
+				    slot[pairs[k].first*nid + pairs[k].second] = k;
+				    slot[pairs[k].second*nid + pairs[k].first] = k;
+				}
+			    }
+			    int k = find(id1,id2);
+			    if ( k<0 ) {
+				k = m.size();
+				m.resize(k+1);
+				pairs.push_back( Tpair(id1,id2) );
+				slot[id1*nid + id2] = slot[id2*nid + id1] = k;
+			    }
+			    m[k] = store(pot, std::integral_constant<int, typeIndex<Tpairpot,Tpairpots...>::value>());
+			    return k;
 			}
 
 		    double operator()(const Tparticle &a, const Tparticle &b, const Tdist &r2) {
-			auto i=m.find( Tpair(a.id,b.id) );
-			if (i!=m.end())
-			    return i->second(a,b,r2);
+			int k=find(a.id,b.id);
+			if (k>=0)
+			    return energy(k,a,b,r2);
 			return Tdefault::operator()(a,b,r2);
 		    }
 
 		    Point force(const Tparticle &a, const Tparticle &b, double r2, const Point &p) {
-			auto i=mforce.find( Tpair(a.id,b.id) );
-			if (i!=mforce.end())
-			    return i->second(a,b,r2,p);
+			int k=find(a.id,b.id);
+			if (k>=0)
+			    return force(m[k],a,b,r2,p,std::integral_constant<int,0>());
 			return Tdefault::force(a,b,r2,p);
 		    }
 
@@ -3770,6 +4006,25 @@ namespace Faunus {
 			    return first(a,b,r2) + second(a,b,r2);
 			}
 
+		    /** @brief Summed energy between `a` and packed particles, see `hasPackedSum` */
+		    template<class Tparticle, class Tpacked>
+			double sum(const Tparticle &a, const Tpacked &s, const double *r2, int beg, int end) const {
+			    return first.sum(a,s,r2,beg,end) + second.sum(a,s,r2,beg,end);
+			}
+
+		    /** @brief Exponents of the terms of `first` followed by those of `second`, see `isHomogeneous` */
+		    vector<int> powers() const {
+			auto v = first.powers();
+			auto w = second.powers();
+			v.insert(v.end(), w.begin(), w.end());
+			return v;
+		    }
+
+		    template<class Tparticle>
+			double* terms(const Tparticle &a, const Tparticle &b, double r2, double *u) const {
+			    return second.terms(a,b,r2,first.terms(a,b,r2,u));
+			}
+
 		    template<typename Tparticle>
 			Point force(const Tparticle &a, const Tparticle &b, double r2, const Point &p) {
 			    return first.force(a,b,r2,p) + second.force(a,b,r2,p);
@@ -3801,6 +4056,102 @@ namespace Faunus {
 		    }
 	    };
 
+	/**
+	 * @brief Determines if a pair potential has a vectorisable `sum()`
+	 *
+	 * `sum(a,s,r2,first,last)` returns the summed energy between particle `a`
+	 * and the particles `[first,last)` of a packed particle vector (`ParticleSoA`)
+	 * with precomputed squared distances. The trait is specialized for the
+	 * exact potential types only, since derived potentials such as `CoulombWolf`
+	 * have other energy functions.
+	 */
+	template<class T> struct hasPackedSum : std::false_type {};
+	template<> struct hasPackedSum<Coulomb> : std::true_type {};
+	template<> struct hasPackedSum<DebyeHuckel> : std::true_type {};
+	template<> struct hasPackedSum<LennardJones> : std::true_type {};
+	template<class T> struct hasPackedSum<LennardJonesMixed<T>> : std::true_type {};
+	template<class T1, class T2> struct hasPackedSum<CombinedPairPotential<T1,T2>> :
+	    std::integral_constant<bool, hasPackedSum<T1>::value && hasPackedSum<T2>::value> {};
+
+	/**
+	 * @brief Determines if a pair potential is a sum of terms homogeneous in r
+	 *
+	 * Such potentials, @f$ u(r) = \sum_k c_k r^{-n_k} @f$, have `powers()` which
+	 * returns the exponents @f$ n_k @f$ and `terms(a,b,r2,u)` which writes the
+	 * energy of each term to `u[k]` and returns the end of the written range.
+	 * If all distances are scaled by @f$ s @f$, term @f$ k @f$ changes by a
+	 * factor @f$ s^{-n_k} @f$ so that the energy of a scaled configuration
+	 * follows from the summed terms of the unscaled one, see
+	 * `Energy::Nonbonded::scaledPairChange()`.
+	 * As for `hasPackedSum` only exact types are specialized.
+	 */
+	template<class T> struct isHomogeneous : std::false_type {};
+	template<> struct isHomogeneous<Coulomb> : std::true_type {};
+	template<> struct isHomogeneous<LennardJones> : std::true_type {};
+	template<class T> struct isHomogeneous<LennardJonesMixed<T>> : std::true_type {};
+	template<class T1, class T2> struct isHomogeneous<CombinedPairPotential<T1,T2>> :
+	    std::integral_constant<bool, isHomogeneous<T1>::value && isHomogeneous<T2>::value> {};
+
+	/**
+	 * @brief Determines if the energy of a pair potential may be evaluated concurrently
+	 *
+	 * False for potentials that modify themselves in `operator()`, such as
+	 * `PotentialTabulate` which builds its tables on first use. Used by
+	 * `Energy::Nonbonded::threadSafe()`.
+	 */
+	template<class T> struct isThreadSafe : std::true_type {};
+	template<class T1, class T2> struct isThreadSafe<CombinedPairPotential<T1,T2>> :
+	    std::integral_constant<bool, isThreadSafe<T1>::value && isThreadSafe<T2>::value> {};
+
+	/**
+	 * @brief Determines if a pair potential has a fused `energyForce()`
+	 *
+	 * `energyForce(a,b,r2,p,f)` returns the energy and writes the force on `a`
+	 * to `f`, sharing square roots and exponentials between the two. As for
+	 * `hasPackedSum` only exact types are specialized. Use the free function
+	 * `energyForce()` below, which falls back to `operator()` and `force()`
+	 * for other potentials.
+	 */
+	template<class T> struct hasEnergyForce : std::false_type {};
+	template<> struct hasEnergyForce<Coulomb> : std::true_type {};
+	template<> struct hasEnergyForce<DebyeHuckel> : std::true_type {};
+	template<> struct hasEnergyForce<LennardJones> : std::true_type {};
+	template<class T> struct hasEnergyForce<LennardJonesMixed<T>> : std::true_type {};
+
+	template<class Tpairpot, class Tparticle>
+	    double energyForce(Tpairpot &pot, const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f, std::true_type) {
+		return pot.energyForce(a,b,r2,p,f);
+	    }
+
+	template<class Tpairpot, class Tparticle>
+	    double energyForce(Tpairpot &pot, const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f, std::false_type) {
+		f = pot.force(a,b,r2,p);
+		return pot(a,b,r2);
+	    }
+
+	/**
+	 * @brief Pair energy (kT) and force on `a` (kT/angstrom) from a single distance evaluation
+	 * @param pot Pair potential
+	 * @param a First particle
+	 * @param b Second particle
+	 * @param r2 Squared distance between them (angstrom squared)
+	 * @param p Distance vector, `Geometry::vdist(a,b)`
+	 * @param f Force on `a` (output)
+	 */
+	template<class Tpairpot, class Tparticle>
+	    double energyForce(Tpairpot &pot, const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f) {
+		return energyForce(pot,a,b,r2,p,f,hasEnergyForce<Tpairpot>());
+	    }
+
+	template<class T1, class T2, class Tparticle>
+	    double energyForce(CombinedPairPotential<T1,T2> &pot, const Tparticle &a, const Tparticle &b, double r2, const Point &p, Point &f) {
+		Point f2;
+		double u = energyForce(pot.first,a,b,r2,p,f);
+		u += energyForce(pot.second,a,b,r2,p,f2);
+		f += f2;
+		return u;
+	    }
+
 	/**
 	 * @brief Creates a new pair potential with opposite sign
 	 */
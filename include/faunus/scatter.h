@@ -3,6 +3,9 @@
 
 #include <faunus/common.h>
 #include <faunus/inputfile.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace Faunus
 {
@@ -158,6 +161,27 @@ namespace Faunus
 
     };
 
+/**
+ * @brief Groups particles with identical form factors for the histogram mode of `DebyeFormula`
+ *
+ * Returns an integer that is the same for particles with the same F(q);
+ * by default the atom type. Specialize for form factors depending on
+ * other properties.
+ */
+    template<class Tformfactor>
+    struct FormFactorClass
+    {
+        template<class Tparticle>
+        int operator()( const Tparticle &a ) const { return a.id; }
+    };
+
+    template<class T>
+    struct FormFactorClass<FormFactorUnity<T>>
+    {
+        template<class Tparticle>
+        int operator()( const Tparticle & ) const { return 0; }
+    };
+
 /**
  * @brief Calculates scattering intensity, I(q) using the Debye formula
  *
@@ -168,8 +192,19 @@ namespace Faunus
  *
  * - `qmin` Minimum q value (1/angstrom)
  * - `qmax` Maximum q value (1/angstrom)
- * - `dr` q spacing (1/angstrom)
+ * - `dq` q spacing (1/angstrom)
  * - `cutoff` Cutoff distance (angstrom). *Experimental!*
+ * - `histogram` Use pair distance histogram (default: false)
+ * - `dr` Histogram resolution (default: 0.01 angstrom)
+ *
+ * By default the sum over pairs is evaluated for each q value at a
+ * cost of O(N^2 Nq). With `histogram`, the pair distances are first
+ * binned for each pair of form factor classes (`FormFactorClass`)
+ * and I(q) is obtained from the bin centres at a cost of
+ * O(N^2) + O(Nbins Nq). Pairs are summed in parallel over a fixed
+ * number of blocks so that results are independent of the number
+ * of threads. Bins span `cutoff` or, if smaller, the extent of the
+ * particles and are allocated once per thread and reused between samples.
  *
  * See also <http://dx.doi.org/10.1016/S0022-2860(96)09302-7>
  */
@@ -177,7 +212,177 @@ namespace Faunus
     class DebyeFormula
     {
     private:
-        T qmin, qmax, dq, rc;
+        T qmin, qmax, dq, rc, dr;
+        bool useHistogram;  // bin pair distances before transforming to I(q)
+        int nblocks;        // number of blocks of rows summed in parallel
+        vector<T> qgrid;    // q values of current sample
+        size_t nbins;       // number of histogram bins, kept between samples
+        vector<vector<double>> hist; // pair distance histograms of each thread, reused between samples
+        static const size_t maxbins = 10000000; // upper bound for `nbins`
+
+        /** @brief Call `f(i,k)` for rows `i` in `[0,n)` split over interleaved blocks `k`, in parallel */
+        template<class Tfunc>
+        void rows( int n, Tfunc f ) const
+        {
+#pragma omp parallel for schedule (dynamic)
+            for ( int k = 0; k < nblocks; k++ )
+                for ( int i = k; i < n; i += nblocks )
+                    f(i, k);
+        }
+
+        /** @brief Sum of F_i F_j sinc(q r_ij) over pairs and of F_i^2 (`self`) for each q */
+        template<class Tpvec>
+        vector<T> pairSum( const Tpvec &p, vector<T> &self )
+        {
+            int N = p.size(), nq = qgrid.size();
+            vector<T> ff(N * nq); // F(q) of each particle
+            for ( int i = 0; i < N; i++ )
+                for ( int k = 0; k < nq; k++ )
+                    ff[i * nq + k] = F(qgrid[k], p[i]);
+            self.assign(nq, 0);
+            for ( int i = 0; i < N; i++ )
+                for ( int k = 0; k < nq; k++ )
+                    self[k] += pow(ff[i * nq + k], 2);
+
+            vector<T> partial(nblocks * nq, 0);
+            rows(N - 1, [&]( int i, int blk ) {
+                T *s = partial.data() + blk * nq;
+                const T *fi = ff.data() + i * nq;
+                for ( int j = i + 1; j < N; ++j )
+                {
+                    T r = geo.sqdist(p[i], p[j]);
+                    if ( r < rc * rc )
+                    {
+                        r = sqrt(r);
+                        const T *fj = ff.data() + j * nq;
+                        for ( int k = 0; k < nq; k++ )
+                        {
+                            T q = qgrid[k];
+                            s[k] += fi[k] * fj[k] * sin(q * r) / (q * r);
+                        }
+                    }
+                }
+            });
+            vector<T> sum(nq, 0);
+            for ( int blk = 0; blk < nblocks; blk++ )
+                for ( int k = 0; k < nq; k++ )
+                    sum[k] += partial[blk * nq + k];
+            return sum;
+        }
+
+        /** @brief Index of calling OpenMP thread */
+        static int thread()
+        {
+#ifdef _OPENMP
+            return omp_get_thread_num();
+#else
+            return 0;
+#endif
+        }
+
+        /** @brief As `pairSum()` but via a pair distance histogram for each pair of form factor classes */
+        template<class Tpvec>
+        vector<T> pairSumHistogram( const Tpvec &p, vector<T> &self )
+        {
+            int N = p.size(), nq = qgrid.size();
+
+            FormFactorClass<Tformfactor> classOf;
+            vector<int> keys, rep, cls(N), n; // key, representative particle and size of each class
+            for ( int i = 0; i < N; i++ )
+            {
+                int key = classOf(p[i]);
+                auto it = std::find(keys.begin(), keys.end(), key);
+                cls[i] = it - keys.begin();
+                if ( it == keys.end())
+                {
+                    keys.push_back(key);
+                    rep.push_back(i);
+                    n.push_back(0);
+                }
+                n[cls[i]]++;
+            }
+            int nc = keys.size();
+            vector<int> pairIndex(nc * nc); // histogram of class pair, symmetric
+            for ( int c1 = 0, m = 0; c1 < nc; c1++ )
+                for ( int c2 = c1; c2 < nc; c2++, m++ )
+                    pairIndex[c1 * nc + c2] = pairIndex[c2 * nc + c1] = m;
+            int npairs = nc * (nc + 1) / 2;
+
+            // bins cover the cutoff or, if larger, the extent of the particles
+            T rmax = 0;
+            if ( N > 0 )
+            {
+                Point lo = p[0], hi = p[0];
+                for ( auto &a : p )
+                {
+                    lo = lo.cwiseMin(a);
+                    hi = hi.cwiseMax(a);
+                }
+                rmax = (hi - lo).norm();
+            }
+            size_t nb = size_t(std::min(rc, rmax) / dr) + 1;
+            if ( nb > maxbins )
+                throw std::runtime_error("DebyeFormula: too many histogram bins; increase `dr` or set `cutoff`");
+            if ( nb > nbins )
+                nbins = nb;
+
+            // one histogram per thread; counts are integers so the sum is independent of thread count
+#ifdef _OPENMP
+            hist.resize(std::max(omp_get_max_threads(), 1));
+#else
+            hist.resize(1);
+#endif
+            for ( auto &h : hist )
+                h.assign(npairs * nbins, 0);
+            rows(N - 1, [&]( int i, int ) {
+                double *h = hist[thread()].data();
+                for ( int j = i + 1; j < N; ++j )
+                {
+                    T r2 = geo.sqdist(p[i], p[j]);
+                    if ( r2 < rc * rc )
+                    {
+                        size_t b = size_t(sqrt(r2) / dr);
+                        if ( b < nbins )
+                            h[pairIndex[cls[i] * nc + cls[j]] * nbins + b] += 1;
+                    }
+                }
+            });
+            vector<double> &H = hist[0];
+            for ( size_t t = 1; t < hist.size(); t++ )
+                for ( size_t b = 0; b < H.size(); b++ )
+                    H[b] += hist[t][b];
+
+            vector<T> fc(nq * nc); // F(q) of each class
+            for ( int k = 0; k < nq; k++ )
+                for ( int c = 0; c < nc; c++ )
+                    fc[k * nc + c] = F(qgrid[k], p[rep[c]]);
+            self.assign(nq, 0);
+            for ( int k = 0; k < nq; k++ )
+                for ( int c = 0; c < nc; c++ )
+                    self[k] += n[c] * pow(fc[k * nc + c], 2);
+
+            vector<T> sum(nq, 0);
+#pragma omp parallel for schedule (dynamic)
+            for ( int k = 0; k < nq; k++ )
+            {
+                double q = qgrid[k];
+                for ( int c1 = 0; c1 < nc; c1++ )
+                    for ( int c2 = c1; c2 < nc; c2++ )
+                    {
+                        const double *hv = H.data() + pairIndex[c1 * nc + c2] * nbins;
+                        double s = 0, qdr = q * dr;
+#pragma omp simd reduction(+:s)
+                        for ( int b = 0; b < (int) nbins; b++ )
+                        {
+                            double qr = (b + 0.5) * qdr;
+                            s += hv[b] * sin(qr) / qr;
+                        }
+                        sum[k] += fc[k * nc + c1] * fc[k * nc + c2] * s;
+                    }
+            }
+            return sum;
+        }
+
     protected:
         Tformfactor F; // scattering from a single particle
         Tgeometry geo; // geometry to use for distance calculations
@@ -185,14 +390,18 @@ namespace Faunus
         std::map<T, T> I; //!< Sampled, average I(q)
         std::map<T, T> S; //!< Weighted number of samplings
 
-        DebyeFormula( Tmjson &j ) : geo(10) {
+        DebyeFormula( Tmjson &j ) : nblocks(64), nbins(0), geo(10) {
             dq = j.at("dq");
             qmin = j.at("qmin");
             qmax = j.at("qmax");
             rc = j.value("cutoff", 1.0e9);
+            useHistogram = j.value("histogram", false);
+            dr = j.value("dr", 0.01);
 
             if (dq<=0 || qmin<=0 || qmax<=0 || qmin>qmax)
                 throw std::runtime_error("DebyeFormula: invalid q parameters");
+            if (dr<=0)
+                throw std::runtime_error("DebyeFormula: histogram resolution must be positive");
         }
 
         /**
@@ -231,41 +440,22 @@ namespace Faunus
             if ( qmin < 1e-6 )
                 qmin = dq;              // ensure that q>0
 
-            // Temporary f(q) functions - initialized to
-            // enable O(N) complexity iteration in inner loop.
-            std::map<T, T> _I, _ff;
+            qgrid.clear();
             for ( T q = qmin; q <= qmax; q += dq )
-                _I[q] = _ff[q] = 0;
+                qgrid.push_back(q);
 
-            int N = (int) p.size();
-            for ( int i = 0; i < N - 1; ++i )
-            {
-                for ( int j = i + 1; j < N; ++j )
-                {
-                    T r = geo.sqdist(p[i], p[j]);
-                    if ( r < rc * rc )
-                    {
-                        r = sqrt(r);
-                        for ( auto &m : _I )
-                        { // O(N) complexity
-                            T q = m.first;
-                            m.second += F(q, p[i]) * F(q, p[j]) * sin(q * r) / (q * r);
-                        }
-                    }
-                }
-            }
-            for ( int i = 0; i < N; i++ )
-                for ( T q = qmin; q <= qmax; q += dq )
-                    _ff[q] += pow(F(q, p[i]), 2);
+            vector<T> self;
+            auto pairs = useHistogram ? pairSumHistogram(p, self) : pairSum(p, self);
 
-            for ( auto &i : _I )
+            int N = (int) p.size();
+            for ( size_t k = 0; k < qgrid.size(); k++ )
             {
-                T q = i.first, Icorr = 0;
+                T q = qgrid[k], Icorr = 0;
                 if ( rc < 1e9 && V > 0 )
                     Icorr = 4 * pc::pi * N / (V * pow(q, 3)) *
                         (q * rc * cos(q * rc) - sin(q * rc));
                 S[q] += f;
-                I[q] += ((2 * i.second + _ff[q]) / N + Icorr) * f; // add to average I(q)
+                I[q] += ((2 * pairs[k] + self[k]) / N + Icorr) * f; // add to average I(q)
             }
         }
 
@@ -403,7 +593,7 @@ namespace Faunus
                 if ( Nq == 0 && qdir.squaredNorm() > 1e-6 )
                     Nq = 1;
                 else
-                    qdir.ranunit(slump);
+                    qdir.ranunit(slumpStreams()());
 
                 // N^2 loop over all particles
                 for ( int i = 0; i < n - 1; i++ )
@@ -447,7 +637,7 @@ namespace Faunus
             for ( int k = 0; k < Nq; k++ )
             { // random q directions
                 Point qdir(1, 0, 0);
-                qdir.ranunit(slump);
+                qdir.ranunit(slumpStreams()());
                 std::map<T, T> _cos, _sin;
                 for ( T q = qmin; q <= qmax; q += dq )
                 {
@@ -2,6 +2,20 @@
 #define FAU_slump_h
 
 #include <random>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <sstream>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <stdexcept>
+#include <cassert>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <faunus/json.h>
 #include <faunus/textio.h>
 
@@ -9,6 +23,61 @@
 namespace Faunus
 {
 
+  /**
+   * @brief Random stream number of the calling thread if not started by OpenMP (0: none)
+   *
+   * Threads started outside OpenMP, e.g. the workers of
+   * `Analysis::AnalysisPipeline`, report OpenMP thread number 0 and would
+   * otherwise share the master generator with the Markov chain. Such a
+   * thread sets a number obtained from `RandomWorkers::acquire()` and then
+   * draws from its own stream of each `RandomStreams`.
+   */
+  inline int &randomWorker()
+  {
+      static thread_local int w = 0;
+      return w;
+  }
+
+  /** @brief Allocation of the stream numbers used by `randomWorker()` */
+  struct RandomWorkers
+  {
+      static const int max = 32; //!< Largest number of simultaneous worker threads
+
+      /** @brief Lowest free stream number in `[1,max]`; throws if all are taken */
+      static int acquire()
+      {
+          std::lock_guard<std::mutex> lock(mutex());
+          for ( int i = 0; i < max; i++ )
+              if ( !used()[i] )
+              {
+                  used()[i] = 1;
+                  return i + 1;
+              }
+          throw std::runtime_error("RandomWorkers: more than " + std::to_string(max) + " worker threads");
+      }
+
+      /** @brief Free stream number `w` from `acquire()` */
+      static void release( int w )
+      {
+          std::lock_guard<std::mutex> lock(mutex());
+          if ( w > 0 && w <= max )
+              used()[w - 1] = 0;
+      }
+
+  private:
+      static std::mutex &mutex()
+      {
+          static std::mutex m;
+          return m;
+      }
+
+      static std::vector<char> &used()
+      {
+          static std::vector<char> v(max, 0);
+          return v;
+      }
+  };
+
   /**
    * @brief Mersenne Twister Random number generator for uniform distribution
    * @date Lund, 2010
@@ -29,12 +98,32 @@ namespace Faunus
       std::uniform_real_distribution<T> dist;
       long long int discard;
       bool hardware; // use hardware seed?
+      unsigned long gen; // unique number of the last seeding
+      uint64_t key;      // drawn from a copy of `eng` right after seeding
+      bool masterOnly;   // may only be used by the master thread
+
+      void checkThread() const
+      {
+#ifdef _OPENMP
+          assert((!masterOnly || omp_get_thread_num() == 0) && "Use slumpStreams() in parallel regions");
+#endif
+          if ( masterOnly && randomWorker() != 0 )
+              throw std::runtime_error("RandomTwister: master generator used by a worker thread; use slumpStreams()");
+      }
+
+      void reseeded()
+      {
+          static std::atomic<unsigned long> n(0);
+          Tengine e = eng;
+          key = (uint64_t(e()) << 32) ^ uint64_t(e());
+          gen = ++n;
+      }
 
   public:
       Tengine eng; //!< Random number engine
 
       /** @brief Constructor -- default deterministic seed */
-      RandomTwister() : dist(0, 1), discard(0), hardware(false) {}
+      RandomTwister() : dist(0, 1), discard(0), hardware(false), masterOnly(false) { reseeded(); }
 
       /**
        * @brief Construct from JSON object
@@ -49,9 +138,10 @@ namespace Faunus
        * @note `mpidiscard` is under construction.
        */
       template<class Tmjson>
-      RandomTwister(Tmjson &j) : dist(0, 1), discard(0)
+      RandomTwister(Tmjson &j) : dist(0, 1), discard(0), masterOnly(false)
       {
           hardware = j.value("hardware", false);
+          reseeded();
           if ( hardware )
               seed();
           if ( j.value("mpidiscard", false) )
@@ -61,6 +151,7 @@ namespace Faunus
       /** @brief Integer in uniform range [min:max] */
       int range( int min, int max )
       {
+          checkThread();
           std::uniform_int_distribution<int> d(min, max);
           return d(eng);
       }
@@ -78,20 +169,51 @@ namespace Faunus
 #pragma omp critical
               eng.seed(s);
           }
+          reseeded();
       }
 
+      /** @brief Seed from the state of another engine */
+      void seed( const Tengine &e )
+      {
+          eng = e;
+          reseeded();
+      }
+
+      /**
+       * @brief Changes whenever the engine is seeded
+       *
+       * Assigning `eng` directly, as done when restoring a saved state,
+       * is not a seeding and leaves this unchanged.
+       */
+      unsigned long generation() const { return gen; }
+
+      /** @brief Number derived from the state of the engine when last seeded */
+      uint64_t seedKey() const { return key; }
+
       /** @brief Discard numbers -- see doi:10/dkwg2h */
       void setDiscard( long long int z ) { discard = z; }
 
-      /** @brief Random number in uniform range [0,1) */
+      /**
+       * @brief Restrict use to the master thread
+       *
+       * Drawing from other OpenMP threads then fails an assertion
+       * (debug builds) and drawing from worker threads, see
+       * `randomWorker()`, throws. Set for the master of a `RandomStreams`.
+       */
+      void setMasterOnly( bool b = true ) { masterOnly = b; }
+
+      /**
+       * @brief Random number in uniform range [0,1)
+       *
+       * No locking is done so an instance should not be shared
+       * between threads. Use `RandomStreams` in parallel regions.
+       */
       T operator()()
       {
+          checkThread();
           if ( discard > 0 )
               eng.discard(discard);
-          T x;
-#pragma omp critical
-          x = dist(eng);
-          return x;
+          return dist(eng);
       }
 
       /** @brief Random number in uniform range `[-0.5,0.5)` */
@@ -123,8 +245,245 @@ namespace Faunus
       }
   };
 
+  /**
+   * @brief Named random number engines saved in binary state files
+   *
+   * Engines other than the global `slump` may register here so that
+   * `Space::save()` stores and `Space::load()` restores their states.
+   * A state read before its engine has been registered is applied
+   * upon registration, allowing `Space::load()` to precede
+   * construction of e.g. `Move::Propagator`.
+   */
+  class RandomStates
+  {
+  public:
+      typedef std::function<std::string()> Tgetter;
+      typedef std::function<void( const std::string & )> Tsetter;
+
+  private:
+      struct Entry
+      {
+          Tgetter get;
+          Tsetter set;
+      };
+      std::map<std::string, Entry> eng;
+      std::map<std::string, std::string> pending;
+
+  public:
+      /** @brief Register state accessors under `name`; a pending state is applied */
+      void add( const std::string &name, Tgetter get, Tsetter set )
+      {
+          eng[name] = {get, set};
+          auto it = pending.find(name);
+          if ( it != pending.end())
+          {
+              set(it->second);
+              pending.erase(it);
+          }
+      }
+
+      /** @brief Register engine under `name`; a pending state is applied */
+      void add( const std::string &name, std::mt19937 &e )
+      {
+          add(name,
+              [&e]()
+              {
+                  std::ostringstream o;
+                  o << e;
+                  return o.str();
+              },
+              [&e]( const std::string &state ) { std::istringstream(state) >> e; });
+      }
+
+      /** @brief Unregister `name` */
+      void remove( const std::string &name ) { eng.erase(name); }
+
+      /** @brief Restore state of engine `name`, now or when registered */
+      void set( const std::string &name, const std::string &state )
+      {
+          auto it = eng.find(name);
+          if ( it != eng.end())
+              it->second.set(state);
+          else
+              pending[name] = state;
+      }
+
+      /** @brief Current states of all registered engines */
+      std::map<std::string, std::string> get() const
+      {
+          std::map<std::string, std::string> m;
+          for ( auto &i : eng )
+              m[i.first] = i.second.get();
+          return m;
+      }
+  };
+
+  /** @brief Registry of named random number engines, see `RandomStates` */
+  inline RandomStates &randomStates()
+  {
+      static RandomStates r;
+      return r;
+  }
+
+  /**
+   * @brief Random number generators for OpenMP threads
+   *
+   * The master thread, and all code outside parallel regions, draws from
+   * the generator given to the constructor so that serial runs see the
+   * same sequence as without streams. Every other thread owns a generator
+   * derived from the master's `seedKey()`, its thread number and an
+   * optional rank (i.e. MPI rank). A stream is derived anew on its first
+   * use after the master has been seeded, so reseeding the master
+   * restarts all streams. No locking is needed, and the numbers drawn by
+   * each thread are reproducible for a given master seed and number of
+   * threads. Worker threads not started by OpenMP draw from streams of
+   * their own, see `randomWorker()`. These are derived in the same way
+   * but are not saved in state files.
+   *
+   * Named streams are registered in `randomStates()` as `name.i` and are
+   * thus saved in binary state files. A restored state is applied on
+   * the first use of the stream and takes precedence over seeding of the
+   * master between `Space::load()` and that use.
+   *
+   * ~~~
+   * RandomTwister<> master;
+   * master.seed(1234);
+   * RandomStreams<> ran(master);
+   * #pragma omp parallel for schedule(static)
+   * for (int i=0; i<N; i++)
+   *   x[i] = ran()();  // uniform [0,1) from current thread's generator
+   * ~~~
+   */
+  template<typename T=double, typename Tengine=std::mt19937>
+  class RandomStreams
+  {
+  public:
+      typedef RandomTwister<T, Tengine> Tgenerator;
+
+  private:
+      struct Slot
+      {
+          Tgenerator r;
+          unsigned long gen = 0; // master generation `r` was derived from (0: never)
+          std::string restored;  // state from a state file, applied on first use
+          char pad[64];          // keep generators on separate cache lines
+      };
+      std::vector<Slot> v;   // OpenMP threads followed by `RandomWorkers::max` workers
+      size_t nthreads;       // number of OpenMP streams
+      Tgenerator &master;
+      std::string name;
+      int rank;
+
+      Tgenerator &slot( size_t i )
+      {
+          auto &s = v[i];
+          if ( !s.restored.empty())
+          {
+              std::istringstream(s.restored) >> s.r.eng;
+              s.restored.clear();
+              s.gen = master.generation();
+          }
+          else if ( s.gen != master.generation())
+          {
+              uint64_t k = master.seedKey();
+              std::seed_seq q{uint32_t(k), uint32_t(k >> 32), uint32_t(rank), uint32_t(i)};
+              s.r.eng.seed(q);
+              s.gen = master.generation();
+          }
+          return s.r;
+      }
+
+  public:
+      /**
+       * @param master Generator used by the master thread
+       * @param name Name used to save the streams in state files (default: not saved)
+       * @param rank Rank number used to separate streams between processes
+       * @param n Number of threads (default: maximum number of OpenMP threads or processors)
+       */
+      RandomStreams( Tgenerator &master, const std::string &name = "", int rank = 0, int n = 0 )
+          : master(master), name(name), rank(rank)
+      {
+          master.setMasterOnly();
+          if ( n < 1 )
+          {
+#ifdef _OPENMP
+              n = std::max({omp_get_max_threads(), omp_get_num_threads(), omp_get_num_procs()});
+#else
+              n = 1;
+#endif
+          }
+          nthreads = n;
+          v.resize(n + RandomWorkers::max);
+          if ( !name.empty())
+              for ( int i = 1; i < n; i++ )
+                  randomStates().add(name + "." + std::to_string(i),
+                                     [this, i]()
+                                     {
+                                         std::ostringstream o;
+                                         o << slot(i).eng;
+                                         return o.str();
+                                     },
+                                     [this, i]( const std::string &state ) { v[i].restored = state; });
+      }
+
+      RandomStreams( const RandomStreams & ) = delete;
+      RandomStreams &operator=( const RandomStreams & ) = delete;
+
+      ~RandomStreams()
+      {
+          if ( !name.empty())
+              for ( size_t i = 1; i < nthreads; i++ )
+                  randomStates().remove(name + "." + std::to_string(i));
+      }
+
+      /** @brief Separate streams of this process from those of other ranks */
+      void setRank( int r )
+      {
+          rank = r;
+          for ( auto &s : v )
+              s.gen = 0;
+      }
+
+      /** @brief Number of streams of OpenMP threads */
+      size_t size() const { return nthreads; }
+
+      /** @brief Generator of i'th thread; 0 is the master */
+      Tgenerator &operator[]( size_t i ) { return (i == 0) ? master : slot(i); }
+
+      /** @brief Generator of the calling thread */
+      Tgenerator &operator()()
+      {
+          if ( randomWorker() > 0 )
+              return slot(nthreads + randomWorker() - 1);
+#ifdef _OPENMP
+          size_t i = omp_get_thread_num();
+          if ( i >= nthreads )
+              throw std::runtime_error("RandomStreams: more threads than random streams");
+          return operator[](i);
+#else
+          return master;
+#endif
+      }
+  };
+
+  /** @brief Global generator -- master thread only, see `slumpStreams()` */
   extern RandomTwister<> slump;
 
+  /**
+   * @brief Thread-safe access to the global generator
+   *
+   * The master thread draws from `slump`, other OpenMP threads and
+   * worker threads (see `randomWorker()`) from their own stream. Use
+   * `slumpStreams()()` in place of `slump` in code that may run in
+   * parallel regions; drawing directly from `slump` on other threads
+   * fails an assertion in debug builds, and throws on worker threads.
+   */
+  inline RandomStreams<> &slumpStreams()
+  {
+      static RandomStreams<> r(slump, "global");
+      return r;
+  }
+
 } // namespace
 
 #endif
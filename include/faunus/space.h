@@ -28,8 +28,14 @@ namespace Faunus
    * molecules in grand canonical moves. Only one instance
    * of a data element can exist at any given time.
    *
-   * Internally, the structure is a map of `Tid` key and
-   * a vector of `T`.
+   * Internally, the structure is a dense vector indexed by
+   * the id, each holding an unordered vector of `T`. Ids are
+   * therefore expected to be small, non-negative integers such
+   * as atom and molecule ids. Lookup by id and random picks are
+   * constant time; erasing swaps the last element into the hole
+   * and so does not preserve order. Vectors returned by `operator[]`
+   * are references into the tracker and are valid until the
+   * next insertion or erasure for that id.
    *
    * Example:
    *
@@ -52,69 +58,104 @@ namespace Faunus
    *
    *   // erase one of the found atoms from tracker
    *   atomTrack.erase( id, result[0] );
+   *
+   *   // random molecule of type `molid` (nullptr if none)
+   *   const Group* const* g = molTrack.random( molid );
    * ~~~~
    */
   template<class T, class Tid=int>
   class Tracker
   {
   private:
-      std::map<Tid, std::vector<T> > _map;
-      std::map<Tid, Average<double> > Navg; // average vector length. TO BE REMOVED
+      std::vector<std::vector<T> > _vec; // data for each id
+      std::vector<Average<double> > Navg; // average vector length. TO BE REMOVED
+
+      size_t ndx( Tid id ) const { return size_t(id); }
+
+      std::vector<T> &bucket( Tid id )
+      {
+          if ( ndx(id) >= _vec.size())
+              _vec.resize(ndx(id) + 1);
+          return _vec[ndx(id)];
+      }
+
   public:
       /** @brief Number of elements of type id */
       size_t size( Tid id ) const
       {
-          auto i = _map.find(id);
-          if ( i != _map.end())
-              return i->second.size();
-          return 0;
+          return ndx(id) < _vec.size() ? _vec[ndx(id)].size() : 0;
       }
 
       /** @brief Sum of all elements **/
       size_t size() const
       {
           size_t sum = 0;
-          for ( auto &m : _map )
-              sum += m.second.size();
+          for ( auto &v : _vec )
+              sum += v.size();
           return sum;
       }
 
-      const std::vector<T> &operator[]( Tid i ) const { return _map.at(i); };
+      /** @brief Elements of type id (no copy) -- throws if id is unknown */
+      const std::vector<T> &operator[]( Tid i ) const { return _vec.at(ndx(i)); };
 
-      std::vector<T> &operator[]( Tid i ) { return _map[i]; };
+      /** @brief Elements of type id -- id is registered if unknown */
+      std::vector<T> &operator[]( Tid i ) { return bucket(i); };
 
-      const std::map<Tid, std::vector<T> >& getMap() const
-      {
-        return _map;
-      }
+      /** @brief Number of registered id's */
+      size_t numId() const { return _vec.size(); }
 
-      std::map<Tid, std::vector<T> >& getMap()
-      {
-        return _map;
-      }
+      /** @brief Element vectors for all id's, indexed by id */
+      const std::vector<std::vector<T> >& data() const { return _vec; }
 
+      std::vector<std::vector<T> >& data() { return _vec; }
 
-      /** @brief Clear map -- preserve averages */
-      void clear() { _map.clear(); }
+      /** @brief Clear all elements but keep id's and memory -- preserve averages */
+      void clear()
+      {
+          for ( auto &v : _vec )
+              v.clear();
+      }
 
       /** @brief Update average number of particles. TO BE REMOVED. */
       void updateAvg()
       {
-          for ( auto &m : _map )
-              Navg[m.first] += m.second.size();
+          if ( Navg.size() < _vec.size())
+              Navg.resize(_vec.size());
+          for ( size_t i = 0; i < _vec.size(); i++ )
+              Navg[i] += _vec[i].size();
       }
 
       /** @brief Get average number of particles */
-      Average<double> getAvg( Tid id ) { return Navg[id]; }
+      Average<double> getAvg( Tid id )
+      {
+          if ( ndx(id) < Navg.size())
+              return Navg[ndx(id)];
+          return Average<double>();
+      }
 
       /** @brief Update atom tracker. TO BE REMOVED. */
       template<class Tpvec>
       void update( const Tpvec &p )
       {
-          _map.clear();
+          clear();
           for ( size_t i = 0; i < p.size(); i++ )
               if ( atom[p[i].id].activity > 1e-6 )
-                  _map[p[i].id].push_back(i);
+                  bucket(p[i].id).push_back(i);
+      }
+
+      /**
+       * @brief Pointer to random element of type id
+       * @return `nullptr` if there are no elements of type id
+       */
+      const T *random( Tid id ) const
+      {
+          if ( ndx(id) < _vec.size())
+          {
+              auto &v = _vec[ndx(id)];
+              if ( !v.empty())
+                  return &v[slumpStreams()().range(0, v.size() - 1)];
+          }
+          return nullptr;
       }
 
       /**
@@ -123,23 +164,24 @@ namespace Faunus
        * @param N Number of unique elements (data) to return
        * @param dst Destination vector -- new elements added to end
        * @return True if found; false otherwise
+       *
+       * Elements are drawn without replacement by a partial
+       * Fisher-Yates shuffle of the elements of type id, i.e.
+       * in O(N) time and with no rejected draws.
        */
       bool find( Tid id, size_t N, std::vector<T> &dst )
       {
-          size_t Ninit = dst.size();
-          auto i = _map.find(id);
-          if ( i != _map.end()) // id found
-              if ( i->second.size() >= N )
-              {  // enough elements?
-                  do
-                  {
-                      auto j = slump.element(i->second.begin(), i->second.end());
-                      if ( std::find(dst.begin(), dst.end(), *j) == dst.end())
-                          dst.push_back(*j);
-                  }
-                  while ( dst.size() != Ninit + N );
-                  return true;
+          if ( size(id) >= N ) // enough elements?
+          {
+              auto &v = _vec[ndx(id)];
+              auto &ran = slumpStreams()();
+              for ( size_t k = 0; k < N; k++ )
+              {
+                  std::swap(v[k], v[ran.range(k, v.size() - 1)]);
+                  dst.push_back(v[k]);
               }
+              return true;
+          }
           return false;
       }
 
@@ -150,15 +192,9 @@ namespace Faunus
        */
       void insert( Tid id, T data )
       {
-          auto i = _map.find(id);
-          if ( i != _map.end())
-          {
-              auto pos = std::find(i->second.begin(), i->second.end(), data);
-              if ( pos == i->second.end())
-                  i->second.push_back(data);
-          }
-          else
-              _map[id].push_back(data);
+          auto &v = bucket(id);
+          if ( std::find(v.begin(), v.end(), data) == v.end())
+              v.push_back(data);
       }
 
       /**
@@ -168,14 +204,14 @@ namespace Faunus
        */
       bool erase( Tid id, T data )
       {
-          auto i = _map.find(id);
-          if ( i != _map.end())
+          if ( ndx(id) < _vec.size())
           {
-              auto pos = std::find(i->second.begin(), i->second.end(), data);
-              if ( pos != i->second.end())
+              auto &v = _vec[ndx(id)];
+              auto pos = std::find(v.begin(), v.end(), data);
+              if ( pos != v.end())
               {
-                  std::swap(*pos, i->second.back());
-                  i->second.pop_back();
+                  *pos = v.back();
+                  v.pop_back();
                   return true;
               }
           }
@@ -188,12 +224,13 @@ namespace Faunus
        */
       bool erase( T data )
       {
-          for ( auto &m : _map )
+          for ( auto &v : _vec )
           {
-              auto it = std::find(m.second.begin(), m.second.end(), data);
-              if ( it != m.second.end())
+              auto pos = std::find(v.begin(), v.end(), data);
+              if ( pos != v.end())
               {
-                  m.second.erase(it);
+                  *pos = v.back();
+                  v.pop_back();
                   return true;
               }
           }
@@ -204,18 +241,294 @@ namespace Faunus
       /** @brief Checks if given data point exists */
       bool exists( Tid id, T data ) const
       {
-          auto i = _map.find(id);
-          if ( i != _map.end())
+          if ( ndx(id) < _vec.size())
           {
-              auto pos = std::find(i->second.begin(), i->second.end(), data);
-              if ( pos != i->second.end())
-                  return true;
+              auto &v = _vec[ndx(id)];
+              return std::find(v.begin(), v.end(), data) != v.end();
           }
           return false;
       }
 
   };
 
+  /**
+   * @brief Packed copy of particle positions, charges, radii and ids
+   *
+   * Structure-of-arrays mirror of a particle vector for loops
+   * that need only a few properties of each particle. Each array
+   * is contiguous so that pair kernels can be vectorised and
+   * read far less memory than when looping over full particle
+   * objects.
+   */
+  struct ParticleSoA
+  {
+      std::vector<double> x, y, z, charge, radius;
+      std::vector<int> id;
+
+      size_t size() const { return x.size(); }
+
+      /** @brief Copy properties of i'th particle */
+      template<class Tparticle>
+      void set( int i, const Tparticle &a )
+      {
+          x[i] = a.x();
+          y[i] = a.y();
+          z[i] = a.z();
+          charge[i] = a.charge;
+          radius[i] = a.radius;
+          id[i] = a.id;
+      }
+
+      /** @brief Copy all particles in vector */
+      template<class Tpvec>
+      void assign( const Tpvec &p )
+      {
+          size_t n = p.size();
+          x.resize(n);
+          y.resize(n);
+          z.resize(n);
+          charge.resize(n);
+          radius.resize(n);
+          id.resize(n);
+          for ( size_t i = 0; i < n; i++ )
+              set(i, p[i]);
+      }
+  };
+
+  /**
+   * @brief Flat map from group index to a container of data
+   *
+   * This is used in `Space::Change` in place of `std::map` and has the
+   * same interface for lookup, insertion and iteration (in order of
+   * increasing key). Entries are `std::pair<int,T>` kept sorted by key in
+   * a vector, where a new key is rotated into place, and `count()`
+   * is a constant time lookup in a membership table. `clear()` keeps all
+   * entries and their containers (`T::clear()`), so a change that is
+   * filled and cleared on every move allocates memory only until the
+   * largest change has been seen.
+   *
+   * Unlike `std::map`, references to values are invalidated when new keys
+   * are inserted.
+   *
+   * Example:
+   *
+   * ~~~~
+   *   ChangeMap<vector<int>> m;
+   *   m[4].push_back(10);
+   *   m[2];                        // whole group 2
+   *   for ( auto &i : m )          // i.first = 2, 4
+   *     cout << i.first << " " << i.second.size() << "\n";
+   *   m.clear();                   // no memory is released
+   * ~~~~
+   */
+  template<class T>
+  class ChangeMap
+  {
+  public:
+      typedef std::pair<int, T> value_type;
+      typedef typename std::vector<value_type>::iterator iterator;
+      typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+  private:
+      std::vector<value_type> pool; // entries sorted by key; [0,n) are in use
+      size_t n;
+      std::vector<char> member;             // true if key is in use
+
+      struct lessKey
+      {
+          bool operator()( const value_type &a, int key ) const { return a.first < key; }
+          bool operator()( const value_type &a, const value_type &b ) const { return a.first < b.first; }
+      };
+
+  public:
+      ChangeMap() : n(0) {}
+
+      ChangeMap( const ChangeMap &other ) : n(0) { *this = other; }
+
+      /** @brief Copy entries in use, reusing allocated memory */
+      ChangeMap &operator=( const ChangeMap &other )
+      {
+          if ( this != &other )
+          {
+              clear();
+              for ( auto &i : other )
+                  (*this)[i.first] = i.second;
+          }
+          return *this;
+      }
+
+      iterator begin() { return pool.begin(); }
+      iterator end() { return pool.begin() + n; }
+      const_iterator begin() const { return pool.begin(); }
+      const_iterator end() const { return pool.begin() + n; }
+
+      bool empty() const { return n == 0; }
+      size_t size() const { return n; }
+
+      /** @brief Number of entries with given key (0 or 1) */
+      size_t count( int key ) const
+      {
+          return (key >= 0 && key < (int) member.size()) ? member[key] : 0;
+      }
+
+      iterator find( int key )
+      {
+          return count(key) ? std::lower_bound(begin(), end(), key, lessKey()) : end();
+      }
+
+      const_iterator find( int key ) const
+      {
+          return count(key) ? std::lower_bound(begin(), end(), key, lessKey()) : end();
+      }
+
+      /** @brief Access entry with given key; inserted if not present */
+      T &operator[]( int key )
+      {
+          assert(key >= 0 && "negative key");
+          size_t i = std::lower_bound(begin(), end(), key, lessKey()) - begin();
+          if ( count(key))
+              return pool[i].second;
+          if ( n == pool.size())
+              pool.emplace_back();
+          pool[n].first = key;
+          pool[n].second.clear();
+          std::rotate(pool.begin() + i, pool.begin() + n, pool.begin() + n + 1); // keeps containers of other slots
+          if ( key >= (int) member.size())
+              member.resize(key + 1, 0);
+          member[key] = 1;
+          n++;
+          return pool[i].second;
+      }
+
+      /** @brief Remove all entries; memory is kept for reuse */
+      void clear()
+      {
+          for ( size_t i = 0; i < n; i++ )
+          {
+              member[pool[i].first] = 0;
+              pool[i].second.clear();
+          }
+          n = 0;
+      }
+
+      bool operator==( const ChangeMap &other ) const
+      {
+          return n == other.n && std::equal(begin(), end(), other.begin());
+      }
+
+      bool operator!=( const ChangeMap &other ) const { return !(*this == other); }
+  };
+
+  /**
+   * @brief Set of particle indices with constant time membership test
+   *
+   * Indices are kept in order of insertion together with a mask over all
+   * indices. `clear()` resets only the mask entries in use and keeps all
+   * memory, so a set that is refilled on every move allocates only until
+   * the largest index has been seen.
+   *
+   * Example:
+   *
+   * ~~~~
+   *   IndexSet s;
+   *   s.insert(10);
+   *   s.insert(3);
+   *   s.count(3);             // 1
+   *   for ( auto i : s )      // 10, 3
+   *     cout << i << "\n";
+   *   s.clear();              // no memory is released
+   * ~~~~
+   */
+  class IndexSet
+  {
+  private:
+      std::vector<int> index;
+      std::vector<char> mask;
+
+  public:
+      typedef std::vector<int>::const_iterator const_iterator;
+
+      const_iterator begin() const { return index.begin(); }
+      const_iterator end() const { return index.end(); }
+
+      bool empty() const { return index.empty(); }
+      size_t size() const { return index.size(); }
+
+      /** @brief Number of occurrences of `i` (0 or 1) */
+      size_t count( int i ) const { return (i >= 0 && i < (int) mask.size()) ? mask[i] : 0; }
+
+      /** @brief Add index; ignored if already present */
+      void insert( int i )
+      {
+          assert(i >= 0 && "negative index");
+          if ( i >= (int) mask.size())
+              mask.resize(std::max(size_t(i + 1), 2 * mask.size()), 0);
+          if ( !mask[i] )
+          {
+              mask[i] = 1;
+              index.push_back(i);
+          }
+      }
+
+      /** @brief Add range of indices */
+      template<class Titer>
+      void insert( Titer first, Titer last )
+      {
+          for ( ; first != last; ++first )
+              insert(*first);
+      }
+
+      /** @brief Remove all indices; memory is kept for reuse */
+      void clear()
+      {
+          for ( auto i : index )
+              mask[i] = 0;
+          index.clear();
+      }
+  };
+
+  /**
+   * @brief Header of binary state files, see `Space::save()`
+   *
+   * The header is followed by `ngroups` records of `StateGroup`,
+   * `nparticles` raw particle records of `particleSize` bytes and
+   * `nrandom` random number engine states, each stored as name and
+   * text state preceded by their lengths (`uint64_t`).
+   */
+  struct StateHeader
+  {
+      char magic[8];            //!< Always "FAUSTATE"
+      uint32_t version;         //!< Format version
+      uint32_t endian;          //!< 0x01020304 in the byte order of the writer
+      uint64_t particleSize;    //!< Size of particle records (bytes)
+      uint64_t nparticles;      //!< Number of particles
+      uint64_t ngroups;         //!< Number of groups
+      uint64_t nrandom;         //!< Number of random number engine states
+      uint64_t size;            //!< Total file size (bytes)
+      uint64_t checksum;        //!< `IO::checksum()` of the file with this field set to zero
+      double geometry[3];       //!< Side lengths or, for non-cuboid geometries, volume in first element
+
+      static constexpr const char *id() { return "FAUSTATE"; }
+  };
+
+  /** @brief Group record of binary state files */
+  struct StateGroup
+  {
+      int64_t front, back, molId, molsize;
+      double cm[3];
+  };
+
+  /**
+   * @brief True if particles can be stored as raw memory records in binary state files
+   *
+   * Particles holding heap memory, such as `CapParticle2`, can only be saved as text.
+   */
+  template<class Tparticle>
+  struct isRawParticle : public std::true_type {};
+
+  template<>
+  struct isRawParticle<CapParticle2> : public std::false_type {};
+
   /**
    * @brief Placeholder for particles and groups
    *
@@ -254,6 +567,31 @@ namespace Faunus
       bool checkSanity();                    //!< Check group length and vector sync
       std::vector<Group *> g;                 //!< Pointers to ALL groups in the system
       Tmjson to_json();
+      bool saveBinary( const string & );
+      void loadBinary( const IO::MappedFile &, bool );
+      ParticleSoA p_packed, trial_packed;     // packed copies of `p` and `trial`
+      bool packedDirty;                      // packed copies must be rebuilt before use
+      std::vector<int> groupIndex;           // index in `g` of group containing each particle; -1 if none
+
+      /** @brief Refill particle-to-group lookup table from `g` */
+      void initGroupIndex()
+      {
+          groupIndex.assign(p.size(), -1);
+          for ( int k = (int) g.size() - 1; k >= 0; k-- ) // first group wins on overlap
+              for ( auto i : *g[k] )
+                  if ( i >= 0 && i < (int) groupIndex.size())
+                      groupIndex[i] = k;
+      }
+
+      /** @brief Shift group index in lookup table after removing group `k` from `g` */
+      void eraseGroupIndex( int k )
+      {
+          for ( auto &i : groupIndex )
+              if ( i > k )
+                  i--;
+              else if ( i == k )
+                  i = -1;
+      }
 
   public:
       typedef std::vector<Tparticle, Eigen::aligned_allocator<Tparticle> > p_vec;
@@ -262,7 +600,7 @@ namespace Faunus
       typedef Tgeometry GeometryType;        //!< Geometry type
       typedef MoleculeData<ParticleVector> MoleculeType;
 
-      enum keys { OVERLAP_CHECK, NOOVERLAP_CHECK, RESIZE, NORESIZE };
+      enum keys { OVERLAP_CHECK, NOOVERLAP_CHECK, RESIZE, NORESIZE, TEXT, BINARY };
 
       Tgeometry geo;                         //!< System geometry
       Tgeometry geo_trial;                   //!< Trial geometry
@@ -288,11 +626,26 @@ namespace Faunus
       {
           double dV;  // volume change
           bool geometryChange;
-          std::map<int, vector<int>> mvGroup; // move groups
-          std::map<int, vector<int>> rmGroup; // remove groups
-          std::map<int, ParticleVector> inGroup; // insert groups
-
-          Change() : dV(0) {};
+          ChangeMap<vector<int>> mvGroup; // move groups
+          ChangeMap<vector<int>> rmGroup; // remove groups
+          ChangeMap<ParticleVector> inGroup; // insert groups
+
+          Change() : dV(0), geometryChange(false) {};
+
+          /**
+           * @brief Collect indices of all particles in `mvGroup`
+           * @param g Groups of `Space`; an empty index list of a moved group means all its particles
+           * @param moved Cleared and filled with the moved indices
+           */
+          void movedIndex( const std::vector<Group *> &g, IndexSet &moved ) const
+          {
+              moved.clear();
+              for ( auto &m : mvGroup )
+                  if ( m.second.empty())
+                      moved.insert(g[m.first]->begin(), g[m.first]->end());
+                  else
+                      moved.insert(m.second.begin(), m.second.end());
+          }
 
           void clear()
           {
@@ -321,7 +674,7 @@ namespace Faunus
       void applyChange( const Change &c )
       {
           // loop over moved groups
-          for ( auto m : c.mvGroup )
+          for ( auto &m : c.mvGroup )
           {
               auto g = groupList()[m.first];
               if ( m.second.empty()) // no index given; assume all have changed
@@ -353,7 +706,7 @@ namespace Faunus
        * is searched for molecules with non-zero `Ninit` and
        * will insert accordingly.
        */
-      Space( Tmjson &j ) try : geo( j.at("system").at("geometry") )
+      Space( Tmjson &j ) try : packedDirty(true), geo( j.at("system").at("geometry") )
       {
           pc::setT( j.at("system").value("temperature", 298.15) );
           atom.include( j.at("atomlist") );
@@ -369,11 +722,63 @@ namespace Faunus
           throw;
       }
 
+      /**
+       * @brief Copy constructor
+       *
+       * Groups are copied rather than shared so that the copy
+       * is independent of the original.
+       */
+      Space( const Space &o ) : packedDirty(true), geo(o.geo), geo_trial(o.geo_trial), p(o.p), trial(o.trial),
+                                molecule(o.molecule)
+      {
+          g.reserve(o.g.size());
+          for ( auto i : o.g )
+              g.push_back(new Group(*i));
+          initTracker();
+      }
+
+      Space &operator=( const Space & ) = delete;
+
+      /** @brief Particles, groups and geometry, see `getState()` and `setState()` */
+      struct State
+      {
+          ParticleVector p;
+          std::vector<Group> groups;
+          Tgeometry geo;
+      };
+
+      /** @brief Copy particles, groups and geometry to `s`; memory held by `s` is reused */
+      void getState( State &s ) const
+      {
+          s.p = p;
+          s.groups.resize(g.size());
+          for ( size_t i = 0; i < g.size(); i++ )
+              s.groups[i] = *g[i];
+          s.geo = geo;
+      }
+
+      /** @brief Set particles, groups and geometry from `s`; trial values are reset */
+      void setState( const State &s )
+      {
+          p = trial = s.p;
+          geo = geo_trial = s.geo;
+          for ( size_t i = s.groups.size(); i < g.size(); i++ )
+              delete g[i];
+          g.resize(s.groups.size(), nullptr);
+          for ( size_t i = 0; i < g.size(); i++ )
+              if ( g[i] == nullptr )
+                  g[i] = new Group(s.groups[i]);
+              else
+                  *g[i] = s.groups[i];
+          packedDirty = true;
+          initTracker();
+      }
+
       AtomMap &atomList() { return atom; } //!< Vector of atoms
 
       MoleculeMap<ParticleVector> &molList() { return molecule; } //!< Vector of molecules
 
-      bool save( const string & );                   //!< Save container state to disk
+      bool save( const string &, keys= TEXT );       //!< Save container state to disk (`TEXT` or `BINARY`)
       bool load( const string &, keys= NORESIZE );   //!< Load container state from disk
 
       /** @brief insert p_vec of MolID to end of p and trial */
@@ -385,6 +790,63 @@ namespace Faunus
       void reserve( int );           //!< Reserve space for particles for better memory efficiency
       string info();               //!< Information string
 
+      /**
+       * @brief Packed copy of `p` or `trial`
+       *
+       * The copies are rebuilt after particles have been inserted
+       * or removed and are otherwise updated with `syncPacked()`.
+       * Returns `nullptr` if `v` is neither `p` nor `trial`.
+       */
+      const ParticleSoA *packed( const ParticleVector &v )
+      {
+          if ( packedDirty || p_packed.size() != p.size() || trial_packed.size() != trial.size())
+          {
+              p_packed.assign(p);
+              trial_packed.assign(trial);
+              packedDirty = false;
+          }
+          if ( &v == &p )
+              return &p_packed;
+          if ( &v == &trial )
+              return &trial_packed;
+          return nullptr;
+      }
+
+      /** @brief Rebuild packed copies of `p` and `trial` before next use */
+      void syncPacked() { packedDirty = true; }
+
+      /**
+       * @brief Update packed copies of `p` and `trial` for particles in `Change`
+       *
+       * If the change does not describe moved particles, the
+       * copies are rebuilt before next use.
+       */
+      void syncPacked( const Change &c )
+      {
+          if ( packedDirty )
+              return;
+          if ( c.mvGroup.empty() || !c.rmGroup.empty() || !c.inGroup.empty())
+          {
+              packedDirty = true;
+              return;
+          }
+          for ( auto &m : c.mvGroup )
+          {
+              if ( m.second.empty())
+                  for ( auto i : *g[m.first] )
+                  {
+                      p_packed.set(i, p[i]);
+                      trial_packed.set(i, trial[i]);
+                  }
+              else
+                  for ( auto i : m.second )
+                  {
+                      p_packed.set(i, p[i]);
+                      trial_packed.set(i, trial[i]);
+                  }
+          }
+      }
+
       /** @brief Reset and refill atom- and molecular trackers*/
       inline void initTracker()
       {
@@ -398,8 +860,10 @@ namespace Faunus
           for (auto &m : molecule)
               molTrack[m.id].clear(); 
 
-          assert( atomTrack.getMap().size() == atom.size() );
-          assert( molTrack.getMap().size() == molecule.size() );
+          assert( atomTrack.numId() == atom.size() );
+          assert( molTrack.numId() == molecule.size() );
+
+          initGroupIndex();
 
           for ( auto g : groupList())
           {
@@ -415,14 +879,27 @@ namespace Faunus
       /**
        * @brief Find which group given particle index belongs to.
        *
+       * This is a constant time lookup in a table maintained by
+       * `insert()`, `erase()`, `eraseGroup()` and `setState()`. The
+       * table is only read here so that concurrent calls are safe.
+       * Should groups have been added or resized elsewhere, call
+       * `initTracker()` to refill it.
        * If not found, `nullptr` is returned.
+       *
+       * @throw std::runtime_error if the table is out of sync with the groups
        */
-      inline Group *findGroup( int i )
+      inline Group *findGroup( int i ) const
       {
-          for ( auto g : groupList())
-              if ( g->find(i))
-                  return g;
-          return nullptr;
+          if ( groupIndex.size() != p.size())
+              throw std::runtime_error("Space::findGroup: particles added outside Space; call initTracker()");
+          if ( i < 0 || i >= (int) groupIndex.size())
+              return nullptr;
+          int k = groupIndex[i];
+          if ( k < 0 )
+              return nullptr;
+          if ( k >= (int) g.size() || !g[k]->find(i))
+              throw std::runtime_error("Space::findGroup: groups changed outside Space; call initTracker()");
+          return g[k];
       }
 
       /**
@@ -432,6 +909,17 @@ namespace Faunus
        */
       inline int findIndex( Group *group )
       {
+          if ( group != nullptr && !group->empty())
+          {
+              int i = group->front();
+              if ( i >= 0 && i < (int) groupIndex.size())
+              {
+                  int k = groupIndex[i];
+                  if ( k >= 0 && k < (int) g.size())
+                      if ( g[k] == group )
+                          return k;
+              }
+          }
           auto it = std::find(g.begin(), g.end(), group);
           return (it != g.end()) ? it - g.begin() : -1;
       }
@@ -461,14 +949,24 @@ namespace Faunus
       /** @brief Returns pointer to random molecule of type `molid` */
       inline Group *randomMol( int molId )
       {
-          auto v = findMolecules(molId);
-          if ( !v.empty())
-              return *slump.element(v.begin(), v.end());
-          return nullptr;
+          auto g = molTrack.random(molId);
+          return ( g != nullptr ) ? *g : nullptr;
       }
 
-      /** @brief Returns vector of molecules with matching molid */
-      inline std::vector<Group *> findMolecules( int molId, bool sort = false ) const
+      /**
+       * @brief Returns vector of molecules with matching molid
+       *
+       * The returned reference points into the molecule tracker
+       * and is not copied. It is unordered and changes whenever
+       * molecules of type `molId` are inserted or erased.
+       */
+      inline const std::vector<Group *> &findMolecules( int molId ) const
+      {
+          return molTrack[molId];
+      }
+
+      /** @brief Returns copy of molecules with matching molid, optionally sorted by position */
+      inline std::vector<Group *> findMolecules( int molId, bool sort ) const
       {
           auto v = molTrack[molId];
           if ( sort )
@@ -603,6 +1101,9 @@ namespace Faunus
   template<class Tgeometry, class Tparticle>
   bool Space<Tgeometry, Tparticle>::insert( const Tparticle &a, int i )
   {
+      packedDirty = true;
+      if ( groupIndex.size() != p.size())
+          initGroupIndex();
       if ( i == -1 || i > (int) p.size())
       {
           i = p.size();
@@ -616,20 +1117,25 @@ namespace Faunus
       }
 
       // push forward all index > i in atom tracker
-      for ( auto &m : atomTrack.getMap() )    // loop over all maps
-          for ( auto &j : m.second ) // and their particle index
+      for ( auto &v : atomTrack.data() )    // loop over all id's
+          for ( auto &j : v ) // and their particle index
               if ( j >= i )
                   j++; // push forward particles beyond inserted particle
 
       atomTrack.insert(a.id, i);
 
-      for ( auto gj : g )
+      int owner = -1;
+      for ( size_t k = 0; k < g.size(); k++ )
       {
+          auto gj = g[k];
           if ( gj->front() > i )
               gj->setfront(gj->front() + 1); // gj->beg++;
           if ( gj->back() >= i )
               gj->setback(gj->back() + 1);    //gj->last++; // +1 is a special case for adding to the end of p-vector
+          if ( owner == -1 && gj->find(i))
+              owner = k;
       }
+      groupIndex.insert(groupIndex.begin() + i, owner);
       return true;
   }
 
@@ -637,13 +1143,17 @@ namespace Faunus
   template<class Tgeometry, class Tparticle>
   bool Space<Tgeometry, Tparticle>::erase( int i )
   {
+      packedDirty = true;
       assert(i < (int) p.size());
 
       if ( i < (int) p.size())
       {
+          if ( groupIndex.size() != p.size())
+              initGroupIndex();
           atomTrack.erase(p[i].id, i);
           p.erase(p.begin() + i);
           trial.erase(trial.begin() + i);
+          groupIndex.erase(groupIndex.begin() + i);
 
           Group *is_empty = nullptr;
           for ( auto gj : g )
@@ -658,14 +1168,16 @@ namespace Faunus
 
           if ( is_empty != nullptr )
           { // remove empty group
+              int k = findIndex(is_empty);
               molTrack.erase(is_empty->molId, is_empty);
-              g.erase(g.begin() + findIndex(is_empty));
+              g.erase(g.begin() + k);
+              eraseGroupIndex(k);
               delete (is_empty);
           }
 
           // down-shift all particle index above i
-          for ( auto &m : atomTrack.getMap() )
-              for ( auto &j : m.second )
+          for ( auto &v : atomTrack.data() )
+              for ( auto &j : v )
                   if ( j > i )
                       j--;
 
@@ -685,6 +1197,7 @@ namespace Faunus
   template<class Tgeometry, class Tparticle>
   bool Space<Tgeometry, Tparticle>::eraseGroup( int i )
   {
+      packedDirty = true;
 
       assert(!groupList().empty());
       assert(i >= 0 && i < (int) g.size());
@@ -699,6 +1212,9 @@ namespace Faunus
 
           assert(n > 0 && "Group size is zero");
 
+          if ( groupIndex.size() != p.size())
+              initGroupIndex();
+
           // erase from trackers
           molTrack.erase(g[i]->molId, g[i]);
           for ( auto j : *g[i] )
@@ -715,6 +1231,8 @@ namespace Faunus
           g.erase(g.begin() + i);
           p.erase(p.begin() + beg, p.begin() + end + 1);
           trial.erase(trial.begin() + beg, trial.begin() + end + 1);
+          groupIndex.erase(groupIndex.begin() + beg, groupIndex.begin() + end + 1);
+          eraseGroupIndex(i);
 
           // move index of later groups down and add to tracker
           for ( auto gi : groupList())
@@ -732,10 +1250,22 @@ namespace Faunus
       return false;
   }
 
+  /**
+   * @param file Filename
+   * @param format `TEXT` (default) or `BINARY`
+   *
+   * The text format is human readable while the binary format,
+   * see `StateHeader`, is compact and exact, includes the states of
+   * all registered random number engines (`RandomStates`) and is
+   * protected by a checksum. Binary files are written atomically and
+   * `load()` detects the format automatically.
+   */
   template<class Tgeometry, class Tparticle>
-  bool Space<Tgeometry, Tparticle>::save( const string &file )
+  bool Space<Tgeometry, Tparticle>::save( const string &file, keys format )
   {
       using std::numeric_limits;
+      if ( format == BINARY )
+          return saveBinary(file);
       if ( checkSanity())
       {
           cout << "Writing space state file '" << file << "'. ";
@@ -797,11 +1327,198 @@ namespace Faunus
   }
  
 
+  template<class Tgeometry, class Tparticle>
+  bool Space<Tgeometry, Tparticle>::saveBinary( const string &file )
+  {
+      if ( !isRawParticle<Tparticle>::value )
+          throw std::runtime_error("Binary state files are not supported for this particle type.");
+      if ( !checkSanity())
+          return false;
+      cout << "Writing binary space state file '" << file << "'. ";
+
+      auto random = randomStates().get();
+      std::ostringstream o;
+      o << slump.eng;
+      random["global"] = o.str();
+
+      StateHeader h;
+      std::copy_n(StateHeader::id(), 8, h.magic);
+      h.version = 1;
+      h.endian = 0x01020304;
+      h.particleSize = sizeof(Tparticle);
+      h.nparticles = p.size();
+      h.ngroups = g.size();
+      h.nrandom = random.size();
+      h.checksum = 0;
+      if ( std::is_base_of<Geometry::Cuboid, Tgeometry>::value || std::is_base_of<Geometry::Hexagon, Tgeometry>::value || std::is_base_of<Geometry::Octahedron, Tgeometry>::value )
+          for ( int i = 0; i < 3; i++ )
+              h.geometry[i] = geo.len[i];
+      else
+      {
+          h.geometry[0] = geo.getVolume();
+          h.geometry[1] = h.geometry[2] = 0;
+      }
+
+      string b(sizeof(h), '\0');
+      b.reserve(sizeof(h) + g.size() * sizeof(StateGroup) + p.size() * sizeof(Tparticle));
+      for ( auto i : g )
+      {
+          StateGroup r = {i->front(), i->back(), int64_t(i->molId), int64_t(i->getMolSize()),
+                          {i->cm.x(), i->cm.y(), i->cm.z()}};
+          b.append(reinterpret_cast<const char *>(&r), sizeof(r));
+      }
+      b.append(reinterpret_cast<const char *>(p.data()), p.size() * sizeof(Tparticle));
+      for ( auto &i : random )
+          for ( auto &str : {i.first, i.second} )
+          {
+              uint64_t n = str.size();
+              b.append(reinterpret_cast<const char *>(&n), sizeof(n));
+              b.append(str);
+          }
+
+      h.size = b.size();
+      std::copy_n(reinterpret_cast<const char *>(&h), sizeof(h), &b[0]);
+      h.checksum = IO::checksum(b.data(), b.size());
+      std::copy_n(reinterpret_cast<const char *>(&h), sizeof(h), &b[0]);
+
+      if ( IO::writeFileAtomic(file, b))
+      {
+          cout << "OK!\n";
+          return true;
+      }
+      cout << "FAILED!\n";
+      return false;
+  }
+
+  /**
+   * @param m Mapped binary state file
+   * @param resize Resize particle vectors if they do not match the file
+   * @throw std::runtime_error if the file is truncated, corrupt or incompatible
+   *
+   * The whole file is parsed and validated before particles, groups,
+   * geometry and random number states are replaced, so the space is
+   * left untouched if an exception is thrown.
+   */
+  template<class Tgeometry, class Tparticle>
+  void Space<Tgeometry, Tparticle>::loadBinary( const IO::MappedFile &m, bool resize )
+  {
+      using namespace textio;
+      const bool lengths = std::is_base_of<Geometry::Cuboid, Tgeometry>::value || std::is_base_of<Geometry::Hexagon, Tgeometry>::value || std::is_base_of<Geometry::Octahedron, Tgeometry>::value;
+      size_t pos = 0;
+      auto read = [&]( void *dst, size_t n ) {
+          if ( n > m.size() - pos )
+              throw std::runtime_error("State file is truncated.");
+          std::copy_n(m.data() + pos, n, static_cast<char *>(dst));
+          pos += n;
+      };
+
+      // header
+      StateHeader h;
+      read(&h, sizeof(h));
+      if ( h.version != 1 || h.endian != 0x01020304 )
+          throw std::runtime_error("State file has unsupported version or byte order.");
+      if ( h.size != m.size())
+          throw std::runtime_error("State file is truncated.");
+      if ( h.particleSize != sizeof(Tparticle) || !isRawParticle<Tparticle>::value )
+          throw std::runtime_error("State file was written for another particle type.");
+      uint64_t sum = h.checksum;
+      h.checksum = 0;
+      if ( IO::checksum(m.data() + sizeof(h), m.size() - sizeof(h), IO::checksum(&h, sizeof(h))) != sum )
+          throw std::runtime_error("State file checksum mismatch.");
+      for ( int i = 0; i < (lengths ? 3 : 1); i++ )
+          if ( !(h.geometry[i] > 0) || !std::isfinite(h.geometry[i]))
+              throw std::runtime_error("State file has invalid geometry.");
+      if ( h.ngroups > (m.size() - pos) / sizeof(StateGroup)
+          || h.nparticles > (m.size() - pos - h.ngroups * sizeof(StateGroup)) / sizeof(Tparticle))
+          throw std::runtime_error("State file is truncated.");
+
+      // groups, particles and random number states
+      vector<StateGroup> groups(h.ngroups);
+      if ( h.ngroups > 0 )
+          read(groups.data(), h.ngroups * sizeof(StateGroup));
+
+      int n = h.nparticles;
+      if ( !resize && n != (int) p.size())
+          throw std::runtime_error("State file has different number of particles. Try using the RESIZE keyword.");
+      ParticleVector v(n);
+      if ( n > 0 )
+          read(v.data(), n * sizeof(Tparticle));
+      for ( auto &i : v )
+          if ( i.id >= atom.size())
+              throw std::runtime_error("State file has more species than in the atom list.");
+
+      for ( auto &r : groups )
+          if ( r.front < 0 || r.back < r.front - 1 || r.back >= n || r.molId < 0
+              || r.molId >= (int64_t) molecule.size() || r.molsize < -1
+              || r.molsize > std::numeric_limits<int>::max())
+              throw std::runtime_error("State file has invalid group.");
+
+      vector<std::pair<string, string>> random(h.nrandom);
+      for ( auto &i : random )
+          for ( auto str : {&i.first, &i.second} )
+          {
+              uint64_t len;
+              read(&len, sizeof(len));
+              if ( len > m.size() - pos )
+                  throw std::runtime_error("State file is truncated.");
+              str->resize(len);
+              if ( len > 0 )
+                  read(&(*str)[0], len);
+          }
+      if ( pos != m.size())
+          throw std::runtime_error("State file has trailing data.");
+
+      auto eng = slump.eng;
+      for ( auto &i : random )
+          if ( i.first == "global" && !(std::istringstream(i.second) >> eng))
+              throw std::runtime_error("State file has invalid random number state.");
+
+      // commit
+      if ( lengths )
+          geo.setlen(Point(h.geometry[0], h.geometry[1], h.geometry[2]));
+      else
+          geo.setVolume(h.geometry[0]);
+
+      if ( n != (int) p.size())
+          cout << indent(SUB) << "Resizing particle vector from "
+               << p.size() << " --> " << n << ".\n";
+      p.swap(v);
+      trial = p;
+      cout << indent(SUB) << "Read " << n << " particle(s)." << endl;
+
+      for ( auto i : groupList())
+          delete i;
+      g.resize(groups.size());
+      for ( size_t k = 0; k < g.size(); k++ )
+      {
+          auto &r = groups[k];
+          g[k] = new Group();
+          g[k]->setrange(r.front, r.back);
+          g[k]->molId = PropertyBase::Tid(r.molId);
+          g[k]->setMolSize(r.molsize);
+          g[k]->cm = g[k]->cm_trial = Point(r.cm[0], r.cm[1], r.cm[2]);
+          g[k]->setMassCenter(*this);
+          g[k]->name = molecule[g[k]->molId].name;
+      }
+      cout << indent(SUB) << "Read " << g.size() << " group(s)." << endl;
+
+      for ( auto &i : random )
+          if ( i.first == "global" )
+              slump.eng = eng;
+          else
+              randomStates().set(i.first, i.second);
+      cout << indent(SUB) << "Restored " << h.nrandom << " random number generator state(s)." << endl;
+  }
+
   /**
    * @param file Filename
    * @param key If set to `RESIZE`, `p` and `trial` will be
    *        expanded if they do not match the file
    *        (for Grand Canonical MC)
+   *
+   * Binary and text files are told apart by the header of
+   * the binary format.
+   * @throw std::runtime_error if the file is truncated, corrupt or incompatible
    */
   template<class Tgeometry, class Tparticle>
   bool Space<Tgeometry, Tparticle>::load( const string &file, keys key )
@@ -810,6 +1527,18 @@ namespace Faunus
       cout << "Reading space state file '" << file << "'. ";
       if ( checkSanity())
       {
+          IO::MappedFile m(file);
+          if ( m.size() >= sizeof(StateHeader) && std::equal(m.data(), m.data() + 8, StateHeader::id()))
+          {
+              cout << "OK! (binary)\n";
+              loadBinary(m, key == RESIZE);
+              geo_trial = geo;
+              packedDirty = true;
+              initTracker();
+              checkSanity();
+              return true;
+          }
+
           std::ifstream f(file.c_str());
           if ( f )
           {
@@ -846,11 +1575,13 @@ namespace Faunus
                   trial = p;
                   cout << indent(SUB) << "Read " << n << " particle(s)." << endl;
 
+                  // read groups
+                  f >> n;
+                  if ( !f )
+                      throw std::runtime_error("State file is truncated.");
                   // destruct all previous groups
                   for ( auto i : groupList())
                       delete i;
-                  // read groups
-                  f >> n;
                   g.resize(n);
                   for ( auto &i : groupList())
                   {
@@ -862,6 +1593,8 @@ namespace Faunus
                   }
                   cout << indent(SUB) << "Read " << n << " group(s)." << endl;
               }
+              if ( !f )
+                  throw std::runtime_error("State file is truncated.");
               string id;
               f >> id;
               if ( id == "randomstate" )
@@ -871,6 +1604,7 @@ namespace Faunus
               }
 
               geo_trial = geo;
+              packedDirty = true;
 
               initTracker(); // update trackers
 
@@ -949,11 +1683,15 @@ namespace Faunus
   template<class Tgeometry, class Tparticle>
   Group *Space<Tgeometry, Tparticle>::insert( PropertyBase::Tid molId, const p_vec &pin )
   {
+      packedDirty = true;
       if ( !pin.empty())
       {
 
           assert(atomTrack.size() == p.size());
 
+          if ( groupIndex.size() != p.size())
+              initGroupIndex();
+
           // insert atomic groups into existing group, if present
           if ( molecule[molId].isAtomic() && !g.empty())
           {
@@ -969,6 +1707,7 @@ namespace Faunus
               if ( imax >= 0 )
               {
                   // add to particle vectors
+                  groupIndex.insert(groupIndex.begin() + g[imax]->back() + 1, pin.size(), imax);
                   p.insert(p.begin() + g[imax]->back() + 1, pin.begin(), pin.end());
                   trial.insert(trial.begin() + g[imax]->back() + 1, pin.begin(), pin.end());
                   g[imax]->setback(g[imax]->back() + pin.size());
@@ -1008,6 +1747,7 @@ namespace Faunus
 
           // add group and particles
           groupList().push_back(x);
+          groupIndex.insert(groupIndex.end(), pin.size(), g.size() - 1);
           p.insert(p.end(), pin.begin(), pin.end());
           trial.insert(trial.end(), pin.begin(), pin.end());
 
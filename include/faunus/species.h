@@ -74,10 +74,10 @@ namespace Faunus
 			using typename base::const_reference;
 
 			/** @brief Iterator to random element */
-			const_iterator random() const { return slump.element(begin(), end()); }
+			const_iterator random() const { return slumpStreams()().element(begin(), end()); }
 
 			/** @brief Iterator to random element */
-			iterator random() { return slump.element(begin(), end()); }
+			iterator random() { return slumpStreams()().element(begin(), end()); }
 
 			/** @brief Add element at the end */
 			void push_back( const value_type &d )
@@ -1293,6 +1293,9 @@ namespace Faunus
         }
     };
 
+    template<typename Tpairpot, typename Ttabulator>
+    struct isThreadSafe<PotentialTabulate<Tpairpot, Ttabulator>> : std::false_type {};
+
     /**
      * @brief Construct a distance dependent potential from json entry
      *
@@ -1499,17 +1502,45 @@ namespace Faunus
      * If the pair is not recognized, i.e. not added with the
      * `add()` function, the `Tdefault` pair potential is used.
      * If the pair is found then a tabulation will be used.
+     *
+     * Added potentials are compiled into tabulated kernels stored
+     * alongside the dense id-pair table of `PotentialMap`, so that
+     * each pair is resolved by indexing and evaluated without
+     * type-erased calls. Outside `[tab_rmin,tab_rmax]` the original
+     * potential is used.
+     *
+     * The keywords below are read from the same json section as those of
+     * `Tdefault`, i.e. `energy/nonbonded` when used in `Energy::Nonbonded`:
+     *
+     * Keyword       | Description
+     * :------------ | :------------------------------------------
+     * `tab_rmin`    | Lower tabulation distance (default: 1 angstrom)
+     * `tab_rmax`    | Upper tabulation distance (default: 100 angstrom)
+     * `tab_utol`    | Energy tolerance (default: 0.01)
+     * `tab_ftol`    | Force tolerance (default: -1 = not used)
+     * `tab_umaxtol` | Max. energy tolerance (default: -1 = not used)
+     * `tab_fmaxtol` | Max. force tolerance (default: -1 = not used)
+     * `tab_print`   | Save tabulations to disk (default: 0)
      */
     template<typename Tdefault, typename Ttabulator=Tabulate::Andrea<double>, typename Tparticle=PointParticle>
     class PotentialMapTabulated : public PotentialMap<Tdefault>
     {
     private:
-        typedef opair<int> Tpair;
         typedef PotentialMap <Tdefault> base;
         double rmin2, rmax2;
         int print;
         Ttabulator tab;
-        std::map<Tpair, typename Ttabulator::data> mtab;
+        std::vector<typename Ttabulator::data> mtab; // kernels with same index as `base::m`
+
+        /** @brief Energy from k'th added potential */
+        inline double kernel( int k, const Tparticle &a, const Tparticle &b, double r2 )
+        {
+            auto &d = mtab[k];
+            if ( r2 < d.rmax2 )
+                if ( r2 > d.rmin2 )
+                    return tab.eval(d, r2);
+            return base::energy(k, a, b, r2); // fall back to original
+        }
 
     public:
         PotentialMapTabulated( InputMap &in ) : base(in)
@@ -1529,29 +1560,42 @@ namespace Faunus
             print = in.get<int>("tab_print", 0);
         }
 
+        /** @param j Pair potential section, e.g. `energy/nonbonded` */
+        PotentialMapTabulated( Tmjson &j ) : base(j)
+        {
+            double rmin = j.value("tab_rmin", 1.0);
+            double rmax = j.value("tab_rmax", 100.0);
+            rmin2 = rmin * rmin;
+            rmax2 = rmax * rmax;
+            tab.setRange(rmin, rmax);
+            tab.setTolerance(
+                j.value("tab_utol", 0.01),
+                j.value("tab_ftol", -1.0),
+                j.value("tab_umaxtol", -1.0),
+                j.value("tab_fmaxtol", -1.0));
+            print = j.value("tab_print", 0);
+        }
+
         double operator()( const Tparticle &a, const Tparticle &b, double r2 )
         {
-            auto ab = Tpair(a.id, b.id);
-            auto it = mtab.find(ab);
-            if ( it != mtab.end())
-            {
-                if ( r2 < it->second.rmax2 )
-                    if ( r2 > it->second.rmin2 )
-                        return tab.eval(it->second, r2);
-                return base::m[ab](a, b, r2); // fall back to original
-            }
+            int k = base::find(a.id, b.id);
+            if ( k >= 0 )
+                return kernel(k, a, b, r2);
             return Tdefault::operator()(a, b, r2); // fall back to default
         }
 
         template<class Tpairpot>
-        void add( AtomData::Tid id1, AtomData::Tid id2, Tpairpot pot )
+        int add( AtomData::Tid id1, AtomData::Tid id2, Tpairpot pot )
         {
             Tparticle a, b;
             a = atom[id1];
             b = atom[id2];
-            base::add(a.id, b.id, pot);
+            int k = base::add(a.id, b.id, pot);
             std::function<double( double )> f = [=]( double r2 ) { return Tpairpot(pot)(a, b, r2); };
-            mtab[Tpair(id1, id2)] = tab.generate(f);
+            if ( k >= (int) mtab.size())
+                mtab.resize(k + 1);
+            mtab[k] = tab.generate(f);
+            return k;
         }
 
         std::string info( char w = 20 )
@@ -1559,15 +1603,14 @@ namespace Faunus
             using namespace Faunus::textio;
             std::ostringstream o(base::info(w));
             o << tab.info(w) << std::endl;
-            for ( auto &i : mtab )
+            for ( size_t k = 0; k < mtab.size(); k++ )
             {
-                auto ab = Tpair(i.first.first, i.first.second);
-                auto it = mtab.find(ab);
+                auto &ab = base::pairs[k];
                 o << pad(SUB,
                          w,
-                         "Nbr of elements in table (" + atom[i.first.first].name + "<->" + atom[i.first.second].name
+                         "Nbr of elements in table (" + atom[ab.first].name + "<->" + atom[ab.second].name
                              + "): ")
-                  << it->second.r2.size() << endl;
+                  << mtab[k].r2.size() << endl;
             }
             o << endl;
             if ( print == 1 )
@@ -1577,31 +1620,31 @@ namespace Faunus
 
         void print_tabulation( int n = 1000 )
         {
-            for ( auto &i : mtab )
+            for ( size_t k = 0; k < mtab.size(); k++ )
             {
-                auto ab = Tpair(i.first.first, i.first.second);
-                auto it = mtab.find(ab);
+                auto &ab = base::pairs[k];
+                auto &d = mtab[k];
 
                 Tparticle a, b;
-                a = atom[i.first.first];
-                b = atom[i.first.second];
+                a = atom[ab.first];
+                b = atom[ab.second];
 
                 std::ofstream
-                    ff1(std::string(atom[i.first.first].name + "." + atom[i.first.second].name + ".real.dat").c_str());
+                    ff1(std::string(atom[ab.first].name + "." + atom[ab.second].name + ".real.dat").c_str());
                 ff1.precision(10);
 
                 std::ofstream
-                    ff2(std::string(atom[i.first.first].name + "." + atom[i.first.second].name + ".tab.dat").c_str());
+                    ff2(std::string(atom[ab.first].name + "." + atom[ab.second].name + ".tab.dat").c_str());
                 ff2.precision(10);
 
-                double max = it->second.r2.at(it->second.r2.size() - 2);
-                double min = it->second.rmin2;
+                double max = d.r2.at(d.r2.size() - 2);
+                double min = d.rmin2;
                 double dr = (max - min) / (double) n;
                 for ( int j = 1; j < n; j++ )
                 {
                     double r2 = min + dr * ((double) j);
-                    ff1 << sqrt(r2) << " " << base::m[ab](a, b, r2) << endl;
-                    ff2 << sqrt(r2) << " " << tab.eval(it->second, r2) << endl;
+                    ff1 << sqrt(r2) << " " << base::energy(k, a, b, r2) << endl;
+                    ff2 << sqrt(r2) << " " << tab.eval(d, r2) << endl;
                 }
             }
         }
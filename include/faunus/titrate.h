@@ -317,12 +317,12 @@ namespace Faunus
     template<class Tpvec>
     EquilibriumController::processdata &EquilibriumController::random( const Tpvec &p, int &j )
     {
-        int i = slump.range(0, sites.size() - 1);// pick random titratable site
+        int i = slumpStreams()().range(0, sites.size() - 1);// pick random titratable site
         //int i=slump.rand() % sites.size();     // pick random titratable site
         j = sites[i];                                 // corresponding particle
         int k;
         do
-            k = slump.range(0, process.size() - 1);// pick random process..
+            k = slumpStreams()().range(0, process.size() - 1);// pick random process..
         while ( !process[k].one_of_us(p[j].id));   // ..that involves particle j
         return process[k];
     }
@@ -38,17 +38,35 @@ namespace Faunus
 
     void AnalysisBase::sample()
     {
-        stepcnt++;
-        if ( stepcnt == steps )
+        if ( due())
         {
-            cnt++;
-            stepcnt = 0;
             timer.start();
+            cnt++;
             _sample();
             timer.stop();
         }
     }
 
+    bool AnalysisBase::due()
+    {
+        stepcnt++;
+        if ( stepcnt == steps )
+        {
+            stepcnt = 0;
+            return true;
+        }
+        return false;
+    }
+
+    void AnalysisBase::sample( std::chrono::steady_clock::time_point queued )
+    {
+        timer.start();
+        latency += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - queued).count();
+        cnt++;
+        _sample();
+        timer.stop();
+    }
+
     void AnalysisBase::_test( UnitTest &t ) {}
 
     void AnalysisBase::test( UnitTest &t ) { _test(t); }
@@ -71,6 +89,8 @@ namespace Faunus
                 double time = timer.result();
                 if ( time > 1e-3 )
                     o << pad(SUB, w, "Relative time") << time << "\n";
+                if ( latency.cnt > 0 )
+                    o << pad(SUB, w, "Queue latency") << latency.avg() << " ms\n";
             }
             o << _info();
         }
@@ -92,6 +112,8 @@ namespace Faunus
                 {
                     j[name]["citation"] = cite;
                 }
+                if ( latency.cnt > 0 )
+                    j[name]["queue latency (ms)"] = latency.avg();
                 j = merge(j, _json());
             }
         return j;
@@ -160,7 +182,7 @@ namespace Faunus
         return j;
     }
 
-    PairFunctionBase::PairFunctionBase( Tmjson j, string name ) : AnalysisBase(j, name) {
+    PairFunctionBase::PairFunctionBase( Tmjson j, string name, bool allowRmax ) : AnalysisBase(j, name) {
         try {
             for (auto &i : j.at("pairs"))
                 if (i.is_object())
@@ -172,6 +194,10 @@ namespace Faunus
                     d.name2 = i.at("name2");
                     d.dim = i.value("dim", 3);
                     d.dr = i.value("dr", 0.1);
+                    d.rmax = i.value("rmax", pc::infty);
+                    if (d.rmax < pc::infty && !allowRmax)
+                        throw std::runtime_error("rmax is not supported by this analysis");
+                    d.npairs = 0;
                     d.hist.setResolution(d.dr);
 		    d.hist2.setResolution(d.dr);
 		    d.hist3.setResolution(d.dr);
@@ -186,23 +212,33 @@ namespace Faunus
         if (datavec.empty())
             std::cerr << name + ": no sample sets defined for analysis\n";
     }
+
+    void PairFunctionBase::checkRange(double rmax)
+    {
+        for (auto &d : datavec) {
+            double r = std::min(rmax, d.rmax);
+            if ( r / d.dr + 1 > FlatTable2D<double,double>::maxbins )
+                throw std::runtime_error(name + ": " + d.name1 + "-" + d.name2 + " needs more than "
+                        + std::to_string(FlatTable2D<double,double>::maxbins) + " bins; increase dr or set rmax");
+        }
+    }
     
     void PairFunctionBase::normalize(data &d)
     {
 	assert(V.cnt>0);
-	double Vr=1, sum = d.hist.sumy();
-	for (auto &i : d.hist.getMap()) {
+	double Vr=1, sum = (d.rmax < pc::infty) ? d.npairs : d.hist.sumy();
+	d.hist.forEach( [&](double r, double &y) {
 	    if (d.dim==3)
-		Vr = 4 * pc::pi * pow(i.first,2) * d.dr;
+		Vr = 4 * pc::pi * pow(r,2) * d.dr;
 	    if (d.dim==2) {
-		Vr = 2 * pc::pi * i.first * d.dr;
+		Vr = 2 * pc::pi * r * d.dr;
 		if (d.Rhypersphere > 0)
-		    Vr = 2.0*pc::pi*d.Rhypersphere*sin(i.first/d.Rhypersphere) * d.dr;
+		    Vr = 2.0*pc::pi*d.Rhypersphere*sin(r/d.Rhypersphere) * d.dr;
 	    }
 	    if (d.dim==1)
 		Vr = d.dr;
-	    i.second = i.second/sum * V/Vr;
-	}
+	    y = y/sum * V/Vr;
+	} );
     }
 
     PairFunctionBase::~PairFunctionBase()
@@ -216,12 +252,17 @@ namespace Faunus
     void CombinedAnalysis::sample()
     {
         cnt++;
+        if ( pipeline )
+            pipeline->sample();
         for ( auto i : v )
-            i->sample();
+            if ( !pipeline || !pipeline->contains(i.get()))
+                i->sample();
     }
 
     string CombinedAnalysis::info()
     {
+        if ( pipeline )
+            pipeline->flush();
         std::ostringstream o;
         for ( auto i : v )
             o << i->info();
@@ -234,20 +275,32 @@ namespace Faunus
 
     void CombinedAnalysis::test( UnitTest &test )
     {
+        if ( pipeline )
+            pipeline->flush();
         for ( auto i : v )
             i->test(test);
     }
 
     Tmjson CombinedAnalysis::json()
     {
+        if ( pipeline )
+            pipeline->flush();
         Tmjson js;
         for ( auto i : v )
             js = merge(js, i->json());
+        if ( energyjson )
+        {
+            auto e = energyjson();
+            if ( !e.empty())
+                js["energy"] = e;
+        }
         return js;
     }
 
     CombinedAnalysis::~CombinedAnalysis()
     {
+        if ( pipeline )
+            pipeline->finish(); // spaces of the analyses are kept until `pipeline` is destroyed
         if (cnt>0) {
             std::ofstream f(jsonfile);
             if ( f )
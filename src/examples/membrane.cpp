@@ -48,7 +48,11 @@ void MakeDesernoMembrane(const Tlipid &lipid, Tbonded &b, Tpotmap &m, Tinput &in
 }
 
 typedef Space<Geometry::Cuboid> Tspace;
-typedef Potential::PotentialMap<Potential::DebyeHuckel> Tpairpot;
+typedef Potential::WeeksChandlerAndersen TWCA;
+typedef Potential::PotentialMap<Potential::DebyeHuckel, PointParticle, double,
+        Potential::CombinedPairPotential<TWCA, Potential::DebyeHuckel>,
+        Potential::CombinedPairPotential<TWCA, Potential::CosAttract>,
+        Potential::CombinedPairPotential<TWCA, Potential::ChargeNonpolar>> Tpairpot;
 
 int main() {
 
@@ -192,6 +192,177 @@ TEST_CASE("Ewald Test","Ion-Ion- and Dipole-Dipole-interaction")
   CHECK(Energy::systemEnergy(spc,pot,spc.p) == Approx(-2.0003749*lB));  // Total dipole-dipole interaction energy
 }
 
+TEST_CASE("Ewald tuning", "Check that tuned Ewald parameters meet the requested accuracy")
+{
+  typedef Space<Geometry::Cuboid,DipoleParticle> Tspace;
+  typedef Energy::NonbondedEwald<Tspace,Potential::HardSphere> Tewald;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 20 } },
+    "energy" : { "nonbonded" : { "epsr" : 1,
+      "ewald" : { "eps_surf" : 0, "debyelength" : 1e10, "tune" : true, "delta" : 1e-4 } } },
+    "atomlist" : { "ewA" : { "q" : 1 }, "ewB" : { "q" : -1 } },
+    "moleculelist" : { "ewsalt" : { "atoms" : "ewA ewB", "atomic" : true, "Ninit" : 20 } }
+  })"_json;
+  Tspace spc(j);
+  Tewald pot(j);
+  pot.setSpace(spc);
+  auto tuned = pot.json()["ewald"];
+  double delta = tuned["tuning"]["delta"];
+  CHECK( delta == Approx(1e-4) );
+  CHECK( tuned["tuning"]["real error"].get<double>() < delta );
+  CHECK( tuned["tuning"]["reciprocal error"].get<double>() < delta );
+
+  // reference with converged parameters
+  auto &e = j["energy"]["nonbonded"]["ewald"];
+  e["tune"] = false;
+  e["cutoff"] = 10;
+  e["alpha"] = 0.45;
+  e["cutoffK"] = 16;
+  Tewald ref(j);
+  ref.setSpace(spc);
+  double lB = ref.pairpot.first.bjerrumLength();
+  double error = std::fabs( Energy::systemEnergy(spc,pot,spc.p) - Energy::systemEnergy(spc,ref,spc.p) ) / lB;
+  CHECK( error < 2*delta );
+}
+
+TEST_CASE("Ewald phase factors", "Check phase factor recurrence against direct cos and sin")
+{
+  const int nmax = 40, stride = 3;
+  for (double t : {0.0, 0.1, -0.7, 2.5, 31.4}) {
+    vector<double> re(stride*(nmax+1)), im(stride*(nmax+1));
+    Potential::EwaldPhases::recurrence(t, nmax, &re[0], &im[0], stride);
+    double err = 0;
+    for (int n=0; n<=nmax; n++)
+      err = std::max( err, std::fabs(re[n*stride]-cos(n*t)) + std::fabs(im[n*stride]-sin(n*t)) );
+    CHECK( err < 1e-12 );
+  }
+}
+
+TEST_CASE("Ewald structure factors", "Check incremental update of structure factors against full summation")
+{
+  typedef Space<Geometry::Cuboid,DipoleParticle> Tspace;
+  typedef Energy::NonbondedEwald<Tspace,Potential::HardSphere,true,true,true> Tewald;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 20 } },
+    "energy" : { "nonbonded" : { "epsr" : 1,
+      "ewald" : { "eps_surf" : 0, "debyelength" : 1e10, "cutoff" : 9, "alpha" : 0.35, "cutoffK" : 8 } } },
+    "atomlist" : { "sfA" : { "q" : 1 }, "sfB" : { "q" : -1 } },
+    "moleculelist" : { "sfsalt" : { "atoms" : "sfA sfB", "atomic" : true, "Ninit" : 15 } }
+  })"_json;
+  Tspace spc(j);
+  auto unit = []() { Point u; u.ranunit(slump); return u; };
+  for (auto &a : spc.p) {
+    a.mu() = unit();
+    a.muscalar() = 0.5;
+  }
+  spc.trial = spc.p;
+  Tewald pot(j);
+  pot.setSpace(spc);
+  auto &g = *spc.groupList()[0];
+
+  // energy from structure factors summed over all particles
+  auto direct = [&](const Tspace::ParticleVector &p) {
+    Tspace spc2(spc);
+    spc2.p = spc2.trial = p;
+    Tewald ref(j);
+    ref.setSpace(spc2);
+    return ref.external(spc2.p);
+  };
+
+  for (int n=0; n<6; n++) {
+    Tspace::Change c;
+    if (n==3)
+      c.mvGroup[0]; // whole group
+    else
+      for (int i : {n, n+7, n+20})
+        c.mvGroup[0].push_back(i);
+    for (int i=g.front(); i<=g.back(); i++)
+      if (c.mvGroup[0].empty() || std::count(c.mvGroup[0].begin(), c.mvGroup[0].end(), i)) {
+        spc.trial[i].translate(spc.geo, unit()*2.0);
+        spc.trial[i].mu() = unit();
+      }
+    pot.updateChange(c);
+    double lB = pot.pairpot.first.bjerrumLength();
+    CHECK( pot.external(spc.trial) / lB == Approx( direct(spc.trial) / lB ).epsilon(1e-9) );
+    bool accept = (n % 2 == 0);
+    pot.update(accept);
+    if (accept)
+      spc.p = spc.trial;
+    else
+      spc.trial = spc.p;
+    CHECK( pot.external(spc.p) / lB == Approx( direct(spc.p) / lB ).epsilon(1e-9) );
+  }
+}
+
+TEST_CASE("Ewald particle mesh", "Check mesh structure factors against direct summation")
+{
+  typedef Space<Geometry::Cuboid,DipoleParticle> Tspace;
+  typedef Energy::NonbondedEwald<Tspace,Potential::HardSphere,true,true,true> Tewald;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 20 } },
+    "energy" : { "nonbonded" : { "epsr" : 1,
+      "ewald" : { "eps_surf" : 0, "debyelength" : 1e10, "cutoff" : 9, "alpha" : 0.35, "cutoffK" : 8 } } },
+    "atomlist" : { "smA" : { "q" : 1 }, "smB" : { "q" : -1 } },
+    "moleculelist" : { "smsalt" : { "atoms" : "smA smB", "atomic" : true, "Ninit" : 15 } }
+  })"_json;
+  Tspace spc(j);
+  for (auto &a : spc.p) {
+    a.mu().ranunit(slump);
+    a.muscalar() = 0.5;
+  }
+  spc.trial = spc.p;
+
+  // smooth particle mesh versus direct sum for the requested accuracy
+  double delta = 1e-4;
+  Tewald ref(j);
+  ref.setSpace(spc);
+  auto &e = j["energy"]["nonbonded"]["ewald"];
+  e["method"] = "spme";
+  e["mesh"] = 32;
+  Tewald spme(j);
+  spme.setSpace(spc);
+  double lB = ref.pairpot.first.bjerrumLength();
+  CHECK( std::fabs( spme.external(spc.p) - ref.external(spc.p) ) / lB < delta );
+}
+
+TEST_CASE("Ewald real space tables", "Tabulated real space energy and force versus the analytic form")
+{
+  typedef Potential::EwaldReal<true,true,true> Tpot;
+  const double rc = 12, utol = 1e-7, ftol = 1e-5, h = 1e-5;
+  PairMatrix<double> QeQe;
+  QeQe.seta(0, 0, 1.0);
+  DipoleParticle a, b;
+  a.charge = 1;
+  b.charge = -1;
+  a.mu() = Point(1,0,0);
+  b.mu() = Point(1,1,0).normalized();
+  a.muscalar() = b.muscalar() = 1;
+
+  for (double alpha : {0.0, 0.3}) {
+    Tmjson j = { {"epsr", 1.0}, {"ewald", { {"tab_utol", utol}, {"tab_ftol", ftol} } } };
+    Tpot pot(j);
+    pot.updateCharges(QeQe);
+    pot.updateKappa(0.05);
+    pot.updateAlpha(alpha);
+    pot.updateRcut(rc);
+    CHECK( !pot.table_T0.r2.empty() );
+    CHECK( !pot.table_T2.r2.empty() );
+    double du = 0, df = 0;
+    for (double r=1; r<rc-h; r+=0.0937) {
+      Point v = Point(1,2,-1).normalized() * r, dv = v.normalized() * h;
+      du = std::max( du, std::fabs( pot(a,b,v) - pot.analytic(a,b,v) ) );
+      double f = ( pot(a,b,v+dv) - pot(a,b,v-dv) ) / (2*h);
+      double fa = ( pot.analytic(a,b,v+dv) - pot.analytic(a,b,v-dv) ) / (2*h);
+      df = std::max( df, std::fabs(f-fa) );
+    }
+    CHECK( du < 10*utol*pot.lB );
+    CHECK( df < ftol*pot.lB );
+  }
+  Tmjson j = { {"epsr", 1.0}, {"ewald", Tmjson::object()} };
+  Tpot pot(j);
+  CHECK_THROWS( pot.updateAlpha(-1) );
+}
+
 TEST_CASE("Groups", "Check group range and size properties")
 {
   Group g(2,5);           // first, last particle
@@ -250,6 +421,232 @@ TEST_CASE("Space", "Space tests")
   //spc.insert(a);
 }
 
+TEST_CASE("Find group", "Check particle-to-group lookup after insertion and removal")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "geometry" : { "length" : 20 } },
+    "atomlist" : { "fgA" : { "q" : 1 }, "fgB" : { "q" : -1 } },
+    "moleculelist" : {
+      "fgmA" : { "atoms" : "fgA", "atomic" : true, "Ninit" : 5 },
+      "fgmB" : { "atoms" : "fgB", "atomic" : true, "Ninit" : 6 },
+      "fgmC" : { "atoms" : "fgA fgB", "atomic" : true, "Ninit" : 2 } }
+  })"_json;
+  Tspace spc(j);
+  auto &g = spc.groupList();
+  REQUIRE( g.size() == 3 );
+
+  // compare lookup with a scan of all groups
+  auto check = [&]() {
+    int errors = 0;
+    for (int i=-1; i<=(int)spc.p.size(); i++) {
+      Group *ref = nullptr;
+      for (auto gi : g)
+        if (gi->find(i)) {
+          ref = gi;
+          break;
+        }
+      if (spc.findGroup(i) != ref)
+        errors++;
+      if (ref != nullptr)
+        if (spc.findIndex(ref) != std::find(g.begin(), g.end(), ref) - g.begin())
+          errors++;
+    }
+    return errors;
+  };
+  CHECK( check() == 0 );
+
+  PointParticle a;
+  a = atom["fgA"];
+  spc.insert(a, 0);                 // first particle
+  CHECK( check() == 0 );
+  spc.insert(a, g[1]->front() + 2); // inside group
+  CHECK( check() == 0 );
+  spc.insert(a, g[2]->front());     // at front of group
+  CHECK( check() == 0 );
+  spc.insert(a);                    // end of vector, no group
+  CHECK( spc.findGroup(spc.p.size()-1) == nullptr );
+  CHECK( check() == 0 );
+
+  spc.erase(g[0]->front() + 1);     // inside group
+  CHECK( check() == 0 );
+  spc.erase(g[1]->front());         // front of group
+  CHECK( check() == 0 );
+  while ( g.size() == 3 )           // empty and remove last group
+    spc.erase(g[2]->back());
+  CHECK( check() == 0 );
+  spc.eraseGroup(0);
+  CHECK( g.size() == 1 );
+  CHECK( g[0]->front() == 0 );
+  CHECK( check() == 0 );
+
+  // changes made outside Space are reported, not silently repaired
+  int last = g[0]->back();
+  g[0]->setback(last - 1);
+  CHECK_THROWS( spc.findGroup(last) );
+  spc.initTracker();
+  CHECK( check() == 0 );
+  spc.p.push_back(a);
+  CHECK_THROWS( spc.findGroup(0) );
+}
+
+TEST_CASE("Tracker", "Check insertion, swap-remove and random draws of tracked data")
+{
+  Tracker<int> t;
+  for (int i=0; i<10; i++)
+    t.insert(2, i);
+  t.insert(2, 3); // already present
+  CHECK( t.size(2) == 10 );
+  CHECK( t.size(0) == 0 );
+  CHECK( t.random(5) == nullptr );
+  CHECK( t.random(0) == nullptr );
+
+  // erased element is replaced by the last one
+  CHECK( t.erase(2, 4) );
+  CHECK( t[2][4] == 9 );
+  CHECK( t[2].size() == 9 );
+  CHECK( !t.exists(2, 4) );
+  CHECK( t.erase(9) );
+  CHECK( t[2][4] == 8 );
+  CHECK( !t.erase(2, 4) );
+
+  // remaining: 0 1 2 3 8 5 6 7
+  std::vector<int> dst = {-1};
+  CHECK( !t.find(2, 9, dst) );
+  CHECK( dst.size() == 1 );
+  CHECK( t.find(2, 8, dst) ); // all elements in random order
+  REQUIRE( dst.size() == 9 );
+  CHECK( dst[0] == -1 );
+  std::vector<int> all(dst.begin()+1, dst.end());
+  std::sort(all.begin(), all.end());
+  CHECK( all == std::vector<int>({0,1,2,3,5,6,7,8}) );
+
+  // partial shuffle draws unique elements, each equally often
+  std::map<int,int> cnt;
+  int N=20000, unique=0, valid=0;
+  for (int n=0; n<N; n++) {
+    dst.clear();
+    t.find(2, 3, dst);
+    if ( dst.size()==3 && dst[0]!=dst[1] && dst[0]!=dst[2] && dst[1]!=dst[2] )
+      unique++;
+    for (auto i : dst)
+      cnt[i]++;
+    if ( t.exists(2, *t.random(2)) )
+      valid++;
+  }
+  CHECK( unique == N );
+  CHECK( valid == N );
+  CHECK( cnt.size() == 8 );
+  for (auto &c : cnt)
+    CHECK( c.second / double(3*N) == Approx(1/8.).epsilon(0.05) );
+  CHECK( t.size(2) == 8 );
+}
+
+TEST_CASE("Change map", "Check insertion, lookup and ordering of moved groups")
+{
+  ChangeMap<vector<int>> m;
+  CHECK( m.empty() );
+  m[7].push_back(70);
+  m[2];
+  m[5].push_back(50);
+  m[7].push_back(71); // existing key
+  m[0].push_back(1);
+  m[5];
+  CHECK( m.size() == 4 );
+  CHECK( m.count(7) == 1 );
+  CHECK( m.count(3) == 0 );
+  CHECK( m.count(100) == 0 );
+  CHECK( m.find(3) == m.end() );
+  CHECK( m.find(7)->second == vector<int>({70,71}) );
+
+  const auto &cm = m;
+  vector<int> keys;
+  for (auto &i : cm)
+    keys.push_back(i.first);
+  CHECK( keys == vector<int>({0,2,5,7}) );
+  CHECK( cm.find(5)->second == vector<int>({50}) );
+  CHECK( cm.find(2)->second.empty() );
+
+  ChangeMap<vector<int>> c(m);
+  CHECK( c == m );
+  c[2].push_back(3);
+  CHECK( c != m );
+
+  m.clear();
+  CHECK( m.empty() );
+  CHECK( m.count(7) == 0 );
+  m[3].push_back(30);
+  m[1];
+  keys.clear();
+  for (auto &i : m)
+    keys.push_back(i.first);
+  CHECK( keys == vector<int>({1,3}) );
+  CHECK( m.find(1)->second.empty() ); // reused slots are cleared
+  CHECK( m.find(3)->second == vector<int>({30}) );
+}
+
+TEST_CASE("Binary state", "Check save and load of binary space state files")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 30 } },
+    "atomlist" : {
+      "bsA" : { "q" : 1, "r" : 1 },
+      "bsB" : { "q" : -1, "r" : 2 } },
+    "moleculelist" : {
+      "bssalt" : { "atoms" : "bsA bsB", "atomic" : true, "Ninit" : 10 } }
+  })"_json;
+  Tspace spc(j), spc2(j);
+  string file = "unittests.state";
+
+  // round trip
+  CHECK( spc.save(file, Tspace::BINARY) );
+  CHECK( spc2.load(file) );
+  CHECK( spc2.p == spc.p );
+  CHECK( spc2.trial == spc.p );
+  CHECK( spc2.geo.len == spc.geo.len );
+  REQUIRE( spc2.groupList().size() == spc.groupList().size() );
+  for (size_t i=0; i<spc.groupList().size(); i++) {
+    auto &a = *spc.groupList()[i], &b = *spc2.groupList()[i];
+    CHECK( b.front() == a.front() );
+    CHECK( b.back() == a.back() );
+    CHECK( b.molId == a.molId );
+  }
+
+  // damaged files are rejected and leave the space untouched
+  std::ifstream f(file, std::ios::binary);
+  string s( (std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>() );
+  auto write = [&](const string &data) { std::ofstream(file, std::ios::binary) << data; };
+  for (auto &a : spc2.p)
+    a.x() += 0.1;
+  spc2.trial = spc2.p;
+  auto p = spc2.p;
+  auto len = spc2.geo.len;
+
+  write( s.substr(0, s.size()-9) );     // truncated
+  CHECK_THROWS( spc2.load(file) );
+  write( s.substr(0, sizeof(StateHeader)) );
+  CHECK_THROWS( spc2.load(file) );
+  string t = s;
+  t[t.size()/2] ^= 0x10;                 // flipped bit
+  write(t);
+  CHECK_THROWS( spc2.load(file) );
+  t = s;
+  t[sizeof(StateHeader)-8] ^= 0x01;      // flipped bit in geometry of header
+  write(t);
+  CHECK_THROWS( spc2.load(file) );
+
+  j["system"]["geometry"]["length"] = 40;  // other box and number of particles
+  j["moleculelist"]["bssalt"]["Ninit"] = 5;
+  Tspace spc3(j);
+  CHECK( spc3.save(file, Tspace::BINARY) );
+  CHECK_THROWS( spc2.load(file) );        // no RESIZE
+
+  CHECK( spc2.p == p );
+  CHECK( spc2.geo.len == len );
+  std::remove(file.c_str());
+}
+
 TEST_CASE("Geometries", "Geometry tests")
 {
   Geometry::Sphere geoSph(1000);
@@ -261,6 +658,910 @@ TEST_CASE("Geometries", "Geometry tests")
   CHECK( x==Approx(y) );
 }
 
+TEST_CASE("Cell list", "Check neighbour search in cuboids")
+{
+  Geometry::Cuboid geo;
+  geo.setlen( Point(40,50,60) );
+  std::vector<Point> p(500);
+  for (auto &a : p)
+    geo.randompos(a);
+  double rc=11;
+  Geometry::CellList<Geometry::Cuboid> cells;
+  CHECK( cells.build(geo, p, rc) );
+  geo.randompos(p[7]);
+  cells.update(7, p[7]);
+  for (size_t i=0; i<p.size(); i+=5) {
+    int n=0, m=0;
+    std::vector<int> visits(p.size(), 0);
+    cells.forEach( p[i], [&](int j) { visits[j]++; if (geo.sqdist(p[i],p[j])<rc*rc) n++; } );
+    for (auto &b : p)
+      if (geo.sqdist(p[i],b)<rc*rc)
+        m++;
+    CHECK( n==m );
+    CHECK( *std::max_element(visits.begin(), visits.end()) == 1 );
+  }
+  Geometry::Sphere geoSph(10);
+  Geometry::CellList<Geometry::Sphere> nocells;
+  CHECK( !nocells.build(geoSph, p, rc) );
+}
+
+TEST_CASE("Scaled pair energy", "Check pair energy change of isotropic volume scaling")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  typedef Potential::CombinedPairPotential<Potential::Coulomb, Potential::LennardJonesLB> Tpairpot;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 40 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : {
+      "scA" : { "q" : 1, "sigma" : 3, "eps" : 0.2 },
+      "scB" : { "q" : -1, "sigma" : 4, "eps" : 0.1 } },
+    "moleculelist" : {
+      "scsalt" : { "atoms" : "scA scB", "atomic" : true, "Ninit" : 30 } }
+  })"_json;
+  Tspace spc(j);
+  Energy::Nonbonded<Tspace, Tpairpot> pot(j);
+  pot.setSpace(spc);
+
+  // explicit recomputation in a copy with box and positions scaled by `s`
+  double s = 1.05;
+  Tspace spc2(spc);
+  spc2.geo.setlen( spc.geo.len * s );
+  for (auto &a : spc2.p)
+    a = a * s;
+  spc2.trial = spc2.p;
+  Energy::Nonbonded<Tspace, Tpairpot> pot2(j);
+  pot2.setSpace(spc2);
+  double u1 = Energy::systemEnergy(spc, pot, spc.p);
+  double u2 = Energy::systemEnergy(spc2, pot2, spc2.p);
+
+  CHECK( pot.scaledPairChange(s) == Approx(u2-u1) );
+  pot.update(false);
+  pot.setSpace(spc2); // summed terms of the former space must be discarded
+  CHECK( pot.scaledPairChange(1/s) == Approx(u1-u2) );
+}
+
+TEST_CASE("Isobaric scaling", "Check reuse of summed pair terms in consecutive volume moves")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  typedef Potential::CombinedPairPotential<Potential::Coulomb, Potential::LennardJonesLB> Tpairpot;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 40 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "moves" : { "isobaric" : { "dp" : 0.01, "pressure" : 100 } },
+    "atomlist" : {
+      "scA" : { "q" : 1, "sigma" : 3, "eps" : 0.2 },
+      "scB" : { "q" : -1, "sigma" : 4, "eps" : 0.1 } },
+    "moleculelist" : {
+      "scsalt" : { "atoms" : "scA scB", "atomic" : true, "Ninit" : 30 } }
+  })"_json;
+  Tspace spc(j);
+  auto pot = Energy::Nonbonded<Tspace, Tpairpot>(j) + Energy::ExternalPressure<Tspace>(j);
+  auto nb = &pot.first;
+  Move::Isobaric<Tspace> iso(pot, spc, j["moves"]["isobaric"]);
+
+  int reused = 0;
+  for (int i=0; i<20; i++) {
+    double V = spc.geo.getVolume();
+    bool known = nb->hasScaledSums();
+    double uold = Energy::systemEnergy(spc, pot, spc.p);
+    double du = iso.move();
+    double unew = Energy::systemEnergy(spc, pot, spc.p);
+    CHECK( du == Approx(unew-uold) );
+    CHECK( nb->hasScaledSums() ); // kept after accepted and rejected scalings
+    if ( known && spc.geo.getVolume() != V )
+      reused++;
+  }
+  CHECK( reused >= 2 );
+}
+
+TEST_CASE("Isobaric scaling and translation", "Check summed pair terms after interleaved translations and volume moves")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  typedef Potential::CombinedPairPotential<Potential::Coulomb, Potential::LennardJonesLB> Tpairpot;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 40 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "moves" : { "isobaric" : { "dp" : 0.01, "pressure" : 100 },
+                "atomtranslate" : { "scsalt" : { "peratom" : true } } },
+    "atomlist" : {
+      "scA" : { "q" : 1, "sigma" : 3, "eps" : 0.2, "dp" : 3 },
+      "scB" : { "q" : -1, "sigma" : 4, "eps" : 0.1, "dp" : 3 } },
+    "moleculelist" : {
+      "scsalt" : { "atoms" : "scA scB", "atomic" : true, "Ninit" : 30 } }
+  })"_json;
+  Tspace spc(j);
+  auto pot = Energy::Nonbonded<Tspace, Tpairpot>(j) + Energy::ExternalPressure<Tspace>(j);
+  auto nb = &pot.first;
+  Move::Isobaric<Tspace> iso(pot, spc, j["moves"]["isobaric"]);
+  Move::AtomicTranslation<Tspace> mv(pot, spc, j["moves"]["atomtranslate"]);
+
+  slump.seed(1234);
+  iso.move();
+  for (int i=0; i<10; i++) {
+    mv.move();
+    Tspace::Change c; // accepted move of several particles
+    for (int k : {2, 7, 30 + i}) {
+      spc.trial[k].translate(spc.geo, Point(1.5, -1, 0.5));
+      c.mvGroup[ spc.findIndex(spc.findGroup(k)) ].push_back(k);
+    }
+    pot.updateChange(c);
+    spc.p = spc.trial;
+    pot.update(true);
+    CHECK( nb->hasScaledSums() ); // corrected, not forgotten, after translations
+    Energy::Nonbonded<Tspace, Tpairpot> fresh(j);
+    fresh.setSpace(spc);
+    CHECK( nb->scaledPairChange(1.01) == Approx(fresh.scaledPairChange(1.01)).epsilon(1e-8) );
+    nb->update(false);
+    double uold = Energy::systemEnergy(spc, pot, spc.p);
+    double du = iso.move();
+    CHECK( du == Approx(Energy::systemEnergy(spc, pot, spc.p) - uold) );
+  }
+  CHECK( mv.getAcceptance() > 0 );
+}
+
+/* Coulomb potential that counts its evaluations */
+struct CountedCoulomb : public Potential::Coulomb {
+  static unsigned long cnt;
+  CountedCoulomb(Tmjson &j) : Potential::Coulomb(j) {}
+  template<class Tparticle>
+    double operator() (const Tparticle &a, const Tparticle &b, double r2) const {
+      cnt++;
+      return Potential::Coulomb::operator()(a,b,r2);
+    }
+  template<class Tparticle>
+    double operator() (const Tparticle &a, const Tparticle &b, const Point &r) const {
+      return operator()(a,b,r.squaredNorm());
+    }
+};
+unsigned long CountedCoulomb::cnt = 0;
+
+TEST_CASE("Packed energy", "Check vectorised loops over packed particles against scalar loops")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  typedef Potential::CombinedPairPotential<Potential::Coulomb, Potential::LennardJones> Tpairpot;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 25 } },
+    "energy" : { "nonbonded" : { "epsr" : 80, "eps" : 0.05 },
+                 "packed" : { "epsr" : 80, "eps" : 0.05, "packed" : true } },
+    "atomlist" : { "pkA" : { "q" : 1, "r" : 1.5 }, "pkB" : { "q" : -1, "r" : 2 } },
+    "moleculelist" : {
+      "pkmA" : { "atoms" : "pkA", "atomic" : true, "Ninit" : 30 },
+      "pkmB" : { "atoms" : "pkB pkA", "atomic" : true, "Ninit" : 20 } }
+  })"_json;
+  static_assert( Potential::hasPackedSum<Tpairpot>::value, "no packed sum" );
+  Tspace spc(j);
+  REQUIRE( spc.groupList().size() == 2 );
+  Energy::Nonbonded<Tspace, Tpairpot> scalar(j), packed(j, "packed");
+  scalar.setSpace(spc);
+  packed.setSpace(spc);
+  CHECK( packed.name.find("packed") != std::string::npos );
+  auto &g1 = *spc.groupList()[0], &g2 = *spc.groupList()[1];
+
+  // all loop types on `p` or `trial`
+  auto compare = [&]( Tspace::ParticleVector &p ) {
+    REQUIRE( spc.packed(p) != nullptr );
+    CHECK( packed.g2g(p, g1, g2) == Approx(scalar.g2g(p, g1, g2)).epsilon(1e-10) );
+    CHECK( packed.g2g(p, g2, g1) == Approx(scalar.g2g(p, g1, g2)).epsilon(1e-10) );
+    CHECK( packed.g_internal(p, g1) == Approx(scalar.g_internal(p, g1)).epsilon(1e-10) );
+    CHECK( packed.g_internal(p, g2) == Approx(scalar.g_internal(p, g2)).epsilon(1e-10) );
+    for (int i : {0, 17, 29, 30, 55, 69}) {
+      CHECK( packed.i2all(p, i) == Approx(scalar.i2all(p, i)).epsilon(1e-10) );
+      CHECK( packed.i2g(p, g1, i) == Approx(scalar.i2g(p, g1, i)).epsilon(1e-10) );
+      CHECK( packed.i2g(p, g2, i) == Approx(scalar.i2g(p, g2, i)).epsilon(1e-10) );
+      PointParticle a = p[i];
+      a.translate(spc.geo, Point(0.7, -0.3, 0.4)); // ghost near particle `i`
+      CHECK( packed.all2p(p, a) == Approx(scalar.all2p(p, a)).epsilon(1e-10) );
+    }
+    CHECK( Energy::systemEnergy(spc, packed, p) == Approx(Energy::systemEnergy(spc, scalar, p)).epsilon(1e-10) );
+  };
+  compare(spc.p);
+
+  // move particles in both groups and update packed copies as done by `Movebase`
+  slump.seed(1234);
+  for (int n=0; n<5; n++) {
+    Tspace::Change c;
+    for (int i : {3, 31, 40 + n}) {
+      spc.geo.randompos(spc.trial[i]);
+      c.mvGroup[ spc.findIndex(spc.findGroup(i)) ].push_back(i);
+    }
+    spc.syncPacked(c);
+    compare(spc.trial);
+    for (auto &m : c.mvGroup)
+      for (auto i : m.second)
+        spc.p[i] = spc.trial[i];  // accept
+    spc.syncPacked(c);
+    compare(spc.p);
+  }
+}
+
+TEST_CASE("Cell list energy", "Check cell list loops against all pairs after a move not described by Space::Change")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 50 } },
+    "energy" : { "nonbonded" : { "epsr" : 80, "cutoff_cell" : 8 } },
+    "atomlist" : { "clA" : { "q" : 1 }, "clB" : { "q" : -1 } },
+    "moleculelist" : {
+      "clmA" : { "atoms" : "clA", "atomic" : true, "Ninit" : 100 },
+      "clmB" : { "atoms" : "clB", "atomic" : true, "Ninit" : 100 } }
+  })"_json;
+  Tspace spc(j);
+  REQUIRE( spc.groupList().size() == 2 );
+  Energy::Nonbonded<Tspace, CountedCoulomb> pot(j);
+  pot.setSpace(spc);
+  auto &g1 = *spc.groupList()[0], &g2 = *spc.groupList()[1];
+
+  // reference sums over all pairs, truncated as the cell list
+  auto compare = [&]( Tspace::ParticleVector &p ) {
+    double u12 = 0;
+    for (auto i : g1)
+      for (auto k : g2)
+        u12 += pot.p2p(p[i], p[k]);
+    CHECK( pot.g2g(p, g1, g2) == Approx(u12) );
+    for (int i : {0, 5, 99, 100, 150}) {
+      double u = 0;
+      for (size_t k=0; k<p.size(); k++)
+        if (int(k) != i)
+          u += pot.p2p(p[i], p[k]);
+      CHECK( pot.i2all(p, i) == Approx(u) );
+    }
+  };
+
+  pot.prepare(spc.p);
+  CountedCoulomb::cnt = 0;
+  pot.i2all(spc.p, 0);
+  CHECK( CountedCoulomb::cnt < spc.p.size() / 2 ); // cell list is used
+
+  // move without filling in the change, as e.g. cluster moves
+  slump.seed(1234);
+  for (int i=0; i<200; i+=10)
+    spc.geo.randompos(spc.trial[i]);
+  Tspace::Change c;
+  pot.updateChange(c);
+  compare(spc.trial);
+  compare(spc.p);
+  spc.p = spc.trial; // accept
+  pot.update(true);
+  compare(spc.p);
+  compare(spc.trial);
+}
+
+TEST_CASE("Energy cache", "Check that cached energy changes take current pair energies from EnergyMatrix")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 30 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : { "ecA" : { "q" : 1 }, "ecB" : { "q" : -1 }, "ecC" : { "q" : 0.5 } },
+    "moleculelist" : {
+      "ecmA" : { "atoms" : "ecA", "atomic" : true, "Ninit" : 5 },
+      "ecmB" : { "atoms" : "ecB", "atomic" : true, "Ninit" : 5 },
+      "ecmC" : { "atoms" : "ecC", "atomic" : true, "Ninit" : 5 } }
+  })"_json;
+  Tspace spc(j);
+  REQUIRE( spc.groupList().size() == 3 );
+  Energy::Nonbonded<Tspace, Potential::Coulomb> ref(j);
+  Energy::EnergyMatrix<double, Tspace, Energy::Nonbonded<Tspace, CountedCoulomb>> pot(j);
+  ref.setSpace(spc);
+  pot.setSpace(spc);
+  pot.cache.enabled = true;
+  pot.cache.check = 1; // compare with full recalculation every step
+  CHECK( pot.storesPairs() );
+  CHECK( !ref.storesPairs() );
+  Energy::systemEnergy(spc, pot, spc.p); // builds the matrix
+
+  for (int k=0; k<3; k++) {
+    Tspace::Change c;
+    auto &g = *spc.groupList()[k];
+    c.mvGroup[k]; // whole group moved
+    for (auto i : g) {
+      spc.trial[i].translate(spc.geo, Point(1.5, -0.5, 0.2));
+      spc.geo.boundary(spc.trial[i]);
+    }
+    pot.updateChange(c);
+    CountedCoulomb::cnt = 0;
+    double du = Energy::energyChange(spc, pot, c);
+    CHECK( CountedCoulomb::cnt == 5*10 ); // trial rows only
+    CHECK( du == Approx( Energy::systemEnergy(spc, ref, spc.trial) - Energy::systemEnergy(spc, ref, spc.p) ) );
+    for (auto i : g)
+      spc.p[i] = spc.trial[i];
+    pot.update(true);
+    pot.cache.accept(c);
+  }
+  CHECK( pot.numInit() == 1 );
+}
+
+TEST_CASE("Energy matrix", "Check stored group energies after accepted and rejected moves")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 30 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : { "emA" : { "q" : 1 }, "emB" : { "q" : -1 } },
+    "moleculelist" : {
+      "emm1" : { "atoms" : "emA emB", "atomic" : true, "Ninit" : 2 },
+      "emm2" : { "atoms" : "emA", "atomic" : true, "Ninit" : 4 },
+      "emm3" : { "atoms" : "emB", "atomic" : true, "Ninit" : 3 },
+      "emm4" : { "atoms" : "emA emA emB", "atomic" : true, "Ninit" : 1 },
+      "emm5" : { "atoms" : "emB", "atomic" : true, "Ninit" : 5 } }
+  })"_json;
+  slump.seed(1234);
+  Tspace spc(j);
+  auto &g = spc.groupList();
+  REQUIRE( g.size() == 5 );
+  Energy::Nonbonded<Tspace, Potential::Coulomb> ref(j);
+  Energy::EnergyMatrix<double, Tspace, Energy::Nonbonded<Tspace, Potential::Coulomb>> pot(j);
+  ref.setSpace(spc);
+  pot.setSpace(spc);
+  CHECK( pot.systemEnergy(spc.p) == Approx(ref.systemEnergy(spc.p)) ); // builds the matrix
+
+  int naccepted = 0;
+  for (int n=0; n<300; n++) {
+    Tspace::Change c;
+    int kind = n % 4;
+    if (kind == 0)      // one particle of one group
+    {
+      int k = slump.range(0, 4);
+      int i = slump.range(g[k]->front(), g[k]->back());
+      c.mvGroup[k].push_back(i);
+    }
+    else if (kind == 1) // two whole groups
+    {
+      int k = slump.range(0, 4);
+      c.mvGroup[k];
+      c.mvGroup[(k + 2) % 5];
+    }
+    else if (kind == 2) // all groups, as in volume moves
+      for (size_t k=0; k<g.size(); k++)
+        c.mvGroup[k];
+    else                // one whole group
+      c.mvGroup[slump.range(0, 4)];
+
+    IndexSet moved;
+    c.movedIndex(g, moved);
+    for (auto &m : c.mvGroup) { // whole groups are translated rigidly
+      Point d = Point(slump() - 0.5, slump() - 0.5, slump() - 0.5) * 4;
+      for (auto i : m.second.empty() ? vector<int>(g[m.first]->begin(), g[m.first]->end()) : m.second) {
+        spc.trial[i].translate(spc.geo, d);
+        spc.geo.boundary(spc.trial[i]);
+      }
+    }
+    pot.updateChange(c);
+    double du = Energy::energyChange(spc, pot, c);
+    CHECK( du == Approx( ref.systemEnergy(spc.trial) - ref.systemEnergy(spc.p) ) );
+
+    bool accept = slump() < 0.5;
+    for (auto i : moved)
+      if (accept)
+        spc.p[i] = spc.trial[i];
+      else
+        spc.trial[i] = spc.p[i];
+    pot.update(accept);
+    naccepted += accept;
+
+    CHECK( pot.systemEnergy(spc.p) == Approx(ref.systemEnergy(spc.p)) );
+    int errors = 0;
+    for (size_t k=0; k<g.size(); k++)
+      for (size_t l=0; l<k; l++)
+        if ( pot.g2g(spc.p, *g[k], *g[l]) != Approx(ref.g2g(spc.p, *g[k], *g[l])) )
+          errors++;
+    CHECK( errors == 0 );
+  }
+  CHECK( naccepted > 0 );
+  CHECK( naccepted < 300 );
+  CHECK( pot.numInit() == 1 ); // rows updated without rebuilding the matrix
+}
+
+TEST_CASE("Thread safety", "Check thread safety flags of energy terms")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 40 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : { "tsA" : { "q" : 1 }, "tsB" : { "q" : -1 } },
+    "moleculelist" : {
+      "tscat" : { "atoms" : "tsA", "atomic" : true, "Ninit" : 20 },
+      "tsan" : { "atoms" : "tsB", "atomic" : true, "Ninit" : 20 } }
+  })"_json;
+  Tspace spc(j);
+  Energy::Nonbonded<Tspace, Potential::Coulomb> nb(j);
+  Energy::Nonbonded<Tspace, Potential::PotentialTabulate<Potential::Coulomb>> tab(j);
+  CHECK( nb.threadSafe() );
+  CHECK( !tab.threadSafe() ); // tables are built on first use
+  auto pot = nb + tab;
+  CHECK( !pot.threadSafe() );
+
+  // group pairs are summed serially and give the plain sum over particle pairs
+  double u = 0;
+  tab.setSpace(spc);
+  for (size_t i=0; i<spc.p.size(); i++)
+    for (size_t k=0; k<i; k++)
+      u += tab.p2p(spc.p[i], spc.p[k]);
+  CHECK( Energy::systemEnergy(spc, tab, spc.p) == Approx(u) );
+}
+
+TEST_CASE("Pair sweep", "Check that pair histograms include particles outside groups")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 40 } },
+    "atomlist" : { "swA" : { "q" : 0 }, "swB" : { "q" : 0 } },
+    "moleculelist" : { "swmol" : { "atoms" : "swA swB", "atomic" : true, "Ninit" : 5 } }
+  })"_json;
+  Tspace spc(j);
+  auto free = spc.p.front(); // particle not in any group
+  spc.p.push_back(free);
+  spc.trial.push_back(free);
+  REQUIRE( spc.p.size() == 11 );
+
+  Analysis::PairSweep<Tspace> sweep;
+  int aa = sweep.add( atom["swA"].id, atom["swA"].id, 0.5 );
+  int any = sweep.add( -1, -1, 0.5 );
+  sweep.sweep(spc);
+  CHECK( sweep.pairs(aa) == Approx(6*5/2) );
+  CHECK( sweep.pairs(any) == Approx(11*10/2) );
+  unsigned long cnt = 0;
+  sweep.forEach( any, [&](double, double, unsigned long n) { cnt += n; } );
+  CHECK( cnt == 11*10/2 );
+
+  // weighted pairs binned by a signed coordinate other than the distance
+  typedef Tspace::ParticleType T;
+  int dx = sweep.add( -1, -1, 0.7, pc::infty, [](const T &a, const T &b) { return a.y()*b.y(); },
+      [](const T &a, const T &b) { return a.x()-b.x(); }, -40 );
+  sweep.sweep(spc);
+  Table2D<double,double> n(0.7);
+  Table2D<double,Average<double>> w(0.7);
+  for (size_t i=0; i<spc.p.size(); i++)
+    for (size_t k=i+1; k<spc.p.size(); k++) {
+      double x = spc.p[i].x() - spc.p[k].x();
+      n(x) += 1;
+      w(x) += spc.p[i].y() * spc.p[k].y();
+    }
+  int bins = 0;
+  sweep.forEach( dx, [&](double x, double, unsigned long m) { CHECK( n(x) == m ); bins++; } );
+  sweep.forEachAverage( dx, [&](double x, const Average<double> &a) {
+      CHECK( a.cnt == w(x).cnt );
+      CHECK( a.avg() == Approx(w(x).avg()) );
+      CHECK( a.sqsum == Approx(w(x).sqsum) ); } );
+  CHECK( bins == int(n.getMap().size()) );
+
+  // too fine resolution for the box is caught on construction rather than during sampling
+  CHECK( Geometry::maxDistance(spc.geo) == Approx(std::sqrt(3*20*20)) );
+  Tmjson ja = R"({ "nstep" : 1, "pairs" : [ { "name1" : "swA", "name2" : "swB", "dr" : 1e-6, "file" : "swrdf.dat" } ] })"_json;
+  CHECK_THROWS( Analysis::AtomRDF<Tspace>(ja, spc) );
+
+  // only AtomRDF counts the pairs beyond `rmax` needed for normalization
+  Tmjson jr = R"({ "nstep" : 1, "pairs" : [ { "name1" : "swA", "name2" : "swB", "rmax" : 10, "file" : "swrdf.dat" } ] })"_json;
+  CHECK_THROWS( Analysis::ChargeRDF<Tspace>(jr, spc) );
+  CHECK_THROWS( Analysis::MoleculeRDF<Tspace>(jr, spc) );
+}
+
+TEST_CASE("Bonded", "Check bond energies from the bond table against a plain bond list")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 20 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : { "bdA" : { "q" : 1 }, "bdB" : { "q" : -1 } },
+    "moleculelist" : {
+      "bdmA" : { "atoms" : "bdA", "atomic" : true, "Ninit" : 4 },
+      "bdmB" : { "atoms" : "bdB", "atomic" : true, "Ninit" : 4 } }
+  })"_json;
+  Tspace spc(j);
+  REQUIRE( spc.groupList().size() == 2 );
+  auto &g1 = *spc.groupList()[0];
+  auto &g2 = *spc.groupList()[1];
+
+  Energy::Bonded<Tspace> pot;
+  pot.setSpace(spc);
+  pot.CrossGroupBonds = true;
+  CHECK( pot.threadSafe() );
+
+  // reference bond list with one functor per bond
+  std::map<opair<int>, std::function<double(const PointParticle&, const PointParticle&, double)>> ref;
+  Potential::Harmonic h1(1.5, 3), h2(0.5, 4);
+  Potential::FENE fene(2, 40);
+  Potential::Coulomb coulomb(j["energy"]["nonbonded"]);
+  pot.add(0, 1, h1);  ref[opair<int>(0,1)] = h1;
+  pot.add(1, 2, fene); ref[opair<int>(1,2)] = fene;
+  pot.add(2, 3, coulomb); ref[opair<int>(2,3)] = coulomb;
+  pot.add(4, 5, h2);  ref[opair<int>(4,5)] = h2;
+  pot.add(6, 7, fene); ref[opair<int>(6,7)] = fene;
+  pot.add(3, 4, h1);  ref[opair<int>(3,4)] = h1; // bond between groups
+  pot.add(1, 0, h2);  ref[opair<int>(0,1)] = h2; // replaces first bond
+  CHECK( !pot.threadSafe() ); // table is rebuilt on first use
+  pot.prepare(spc.p);
+  CHECK( pot.threadSafe() );
+  CHECK( pot.getBondList().size() == ref.size() );
+
+  auto bond = [&](int i, int k) {
+    auto it = ref.find(opair<int>(i,k));
+    return (it==ref.end()) ? 0 : it->second(spc.p[i], spc.p[k], spc.geo.sqdist(spc.p[i], spc.p[k]));
+  };
+  double utot = 0, u11 = 0, u12 = 0;
+  for (int i=0; i<8; i++) {
+    double uall = 0, ug1 = 0;
+    for (int k=0; k<8; k++)
+      if (k!=i) {
+        CHECK( pot.i2i(spc.p, i, k) == Approx(bond(i,k)) );
+        uall += bond(i,k);
+        if ( g1.find(k) )
+          ug1 += bond(i,k);
+        if ( k>i ) {
+          utot += bond(i,k);
+          if ( g1.find(i) && g1.find(k) )
+            u11 += bond(i,k);
+          if ( g1.find(i) && g2.find(k) )
+            u12 += bond(i,k);
+        }
+      }
+    CHECK( pot.i2all(spc.p, i) == Approx(uall) );
+    CHECK( pot.i2g(spc.p, g1, i) == Approx(ug1) );
+  }
+  CHECK( pot.total(spc.p) == Approx(utot) );
+  CHECK( pot.g_internal(spc.p, g1) == Approx(u11) );
+  CHECK( pot.g2g(spc.p, g1, g2) == Approx(u12) );
+  CHECK( pot.g2g(spc.p, g2, g1) == Approx(u12) );
+}
+
+TEST_CASE("Debye formula", "Check histogram mode against the exact pair sum")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  typedef Scatter::DebyeFormula<Scatter::FormFactorSphere<double>, Geometry::Sphere, double> Tdebye;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 50 } },
+    "atomlist" : { "dfA" : { "q" : 0, "r" : 2 }, "dfB" : { "q" : 0, "r" : 3 } },
+    "moleculelist" : {
+      "dfmA" : { "atoms" : "dfA", "atomic" : true, "Ninit" : 40 },
+      "dfmB" : { "atoms" : "dfB", "atomic" : true, "Ninit" : 20 } },
+    "scatter" : { "qmin" : 0.02, "qmax" : 0.5, "dq" : 0.02, "dr" : 0.005 }
+  })"_json;
+  Tspace spc(j);
+  Tdebye exact(j["scatter"]);
+  j["scatter"]["histogram"] = true;
+  Tdebye hist(j["scatter"]);
+  for (int n=0; n<2; n++) { // second sample reuses the histograms
+    for (auto &a : spc.p)
+      spc.geo.randompos(a);
+    exact.sample(spc.p);
+    hist.sample(spc.p);
+    REQUIRE( hist.I.size() == exact.I.size() );
+    for (auto &i : exact.I)
+      CHECK( hist.I[i.first] == Approx(i.second).epsilon(1e-3) );
+  }
+  j["scatter"]["dr"] = 1e-9; // bins beyond the particle extent are never allocated
+  Tdebye fine(j["scatter"]);
+  CHECK_THROWS( fine.sample(spc.p) );
+}
+
+/* Compare fused energy and force of `pot` with operator() and force() */
+template<class Tpairpot>
+void checkEnergyForce(Tpairpot &pot, const PointParticle &a, const PointParticle &b, const Geometry::Cuboid &geo)
+{
+  Point r = geo.vdist(a,b), f;
+  double r2 = r.squaredNorm();
+  double u = Potential::energyForce(pot, a, b, r2, r, f);
+  Point fref = pot.force(a, b, r2, r);
+  CHECK( u == Approx( pot(a, b, r2) ) );
+  for (int d=0; d<3; d++)
+    CHECK( f[d] == Approx( fref[d] ) );
+}
+
+TEST_CASE("Energy and force", "Check fused pair energy and force against separate evaluation")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 40 } },
+    "energy" : { "nonbonded" : { "epsr" : 80, "debyelength" : 10, "eps" : 0.2, "cutoff_cell" : 10 } },
+    "atomlist" : {
+      "efA" : { "q" : 1, "r" : 1.5, "eps" : 0.2 },
+      "efB" : { "q" : -1, "r" : 2, "eps" : 0.1 } },
+    "moleculelist" : {
+      "efmA" : { "atoms" : "efA efB", "atomic" : true, "Ninit" : 10 },
+      "efmB" : { "atoms" : "efA efB", "atomic" : true, "Ninit" : 10 } }
+  })"_json;
+  Tspace spc(j);
+  auto &js = j["energy"]["nonbonded"];
+  Potential::Coulomb coulomb(js);
+  Potential::DebyeHuckel debyehuckel(js);
+  Potential::LennardJones lj(js);
+  Potential::LennardJonesLB ljmixed(js);
+  for (int i=0; i<10; i++) {
+    auto &a = spc.p[i];
+    auto &b = spc.p[i+10];
+    checkEnergyForce(coulomb, a, b, spc.geo);
+    checkEnergyForce(debyehuckel, a, b, spc.geo);
+    checkEnergyForce(lj, a, b, spc.geo);
+    checkEnergyForce(ljmixed, a, b, spc.geo);
+  }
+
+  // virial from summed pair kernels (cell list) versus a double loop; pairs beyond the cutoff are ignored
+  typedef Potential::CombinedPairPotential<Potential::Coulomb, Potential::LennardJonesLB> Tpairpot;
+  Energy::Nonbonded<Tspace, Tpairpot> pot(j);
+  Tpairpot pairpot(js);
+  pot.setSpace(spc);
+  auto &g1 = *spc.groupList()[0];
+  auto &g2 = *spc.groupList()[1];
+  Eigen::Matrix3d v12, v11;
+  v12.setZero();
+  v11.setZero();
+  Point f12(0,0,0);
+  int outside = 0;
+  for (auto i : g1)
+    for (auto k : g2) {
+      Point r = spc.geo.vdist(spc.p[i], spc.p[k]);
+      Point f = pot.f_p2p(spc.p[i], spc.p[k]);
+      if (r.norm() < 10)
+        CHECK( f.norm() == Approx( pairpot.force(spc.p[i], spc.p[k], r.squaredNorm(), r).norm() ) );
+      else {
+        CHECK( f.norm() == 0 );
+        outside++;
+      }
+      v12 += r * f.transpose();
+      f12 += f;
+    }
+  CHECK( outside > 0 );
+  for (auto i : g1)
+    for (auto k : g1)
+      if (k>i)
+        v11 += spc.geo.vdist(spc.p[i], spc.p[k]) * pot.f_p2p(spc.p[i], spc.p[k]).transpose();
+  pot.prepare(spc.p);
+  auto s12 = pot.f_g2g(spc.p, g1, g2);
+  auto s11 = pot.f_g_internal(spc.p, g1);
+  CHECK( s12.u == Approx(pot.g2g(spc.p, g1, g2)) );
+  CHECK( s11.u == Approx(pot.g_internal(spc.p, g1)) );
+  for (int d=0; d<3; d++) {
+    CHECK( s12.f[d] == Approx(f12[d]) );
+    for (int e=0; e<3; e++) {
+      CHECK( s12.virial(d,e) == Approx(v12(d,e)) );
+      CHECK( s11.virial(d,e) == Approx(v11(d,e)) );
+    }
+  }
+}
+
+/* Potential map with access to the slot table */
+template<class Tmap>
+struct PotentialMapSlots : public Tmap {
+  PotentialMapSlots(Tmjson &j) : Tmap(j) {}
+  int slot(int i, int j) const { return Tmap::find(i,j); }
+};
+
+TEST_CASE("Potential map", "Check pair potential lookup between atom types")
+{
+  using namespace Potential;
+  Tmjson j = R"({
+    "atomlist" : {
+      "pmA" : { "q" : 1, "r" : 1.5 },
+      "pmB" : { "q" : -1, "r" : 2 },
+      "pmC" : { "q" : 0.5, "r" : 1 } },
+    "nonbonded" : { "epsr" : 80, "eps" : 0.3 }
+  })"_json;
+  atom.include(j["atomlist"]);
+  auto &js = j["nonbonded"];
+  int a = atom["pmA"].id, b = atom["pmB"].id, c = atom["pmC"].id;
+  PotentialMapSlots<PotentialMap<Coulomb, PointParticle, double, LennardJones>> pot(js);
+  Coulomb coulomb(js);
+  LennardJones lj(js);
+  Harmonic harmonic(0.1, 5);
+
+  CHECK( pot.slot(a,b) == -1 ); // nothing added
+  CHECK( pot.add(a, b, lj) == 0 );        // stored by value
+  CHECK( pot.add(c, c, harmonic) == 1 );  // via std::function
+  CHECK( pot.add(b, a, lj) == 0 );        // replaces first pair
+  CHECK( pot.slot(a,b) == 0 );
+  CHECK( pot.slot(b,a) == 0 );
+  CHECK( pot.slot(c,c) == 1 );
+  CHECK( pot.slot(a,a) == -1 );
+  CHECK( pot.slot(a,c) == -1 );
+  CHECK( pot.slot(a,int(atom.size())) == -1 ); // unknown id's
+  CHECK( pot.slot(-1,a) == -1 );
+
+  PointParticle pa, pb, pc, px;
+  pa = atom[a];
+  pb = atom[b];
+  pc = atom[c];
+  px = atom[a];
+  px.id = atom.size() + 5; // id not in table
+  Point r(4.5, 0, 0);
+  double r2 = r.squaredNorm();
+  CHECK( pot(pa,pb,r2) == Approx( lj(pa,pb,r2) ) );
+  CHECK( pot(pb,pa,r2) == Approx( lj(pb,pa,r2) ) );
+  CHECK( pot(pc,pc,r2) == Approx( harmonic(pc,pc,r2) ) );
+  CHECK( pot(pa,pc,r2) == Approx( coulomb(pa,pc,r2) ) );
+  CHECK( pot(pa,px,r2) == Approx( coulomb(pa,px,r2) ) );
+  CHECK( pot.force(pa,pb,r2,r).x() == Approx( lj.force(pa,pb,r2,r).x() ) );
+  CHECK( pot.force(pc,pc,r2,r).x() == Approx( harmonic.force(pc,pc,r2,r).x() ) );
+  CHECK( pot.force(pa,pc,r2,r).x() == Approx( coulomb.force(pa,pc,r2,r).x() ) );
+}
+
+TEST_CASE("Tabulated potential map", "Check that tabulation settings are read from the pair potential section")
+{
+  using namespace Potential;
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "atomlist" : { "ptA" : { "q" : 1 }, "ptB" : { "q" : -1 } },
+    "energy" : { "nonbonded" : { "epsr" : 80, "tab_rmin" : 2, "tab_rmax" : 5, "tab_utol" : 0.01 } }
+  })"_json;
+  atom.include(j["atomlist"]);
+  Energy::Nonbonded<Tspace, PotentialMapTabulated<Coulomb>> pot(j);
+  Coulomb coulomb(j["energy"]["nonbonded"]);
+  PointParticle a, b;
+  a = atom["ptA"];
+  b = atom["ptB"];
+  pot.pairpot.add(a.id, b.id, coulomb);
+  double r2 = 3.3 * 3.3;
+  CHECK( pot.pairpot(a,b,r2) != coulomb(a,b,r2) ); // tabulated
+  CHECK( pot.pairpot(a,b,r2) == Approx( coulomb(a,b,r2) ).epsilon(0.01) );
+  r2 = 7.3 * 7.3;
+  CHECK( pot.pairpot(a,b,r2) == coulomb(a,b,r2) );  // beyond `tab_rmax`
+}
+
+/* Excess chemical potential from Widom insertions using `threads` OpenMP threads */
+template<class Tspace, class Tpot>
+double widomMuex(Tmjson &j, Tspace &spc, Tpot &pot, int threads)
+{
+#ifdef _OPENMP
+  int nthreads = omp_get_max_threads();
+  omp_set_num_threads(threads);
+#endif
+  slump.seed(1234);
+  Analysis::Widom<Tspace> widom(j["analysis"]["widom"], pot, spc);
+  for (int n=0; n<3; n++)
+    widom.sample();
+#ifdef _OPENMP
+  omp_set_num_threads(nthreads);
+#endif
+  return widom.muex();
+}
+
+TEST_CASE("Widom threads", "Check that Widom insertions are independent of the number of threads")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 30 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : { "wiA" : { "q" : 1, "r" : 2 }, "wiB" : { "q" : -1, "r" : 2 } },
+    "moleculelist" : { "wisalt" : { "atoms" : "wiA wiB", "atomic" : true, "Ninit" : 20 } },
+    "analysis" : { "widom" : { "nstep" : 1, "ninsert" : 500, "batch" : 64, "particles" : [ "wiA", "wiB" ] } }
+  })"_json;
+  slump.seed(4321); // salt placement independent of other tests
+  Tspace spc(j);
+  Energy::Nonbonded<Tspace, Potential::Coulomb> pot(j);
+  Energy::Nonbonded<Tspace, Potential::PotentialTabulate<Potential::Coulomb>> tab(j);
+  pot.setSpace(spc);
+  tab.setSpace(spc);
+  REQUIRE( !tab.threadSafe() );
+
+  // reference from a plain serial loop drawing the same ghosts
+  slump.seed(1234);
+  Average<double> expsum;
+  for (int n=0; n<3*500; n++) {
+    PointParticle a, b;
+    a = atom["wiA"];
+    b = atom["wiB"];
+    spc.geo.randompos(a);
+    spc.geo.randompos(b);
+    expsum += exp( -pot.all2p(spc.p, a) - pot.all2p(spc.p, b) - pot.p2p(a, b) );
+  }
+  double muex = -log(expsum.avg()) / 2;
+  REQUIRE( std::isfinite(muex) );
+
+  CHECK( widomMuex(j, spc, pot, 1) == Approx(muex) );
+  for (int threads : {2, 4}) {
+    CHECK( widomMuex(j, spc, pot, threads) == widomMuex(j, spc, pot, 1) );
+    CHECK( widomMuex(j, spc, tab, threads) == widomMuex(j, spc, tab, 1) );
+  }
+}
+
+/* Slow analysis recording the x coordinate of the first particle at each sample */
+template<class Tspace>
+class PipelineRecorder : public Analysis::AnalysisBase
+{
+  Tspace &spc;
+  void _sample() override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    x.push_back( spc.p[0].x() );
+    done++;
+  }
+public:
+  std::vector<double> x;
+  std::atomic<int> done;
+  PipelineRecorder( Tmjson &j, Tspace &spc ) : AnalysisBase(j, "recorder"), spc(spc), done(0) {}
+};
+
+/* Read file into string */
+static std::string slurp( const std::string &file )
+{
+  std::ifstream f(file);
+  return std::string( std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() );
+}
+
+TEST_CASE("Analysis pipeline", "Check order, buffering and flushing of asynchronous analyses")
+{
+  typedef Space<Geometry::Cuboid, PointParticle> Tspace;
+  Tmjson j = R"({
+    "system" : { "temperature" : 298, "geometry" : { "length" : 30 } },
+    "energy" : { "nonbonded" : { "epsr" : 80 } },
+    "atomlist" : { "apA" : { "q" : 1, "r" : 2 }, "apB" : { "q" : -1, "r" : 2 } },
+    "moleculelist" : { "apsalt" : { "atoms" : "apA apB", "atomic" : true, "Ninit" : 20 } }
+  })"_json;
+  Tspace spc(j);
+
+  SECTION("order, back-pressure and flush") {
+    const int N = 60, buffer = 3;
+    Tmjson j1 = {{"nstep", 1}}, j3 = {{"nstep", 3}};
+    auto pipe = std::make_shared<Analysis::AnalysisPipeline<Tspace>>(spc, 2, buffer);
+    auto a1 = std::make_shared<PipelineRecorder<Tspace>>(j1, pipe->space());
+    pipe->add(a1);
+    auto a3 = std::make_shared<PipelineRecorder<Tspace>>(j3, pipe->space());
+    pipe->add(a3);
+
+    int maxlag = 0;
+    for (int n=1; n<=N; n++) {
+      spc.p[0].x() = n;
+      pipe->sample();
+      maxlag = std::max(maxlag, n - a1->done);  // snapshots not yet released
+    }
+    CHECK( maxlag <= buffer );
+    pipe->finish();                             // must flush all queued samples
+
+    REQUIRE( a1->x.size() == N );
+    REQUIRE( a3->x.size() == N/3 );
+    for (int n=1; n<=N; n++)
+      CHECK( a1->x[n-1] == n );
+    for (int n=3; n<=N; n+=3)
+      CHECK( a3->x[n/3-1] == n );
+    CHECK( a1->json()["recorder"]["samples"] == N );
+  }
+
+  SECTION("identical to synchronous sampling") {
+    Energy::Nonbonded<Tspace, Potential::Coulomb> pot(j);
+    pot.setSpace(spc);
+
+    // sample and return `json()` without timings as well as the saved g(r)
+    auto run = [&]( bool async ) {
+      Tmjson m = R"({
+        "_jsonfile" : "pipeline.json",
+        "atomrdf" : { "nstep" : 2, "pairs" : [
+          { "name1":"apA", "name2":"apB", "dim":3, "dr":0.5, "file":"pipeline-ab.dat" },
+          { "name1":"apA", "name2":"apA", "dim":3, "dr":0.5, "file":"pipeline-aa.dat" } ] }
+      })"_json;
+      if ( async )
+        m["_async"] = {{"threads", 2}, {"buffer", 2}};
+      Tmjson r;
+      {
+        Tmjson ja = {{"analysis", m}};
+        Analysis::CombinedAnalysis ana(ja, pot, spc);
+        slump.seed(1234);
+        for (int n=0; n<50; n++) {
+          for (auto &a : spc.p)
+            spc.geo.randompos(a);
+          spc.trial = spc.p;
+          ana.sample();
+        }
+        r = ana.json();
+      }
+      for ( auto &i : r )
+        if ( i.is_object()) {
+          i.erase("relative time");
+          i.erase("queue latency (ms)");
+        }
+      for (auto f : {"pipeline-ab.dat", "pipeline-aa.dat"}) {
+        r[f] = slurp(f);
+        std::remove(f);
+        std::remove((std::string(f) + ".avg").c_str());
+      }
+      std::remove("pipeline.json");
+      return r;
+    };
+
+    Tmjson sync = run(false);
+    CHECK( sync["pipeline-ab.dat"].get<std::string>().size() > 0 );
+    CHECK( sync == run(true) );
+  }
+}
+
 TEST_CASE("Random numbers", "Check random number generator")
 {
   int min=10, max=0, N=1e7;
@@ -276,6 +1577,59 @@ TEST_CASE("Random numbers", "Check random number generator")
   CHECK( std::fabs(x/N) == Approx(4.5).epsilon(0.05) );
 }
 
+TEST_CASE("Random streams", "Check per-thread random number streams")
+{
+  RandomTwister<> m1, m2;
+  RandomStreams<> r1(m1, "", 0, 4), r2(m2, "", 0, 4), r3(m1, "", 1, 4);
+  CHECK( r1.size() == 4 );
+  CHECK( &r1[0] == &m1 ); // master thread draws from given generator...
+  CHECK( &r1() == &m1 );  // ...as does code outside parallel regions
+  CHECK( r1[2]() == r2[2]() );
+  CHECK( r1[1]() != r1[2]() );
+  CHECK( r1[1]() != r3[1]() );
+  double x=0;
+  int N=1e6;
+  for (int i=0; i<N; i++)
+    x += r1[3]();
+  CHECK( x/N == Approx(0.5).epsilon(0.01) );
+  CHECK( &slumpStreams()() == &slump );
+
+  // streams follow reseeding of the master
+  m1.seed(11);
+  m2.seed(11);
+  double y = r1[2]();
+  CHECK( y == r2[2]() );
+  m1.seed(11);
+  CHECK( r1[2]() == y );
+  m1.seed(12);
+  CHECK( r1[2]() != y );
+
+  // named streams are saved and restored
+  RandomStreams<> r4(m1, "unittest", 0, 3);
+  r4[1]();
+  auto state = randomStates().get();
+  REQUIRE( state.count("unittest.1") == 1 );
+  CHECK( state.count("unittest.3") == 0 );
+  double z = r4[1]();
+  m1.seed(13); // state restored below wins over reseeding until next use
+  randomStates().set("unittest.1", state["unittest.1"]);
+  CHECK( r4[1]() == z );
+
+  // threads started outside OpenMP draw from streams of their own
+  int id = RandomWorkers::acquire();
+  RandomTwister<> *g = nullptr;
+  bool thrown = false;
+  std::thread t( [&]() {
+      randomWorker() = id;
+      g = &slumpStreams()();
+      try { slump(); } catch ( std::runtime_error & ) { thrown = true; }
+      } );
+  t.join();
+  RandomWorkers::release(id);
+  CHECK( g != &slump );
+  CHECK( thrown );
+}
+
 TEST_CASE("Quaternion", "Check vector rotation")
 {
   Geometry::QuaternionRotate qrot;
@@ -298,6 +1652,64 @@ TEST_CASE("Tables and averages","Check table of averages")
   CHECK( table(2.1).avg() == Approx(2.0) );
 }
 
+TEST_CASE("Flat tables", "Check save, normSave and load of FlatTable2D against Table2D")
+{
+  typedef Table2D<double,double> Ttable;
+  typedef FlatTable2D<double,double> Tflat;
+
+  for (auto type : {Ttable::HISTOGRAM, Ttable::XYDATA}) {
+    Ttable table(0.25, type);
+    Tflat flat(0.25, Tflat::type(type));
+    slump.seed(1234);
+    for (int n=0; n<200; n++) {
+      double x = -7.3 + 13 * slump();  // negative x and unvisited bins
+      double y = slump();
+      table(x) += y;
+      flat(x) += y;
+    }
+    REQUIRE( flat.size() == table.getMap().size() );
+
+    table.save("table2d.dat");
+    flat.save("flattable2d.dat");
+    CHECK( slurp("flattable2d.dat").size() > 0 );
+    CHECK( slurp("flattable2d.dat") == slurp("table2d.dat") );
+
+    table.normSave("table2d-norm.dat");
+    flat.normSave("flattable2d-norm.dat");
+    CHECK( slurp("flattable2d-norm.dat") == slurp("table2d-norm.dat") );
+
+    // loading restores the end bins of histograms
+    Ttable table2(0.25, type);
+    Tflat flat2(0.25, Tflat::type(type));
+    REQUIRE( table2.load("table2d.dat") );
+    REQUIRE( flat2.load("table2d.dat") );
+    REQUIRE( flat2.size() == table2.getMap().size() );
+    auto m = flat2.to_map();
+    size_t i = 0;
+    for (auto &t : table.getMap()) {
+      CHECK( m["x"][i] == t.first );
+      CHECK( m["y"][i] == Approx(t.second).epsilon(1e-9) );
+      CHECK( m["y"][i] == table2.getMap().at(t.first) );
+      i++;
+    }
+    flat2.save("flattable2d.dat");
+    CHECK( slurp("flattable2d.dat") == slurp("table2d.dat") );
+  }
+  for (auto f : {"table2d.dat", "flattable2d.dat", "table2d-norm.dat", "flattable2d-norm.dat"})
+    std::remove(f);
+
+  // all bins between the extremes are allocated, so the range is bounded
+  Tflat flat(1e-3);
+  flat(-1) = 1;
+  CHECK_THROWS_AS( flat(1e6), std::range_error );
+  CHECK_THROWS_AS( flat.setRange(0, 1e5), std::range_error );
+  CHECK_THROWS_AS( flat(1e300), std::range_error );
+  CHECK( flat.size() == 1 );
+  CHECK( flat.find(-1) == 1 );
+  flat(9000) = 2; // within bounds
+  CHECK( flat.size() == 2 );
+}
+
 TEST_CASE("String literals","Check unit conversion")
 {
   using namespace ChemistryUnits;
@@ -144,11 +144,12 @@ namespace Faunus
 
 	void Sphere::randompos( Point &a )
 	{
+	    auto &ran = slumpStreams()();
 	    do
 	    {
-		a.x() = (slump() - 0.5) * diameter;
-		a.y() = (slump() - 0.5) * diameter;
-		a.z() = (slump() - 0.5) * diameter;
+		a.x() = (ran() - 0.5) * diameter;
+		a.y() = (ran() - 0.5) * diameter;
+		a.z() = (ran() - 0.5) * diameter;
 	    }
 	    while ( a.squaredNorm() > r2 );
 	}
@@ -229,10 +230,11 @@ namespace Faunus
 
 
 	void SphereSurface::randompos(Point &a) {
+	    auto &ran = slumpStreams()();
 	    do {
-		a.x() = (slump()-0.5)*diameter;
-		a.y() = (slump()-0.5)*diameter;
-		a.z() = (slump()-0.5)*diameter;
+		a.x() = (ran()-0.5)*diameter;
+		a.y() = (ran()-0.5)*diameter;
+		a.z() = (ran()-0.5)*diameter;
 	    } while ( a.squaredNorm()>r2 );
 	    a = r*a/a.norm();
 	}
@@ -317,9 +319,10 @@ namespace Faunus
 
 	void Cuboid::randompos( Point &m )
 	{
-	    m.x() = slump.half() * len.x();
-	    m.y() = slump.half() * len.y();
-	    m.z() = slump.half() * len.z();
+	    auto &ran = slumpStreams()();
+	    m.x() = ran.half() * len.x();
+	    m.y() = ran.half() * len.y();
+	    m.z() = ran.half() * len.z();
 	}
 
 	void Cuboid::scale( Point &a, Point &s, const double xyz = 1, const double xy = 1 ) const
@@ -437,12 +440,13 @@ namespace Faunus
 
 	void Cylinder::randompos( Point &m )
 	{
+	    auto &ran = slumpStreams()();
 	    double l = r2 + 1;
-	    m.z() = slump.half() * _len;
+	    m.z() = ran.half() * _len;
 	    while ( l > r2 )
 	    {
-		m.x() = slump.half() * diameter;
-		m.y() = slump.half() * diameter;
+		m.x() = ran.half() * diameter;
+		m.y() = ran.half() * diameter;
 		l = m.x() * m.x() + m.y() * m.y();
 	    }
 	}
@@ -581,7 +585,8 @@ namespace Faunus
 
 	// note: Different axis than in geometry setup
 	Point Hexagon::getRandomPointdInTriangle() {
-	    Point vec = len.x()*unitvX*slump()+len.x()*unitvY*slump();
+	    auto &ran = slumpStreams()();
+	    Point vec = len.x()*unitvX*ran()+len.x()*unitvY*ran();
 	    Point meanV = (unitvX + unitvY);
 	    meanV = meanV/meanV.norm();
 	    double r = vec.dot(meanV);
@@ -591,16 +596,17 @@ namespace Faunus
 	}
 
 	void Hexagon::randompos(Point &a)  {
+	    auto &ran = slumpStreams()();
 	    Point vec = Hexagon::getRandomPointdInTriangle();
 	    Point rtp = vec.xyz2rtp();
 	    rtp.y() = rtp.y() + pc::pi/6.0 + 2.0*pc::pi; // Align with current coordinate-system
 	    if(rtp.y() > 2.0*pc::pi)
 	      rtp.y() -= 2.0*pc::pi;
-	    int sector = std::floor(6.0*slump()); // Get random integer between 0-5
+	    int sector = std::floor(6.0*ran()); // Get random integer between 0-5
 	    rtp.y() = rtp.y() + double(sector)*pc::pi/3.0;
 	    a = rtp.rtp2xyz();
 	    if ( scaledir != XY )
-		a.z() = (slump()-0.5)*len.z();
+		a.z() = (ran()-0.5)*len.z();
 	}
 
 	Point Hexagon::randompos()
@@ -723,12 +729,13 @@ namespace Faunus
 
 	// Needs to be fixed
 	void Octahedron::randompos(Point &a)  {
+	    auto &ran = slumpStreams()();
 	    {
 	      do
 	      {
-		  a.x() = (slump() - 0.5);
-		  a.y() = (slump() - 0.5);
-		  a.z() = (slump() - 0.5);
+		  a.x() = (ran() - 0.5);
+		  a.y() = (ran() - 0.5);
+		  a.z() = (ran() - 0.5);
 	      }
 	      while ( a.squaredNorm() > 0.25 );
 	      a = radiusV.x()*a;
@@ -0,0 +1,86 @@
+#include <faunus/faunus.h>
+
+/*
+ * Speed of `Energy::Bonded` for linear chains with harmonic bonds
+ * compared with a bond list held in `pair_list`, i.e. a map of
+ * functors plus a multimap of bond partners as used formerly.
+ */
+
+using namespace Faunus;
+
+typedef Space<Geometry::Cuboid> Tspace;
+typedef std::function<double(const PointParticle&, const PointParticle&, double)> Tfunc;
+
+struct MapBonds : public pair_list<Tfunc> { // former layout
+  template<class Tgeo>
+  double i2all( const Tgeo &geo, const Tspace::ParticleVector &p, int i ) {
+    double u = 0;
+    auto eqr = mlist.equal_range(i);
+    for (auto it = eqr.first; it != eqr.second; ++it)
+      u += list[opair<int>(i, it->second)](p[i], p[it->second], geo.sqdist(p[i], p[it->second]));
+    return u;
+  }
+  template<class Tgeo>
+  double g_internal( const Tgeo &geo, const Tspace::ParticleVector &p, Group &g ) {
+    double u = 0;
+    for (auto &m : list)
+      if (g.find(m.first.first) && g.find(m.first.second))
+        u += m.second(p[m.first.first], p[m.first.second], geo.sqdist(p[m.first.first], p[m.first.second]));
+    return u;
+  }
+};
+
+int main() {
+  const int nchains = 20, nbeads = 200, n = nchains * nbeads, repeat = 200;
+
+  Tmjson j = {
+    {"system", { {"geometry", { {"length", 200.0} } } } },
+    {"atomlist", { {"M", { {"r", 1.0} } } } },
+    {"moleculelist", Tmjson::object() }
+  };
+  Tspace spc(j);
+  Energy::Bonded<Tspace> bonded;
+  bonded.setSpace(spc);
+  MapBonds ref;
+
+  PointParticle a;
+  vector<Group> chains;
+  for (int c=0; c<nchains; c++) {
+    for (int i=0; i<nbeads; i++) {
+      a = Point(100*slump.half(), 100*slump.half(), 100*slump.half());
+      spc.p.push_back(a);
+      spc.trial.push_back(a);
+    }
+    chains.push_back(Group(c*nbeads, (c+1)*nbeads-1));
+    for (int i=c*nbeads; i<(c+1)*nbeads-1; i++) {
+      Potential::Harmonic bond(0.5, 4.0);
+      bonded.add(i, i+1, bond);
+      ref.add(i, i+1, Tfunc(bond));
+    }
+  }
+
+  auto time = [&](const string &name, std::function<double()> f) {
+    double u = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k=0; k<repeat; k++)
+      u += f();
+    double dt = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+    printf("  %-24s %12.2f %16.8g\n", name.c_str(), 1e6*dt/repeat, u/repeat);
+  };
+
+  printf("%d chains of %d beads\n  %-24s %12s %16s\n", nchains, nbeads, "", "us/call", "energy (kT)");
+  time("i2all (all particles)", [&]() {
+      double u=0;
+      for (int i=0; i<n; i++)
+        u += bonded.i2all(spc.p, i);
+      return u; });
+  time("  pair_list", [&]() {
+      double u=0;
+      for (int i=0; i<n; i++)
+        u += ref.i2all(spc.geo, spc.p, i);
+      return u; });
+  time("g_internal (one chain)", [&]() {
+      return bonded.g_internal(spc.p, chains[0]); });
+  time("  pair_list", [&]() {
+      return ref.g_internal(spc.geo, spc.p, chains[0]); });
+}
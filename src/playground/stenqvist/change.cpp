@@ -0,0 +1,173 @@
+#include <faunus/faunus.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Heap allocations and time spent filling and clearing `Space::Change`
+ * compared with the former `std::map` based layout. Each cycle fills
+ * the change as a move would, loops over it and clears it.
+ *
+ * The second part counts heap allocations per call to `Movebase::move()`
+ * for atomic and molecular moves in water with salt, Coulomb and
+ * Lennard-Jones with a cell list.
+ */
+
+using namespace Faunus;
+
+typedef Space<Geometry::Cuboid> Tspace;
+
+static std::atomic<unsigned long int> nalloc(0); // number of calls to operator new
+
+/*
+ * Every replaceable allocation function is replaced so that all
+ * allocations are counted and each one is released by the matching
+ * deallocation function.
+ */
+static void *countedAlloc( std::size_t n ) noexcept
+{
+  ++nalloc;
+  return std::malloc(n ? n : 1);
+}
+
+/* kept out of line so that GCC does not pair an inlined `free` with `new` */
+__attribute__((noinline)) static void release( void *p ) noexcept { std::free(p); }
+
+void *operator new( std::size_t n )
+{
+  if ( void *p = countedAlloc(n) )
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[]( std::size_t n ) { return ::operator new(n); }
+void *operator new( std::size_t n, const std::nothrow_t& ) noexcept { return countedAlloc(n); }
+void *operator new[]( std::size_t n, const std::nothrow_t& ) noexcept { return countedAlloc(n); }
+void operator delete( void *p ) noexcept { release(p); }
+void operator delete[]( void *p ) noexcept { release(p); }
+void operator delete( void *p, const std::nothrow_t& ) noexcept { release(p); }
+void operator delete[]( void *p, const std::nothrow_t& ) noexcept { release(p); }
+
+#ifdef __cpp_sized_deallocation
+void operator delete( void *p, std::size_t ) noexcept { release(p); }
+void operator delete[]( void *p, std::size_t ) noexcept { release(p); }
+#endif
+
+#ifdef __cpp_aligned_new
+static void *countedAlloc( std::size_t n, std::align_val_t a ) noexcept
+{
+  ++nalloc;
+  std::size_t al = std::max( std::size_t(a), sizeof(void*) );
+  void *p = nullptr;
+  return ( posix_memalign(&p, al, n ? n : 1) == 0 ) ? p : nullptr;
+}
+
+void *operator new( std::size_t n, std::align_val_t a )
+{
+  if ( void *p = countedAlloc(n, a) )
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[]( std::size_t n, std::align_val_t a ) { return ::operator new(n, a); }
+void *operator new( std::size_t n, std::align_val_t a, const std::nothrow_t& ) noexcept { return countedAlloc(n, a); }
+void *operator new[]( std::size_t n, std::align_val_t a, const std::nothrow_t& ) noexcept { return countedAlloc(n, a); }
+void operator delete( void *p, std::align_val_t ) noexcept { release(p); }
+void operator delete[]( void *p, std::align_val_t ) noexcept { release(p); }
+void operator delete( void *p, std::size_t, std::align_val_t ) noexcept { release(p); }
+void operator delete[]( void *p, std::size_t, std::align_val_t ) noexcept { release(p); }
+void operator delete( void *p, std::align_val_t, const std::nothrow_t& ) noexcept { release(p); }
+void operator delete[]( void *p, std::align_val_t, const std::nothrow_t& ) noexcept { release(p); }
+#endif
+
+struct MapChange { // old layout of Space::Change
+  std::map<int, vector<int>> mvGroup, rmGroup;
+  void clear() { mvGroup.clear(); rmGroup.clear(); }
+};
+
+static size_t sum = 0;
+
+/* fill, loop over and clear `c` like a move acting on `ngroups` groups */
+template<class Tchange>
+void fill( Tchange &c, int ngroups, int nindex ) {
+  for (int i=0; i<ngroups; i++) {
+    auto &v = c.mvGroup[(7*i) % ngroups];
+    for (int j=0; j<nindex; j++)
+      v.push_back(j);
+  }
+  for (auto &m : c.mvGroup)
+    sum += m.first + m.second.size();
+  c.clear();
+}
+
+template<class Tchange>
+void bench( const string &name, int ngroups, int nindex, int n=200000 ) {
+  Tchange c;
+  fill(c, ngroups, nindex); // warm up
+  unsigned long int a0 = nalloc;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i=0; i<n; i++)
+    fill(c, ngroups, nindex);
+  double dt = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+  printf("  %-12s %10.2f %14.1f\n", name.c_str(), double(nalloc-a0)/n, 1e9*dt/n);
+}
+
+/* allocations and time per `Movebase::move()` after warm up */
+template<class Tmove>
+void benchmove( const string &name, Tmove &mv, int n=2000 ) {
+  mv.move(n/10); // warm up: buffers grow to their final size
+  unsigned long int a0 = nalloc;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i=0; i<n; i++)
+    mv.move();
+  double dt = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+  printf("  %-24s %10.4f %14.1f\n", name.c_str(), double(nalloc-a0)/n, 1e9*dt/n);
+}
+
+void movecycles() {
+  typedef Potential::CombinedPairPotential<Potential::CoulombGalore, Potential::LennardJonesLB> Tpairpot;
+  std::ofstream("change.aam") << "3\n"
+    "OW 1  0.0 0.0 0.0 -0.8476 16 1.58\n"
+    "HW 2  0.8 0.6 0.0  0.4238  1 0.0\n"
+    "HW 3 -0.8 0.6 0.0  0.4238  1 0.0\n";
+  Tmjson j = R"({
+    "system" : { "temperature" : 300, "geometry" : { "length" : 30 } },
+    "energy" : { "nonbonded" : { "coulombtype" : "plain", "epsr" : 1, "cutoff" : 10 } },
+    "atomlist" : {
+      "OW" : { "q" : -0.8476, "sigma" : 3.1655, "eps" : 0.65 },
+      "HW" : { "q" : 0.4238, "sigma" : 0, "eps" : 0 },
+      "Na" : { "q" : 1, "sigma" : 3.3, "eps" : 0.1, "dp" : 1 },
+      "Cl" : { "q" : -1, "sigma" : 4, "eps" : 0.1, "dp" : 1 } },
+    "moleculelist" : {
+      "water" : { "structure" : "change.aam", "Ninit" : 200, "insdir" : "1 1 1" },
+      "salt" : { "atoms" : "Na Cl", "atomic" : true, "Ninit" : 20 } },
+    "moves" : {
+      "atomtranslate" : { "salt" : { "peratom" : false } },
+      "moltransrot" : { "water" : { "dp" : 0.4, "dprot" : 0.4, "permol" : false }, "center_rotation" : true } }
+  })"_json;
+  Tspace spc(j);
+  auto pot = Energy::Nonbonded<Tspace, Tpairpot>(j);
+  pot.setSpace(spc);
+  Move::AtomicTranslation<Tspace> atomic(pot, spc, j["moves"]["atomtranslate"]);
+  Move::TranslateRotate<Tspace> molecular(pot, spc, j["moves"]["moltransrot"]);
+  printf("Movebase::move() (%d particles)\n  %-24s %10s %14s\n",
+      int(spc.p.size()), "move", "allocs/move", "ns/move");
+  benchmove("AtomicTranslation", atomic);
+  benchmove("TranslateRotate", molecular);
+}
+
+int main() {
+  struct { string name; int ngroups, nindex; } moves[] = {
+    {"atomic", 1, 1},       // AtomicTranslation
+    {"molecular", 1, 0},    // TranslateRotate
+    {"cluster", 10, 0},     // cluster moves
+    {"isobaric", 200, 3}    // Isobaric
+  };
+  for (auto &m : moves) {
+    printf("%s (%d groups, %d indices)\n  %-12s %10s %14s\n",
+        m.name.c_str(), m.ngroups, m.nindex, "layout", "allocs/move", "ns/move");
+    bench<MapChange>("std::map", m.ngroups, m.nindex);
+    bench<Tspace::Change>("ChangeMap", m.ngroups, m.nindex);
+  }
+  movecycles();
+}
@@ -0,0 +1,70 @@
+#include <faunus/faunus.h>
+#include <faunus/ewald.h>
+
+/*
+ * Speed and accuracy of the tabulated real space part of Ewald compared
+ * to the analytic form for a range of spline tolerances. Errors are the
+ * largest absolute and relative deviations over all pairs.
+ */
+
+using namespace Faunus;
+
+typedef Potential::EwaldReal<true,true,true> Tpot;
+
+int main() {
+  const int npairs = 200000;
+  const double rc = 12, alpha = 0.3, kappa = 0.05;
+
+  // random pairs within the cut-off
+  vector<DipoleParticle> a(npairs), b(npairs);
+  vector<Point> r(npairs);
+  for (int i=0; i<npairs; i++) {
+    Point v;
+    do {
+      v = rc*Point(slump.half(), slump.half(), slump.half());
+    } while (v.norm() > rc || v.norm() < 1);
+    r[i] = v;
+    a[i].charge = (slump() > 0.5) ? 1 : -1;
+    b[i].charge = (slump() > 0.5) ? 1 : -1;
+    a[i].mu() = Point(slump.half(), slump.half(), slump.half()).normalized();
+    b[i].mu() = Point(slump.half(), slump.half(), slump.half()).normalized();
+    a[i].muscalar() = b[i].muscalar() = 1;
+  }
+
+  PairMatrix<double> QeQe;
+  QeQe.seta(0, 0, 1.0);
+
+  cout << "tab_utol   knots (T0,T1,T2)   tabulated (pairs/s)   analytic (pairs/s)   max|u-v|    max|u-v|/|v|\n";
+  for (double utol : {1e-3, 1e-5, 1e-7, 1e-9, 1e-11}) {
+    Tmjson j = { {"epsr", 1.0}, {"ewald", { {"tab_utol", utol} } } };
+    Tpot pot(j);
+    pot.updateCharges(QeQe);
+    pot.updateKappa(kappa);
+    pot.updateAlpha(alpha);
+    pot.updateRcut(rc);
+
+    vector<double> u(npairs), v(npairs);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i=0; i<npairs; i++)
+      u[i] = pot(a[i], b[i], r[i]);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i=0; i<npairs; i++)
+      v[i] = pot.analytic(a[i], b[i], r[i]);
+    auto t2 = std::chrono::steady_clock::now();
+
+    double abserr = 0, relerr = 0;
+    for (int i=0; i<npairs; i++) {
+      double d = std::fabs(u[i] - v[i]);
+      abserr = std::max(abserr, d);
+      if (v[i] != 0)
+        relerr = std::max(relerr, d / std::fabs(v[i]));
+    }
+
+    double ttab = std::chrono::duration<double>(t1-t0).count();
+    double tana = std::chrono::duration<double>(t2-t1).count();
+    std::ostringstream knots;
+    knots << pot.table_T0.r2.size() << "," << pot.table_T1.r2.size() << "," << pot.table_T2.r2.size();
+    printf("%-10g %-18s %-21.3e %-20.3e %-11.3e %.3e\n", utol, knots.str().c_str(), npairs/ttab, npairs/tana,
+        abserr, relerr);
+  }
+}
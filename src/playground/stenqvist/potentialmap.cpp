@@ -0,0 +1,95 @@
+#include <faunus/faunus.h>
+
+/*
+ * Speed of pair potential maps with custom potentials between some
+ * atom types: a `std::map` lookup per pair (former `PotentialMap`),
+ * the dense id-pair table of `PotentialMap` and tabulated kernels in
+ * `PotentialMapTabulated`.
+ */
+
+using namespace Faunus;
+using namespace Faunus::Potential;
+
+typedef PotentialMap<Coulomb, PointParticle, double, CombinedPairPotential<Coulomb,LennardJones>> Tmap;
+typedef PotentialMapTabulated<Coulomb> Ttab;
+
+int main() {
+  const int natoms = 6, n = 2000, repeat = 50;
+
+  Tmjson atoms; // id 1..natoms
+  for (int i=0; i<natoms; i++)
+    atoms["A"+std::to_string(i)] = { {"q", (i%2) ? 1.0 : -1.0}, {"r", 1.5+0.1*i} };
+  atom.include(atoms);
+
+  Tmjson j = { // section of the pair potentials, i.e. energy/nonbonded
+    {"epsr", 80.0}, {"eps", 0.5},
+    {"tab_rmin", 2.0}, {"tab_rmax", 40.0}, {"tab_utol", 1e-5}
+  };
+
+  Tmap map(j);
+  Ttab tab(j);
+  std::map<opair<int>, std::function<double(const PointParticle&,const PointParticle&,double)>> tree;
+  for (int i=1; i<=natoms; i++)         // custom potential between
+    for (int k=i; k<=natoms; k+=2) {    // every second pair of types
+      CombinedPairPotential<Coulomb,LennardJones> pot(j);
+      map.add(i, k, pot);
+      tab.add(i, k, pot);
+      tree[opair<int>(i,k)] = pot;
+    }
+
+  // random, non-overlapping particles in a box
+  vector<PointParticle> p(n);
+  for (int i=0; i<n; i++) {
+    auto &a = p[i];
+    a = atom[1 + slump.range(0, natoms-1)];
+    bool overlap;
+    do {
+      a.x() = 60*slump.half();
+      a.y() = 60*slump.half();
+      a.z() = 60*slump.half();
+      overlap = false;
+      for (int k=0; k<i; k++)
+        if ((a-p[k]).norm() < a.radius+p[k].radius)
+          overlap = true;
+    } while (overlap);
+  }
+
+  Coulomb fallback(j);
+  auto time = [&](const string &name, std::function<double(int)> f) {
+    double u = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k=0; k<repeat; k++)
+      for (int i=0; i<n; i++)
+        u += f(i);
+    double dt = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+    printf("  %-28s %12.1f %16.8g\n", name.c_str(), 1e-6*repeat*double(n)*n/dt, u/repeat);
+  };
+
+  printf("  %-28s %12s %16s\n", "", "Mpairs/s", "energy (kT)");
+  time("std::map lookup", [&](int i) {
+      double u = 0;
+      for (int k=0; k<n; k++) {
+        double d2 = (p[i]-p[k]).squaredNorm();
+        if (d2 > 0) {
+          auto it = tree.find(opair<int>(p[i].id, p[k].id));
+          u += (it != tree.end()) ? it->second(p[i],p[k],d2) : fallback(p[i],p[k],d2);
+        }
+      }
+      return u; });
+  time("PotentialMap", [&](int i) {
+      double u = 0;
+      for (int k=0; k<n; k++) {
+        double d2 = (p[i]-p[k]).squaredNorm();
+        if (d2 > 0)
+          u += map(p[i],p[k],d2);
+      }
+      return u; });
+  time("PotentialMapTabulated", [&](int i) {
+      double u = 0;
+      for (int k=0; k<n; k++) {
+        double d2 = (p[i]-p[k]).squaredNorm();
+        if (d2 > 0)
+          u += tab(p[i],p[k],d2);
+      }
+      return u; });
+}
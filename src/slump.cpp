@@ -3,5 +3,6 @@
 namespace Faunus
 {
   RandomTwister<> slump;
+  static RandomStreams<> &slumpGuard = slumpStreams(); // restricts `slump` to the master thread
 }//namespace
 